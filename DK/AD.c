@@ -1,7 +1,11 @@
 /**
  * @file     AD.c
  * @brief    STM32F10x ADC驱动程序
- * @details  实现了ADC的初始化和数据读取功能
+ * @details  ADC1由这里统一管理，各传感器只注册通道、读取结果：
+ *          - 规则组连续扫描注册的通道，结果由DMA1_Channel1写入环形缓冲，不占用CPU
+ *          - 注入组在每次DMA中断时以软件触发转换一次，打断规则组后由硬件自动恢复
+ *          - 每个通道按自己的输出周期累加，周期到时输出平均值
+ *          - 读取只是读取一个16位变量，不等待转换、不重新配置通道
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -10,68 +14,333 @@
 #include "stm32f10x.h" // STM32F10x头文件
 #include "dk_C8T6.h"   // 项目主设备头文件
 
+#define AD_CLOCK_MHZ  9    /**< ADCCLK（MHz） */
+#define AD_VREFINT_MV 1200 /**< 内部参考电压典型值（mV） */
+#define AD_TEMP_V25   1430 /**< 25°C时温度传感器电压（mV） */
+
+/**
+ * @brief 各采样时间一次转换所需的ADC时钟数的2倍（采样时间+12.5）
+ * @details 以ADC_SampleTime_x的取值为下标
+ */
+static const uint16_t AD_ConvHalfCycles[8] = {28, 40, 52, 82, 108, 136, 168, 504};
+
+/**
+ * @brief 注入组各位置的数据寄存器
+ */
+static const uint8_t AD_InjectedReg[AD_INJECTED_MAX] = {ADC_InjectedChannel_1, ADC_InjectedChannel_2,
+                                                        ADC_InjectedChannel_3, ADC_InjectedChannel_4};
+
+static AD_Channel_t *AD_Regular[AD_REGULAR_MAX];    /**< 规则组，按扫描顺序 */
+static AD_Channel_t *AD_Injected[AD_INJECTED_MAX];  /**< 注入组，按转换顺序 */
+static uint8_t AD_RegularNum  = 0;                  /**< 规则组通道数 */
+static uint8_t AD_InjectedNum = 0;                  /**< 注入组通道数 */
+static uint16_t AD_HalfScans  = 0;                  /**< 半个缓冲的扫描轮数 */
+static uint8_t AD_Started     = 0;                  /**< 扫描是否已启动 */
+static volatile uint32_t AD_BlockCount = 0;         /**< 已处理的半缓冲数 */
+static volatile uint16_t AD_Buf[AD_BUF_LEN];        /**< DMA环形缓冲 */
+
+static AD_Channel_t AD_Vref; /**< 内部参考电压 */
+static AD_Channel_t AD_Temp; /**< 内部温度传感器 */
+
 /**
  * @brief    AD初始化函数
- * @details  完成ADC1的初始化配置，包括：
- *          1. 配置ADC时钟为72MHz/6=12MHz
- *          2. 配置PA0为模拟输入模式
- *          3. 配置ADC1工作参数
- *          4. 执行ADC校准
+ * @details  完成以下配置：
+ *          1. 配置ADC时钟为72MHz/8=9MHz
+ *          2. 注册内部参考电压和温度传感器（注入组，239.5周期，
+ *             温度传感器要求采样时间不少于17.1us）
+ *          3. 启动ADC校准（不等待完成，校准与后续外设初始化并行进行，
+ *             由AD_Start等待完成后开始扫描）
+ * @note     重复调用时直接返回，ADC只初始化和校准一次
  * @param    无
  * @return   无
  */
 void AD_Init(void)
 {
+    static uint8_t initialized = 0;
+
+    if (initialized) return;
+    initialized = 1;
+
     /*开启时钟*/
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE);  // 开启ADC1的时钟
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE); // 开启GPIOA的时钟
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE); // 开启ADC1的时钟
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);   // 开启DMA1的时钟
 
     /*设置ADC时钟*/
-    RCC_ADCCLKConfig(RCC_PCLK2_Div6); // 选择时钟6分频，ADCCLK = 72MHz / 6 = 12MHz
+    RCC_ADCCLKConfig(RCC_PCLK2_Div8); // 选择时钟8分频，ADCCLK = 72MHz / 8 = 9MHz
 
-    /*GPIO初始化*/
+    AD_Register(&AD_Vref, ADC_Channel_17, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, AD_INTERNAL_PERIOD_MS);
+    AD_Register(&AD_Temp, ADC_Channel_16, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, AD_INTERNAL_PERIOD_MS);
+
+    /*ADC使能*/
+    ADC_Cmd(ADC1, ENABLE); // 使能ADC1，ADC开始运行
+
+    /*ADC校准*/
+    ADC_ResetCalibration(ADC1); // 固定流程，内部有电路会自动执行校准
+    while (ADC_GetResetCalibrationStatus(ADC1) == SET);
+    ADC_StartCalibration(ADC1); // 校准在后台进行，约7us
+}
+
+/**
+ * @brief    注册通道
+ * @param    Channel 通道句柄
+ * @param    ADC_Channel ADC通道号
+ * @param    SampleTime 采样时间
+ * @param    Group 转换组
+ * @param    PeriodMs 输出周期（毫秒）
+ * @return   uint8_t 1-成功；0-失败
+ */
+uint8_t AD_Register(AD_Channel_t *Channel, uint8_t ADC_Channel, uint8_t SampleTime, AD_Group_t Group,
+                    uint16_t PeriodMs)
+{
     GPIO_InitTypeDef GPIO_InitStructure;
+
+    if (AD_Started) return 0;
+    if (Group == AD_GROUP_REGULAR ? AD_RegularNum >= AD_REGULAR_MAX : AD_InjectedNum >= AD_INJECTED_MAX) return 0;
+
     GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_AIN;
-    GPIO_InitStructure.GPIO_Pin   = GPIO_Pin_0;
     GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_Init(GPIOA, &GPIO_InitStructure); // 将PA0引脚初始化为模拟输入
+    if (ADC_Channel <= ADC_Channel_7) {
+        RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE);
+        GPIO_InitStructure.GPIO_Pin = (uint16_t)(1 << ADC_Channel);
+        GPIO_Init(GPIOA, &GPIO_InitStructure); // PA0~PA7
+    } else if (ADC_Channel <= ADC_Channel_9) {
+        RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB, ENABLE);
+        GPIO_InitStructure.GPIO_Pin = (uint16_t)(1 << (ADC_Channel - ADC_Channel_8));
+        GPIO_Init(GPIOB, &GPIO_InitStructure); // PB0~PB1
+    } else if (ADC_Channel == ADC_Channel_16 || ADC_Channel == ADC_Channel_17) {
+        ADC_TempSensorVrefintCmd(ENABLE); // 开启内部参考电压和温度传感器
+    } else {
+        return 0; // 通道10~15在48脚封装上没有引出
+    }
 
-    /*不在此处配置规则组序列，而是在每次AD转换前配置，这样可以灵活更改AD转换的通道*/
+    Channel->Channel    = ADC_Channel;
+    Channel->SampleTime = SampleTime;
+    Channel->Group      = Group;
+    Channel->PeriodMs   = PeriodMs;
+    Channel->Count      = 0;
+    Channel->Acc        = 0;
+    Channel->Value      = 0;
+    Channel->Seq        = 0;
+    if (Group == AD_GROUP_REGULAR) {
+        Channel->Rank              = AD_RegularNum;
+        AD_Regular[AD_RegularNum++] = Channel;
+    } else {
+        Channel->Rank                = AD_InjectedNum;
+        AD_Injected[AD_InjectedNum++] = Channel;
+    }
+    return 1;
+}
+
+/**
+ * @brief    换算通道的平均窗口
+ * @details  输出周期换算为半缓冲数，至少1个；累加值不超过32位
+ * @param    Channel 通道句柄
+ * @param    HalfUs 半个缓冲的时长（us）
+ * @param    PerBlock 每个半缓冲中该通道的采样数
+ * @return   无
+ */
+static void AD_SetWindow(AD_Channel_t *Channel, uint32_t HalfUs, uint32_t PerBlock)
+{
+    uint32_t blocks = (uint32_t)Channel->PeriodMs * 1000 / HalfUs;
+    uint32_t limit  = 0xFFFFFFFFUL / 4095 / PerBlock;
+
+    if (blocks == 0) blocks = 1;
+    if (blocks > limit) blocks = limit;
+    if (blocks > 0xFFFF) blocks = 0xFFFF;
+    Channel->Blocks  = (uint16_t)blocks;
+    Channel->Samples = blocks * PerBlock;
+}
+
+/**
+ * @brief    累加一个半缓冲并在周期到时输出
+ * @param    Channel 通道句柄
+ * @param    Sum 本半缓冲的采样之和
+ * @return   无
+ */
+static void AD_Accumulate(AD_Channel_t *Channel, uint32_t Sum)
+{
+    Channel->Acc += Sum;
+    if (++Channel->Count < Channel->Blocks) return;
+    Channel->Value = (uint16_t)(Channel->Acc / Channel->Samples);
+    Channel->Seq++;
+    Channel->Acc   = 0;
+    Channel->Count = 0;
+}
+
+/**
+ * @brief    启动后台扫描
+ * @details  完成以下配置：
+ *          1. 规则组按注册顺序排列，扫描、连续转换模式
+ *          2. DMA1_Channel1循环模式写入AD_Buf，长度取规则通道数的偶数倍，开启半满和全满中断
+ *          3. 注入组按注册顺序排列，软件触发
+ *          4. 由一轮扫描的时长换算各通道的平均窗口
+ *          5. 等待校准完成后触发第一次转换
+ * @param    无
+ * @return   无
+ */
+void AD_Start(void)
+{
+    uint32_t cycles = 0; // 一轮扫描的ADC时钟数的2倍
+    uint32_t half_us;
+    uint8_t i;
+
+    if (AD_Started || AD_RegularNum == 0) return;
+    AD_Started = 1;
+
+    /*规则组序列，顺序与注册顺序一致*/
+    for (i = 0; i < AD_RegularNum; i++) {
+        ADC_RegularChannelConfig(ADC1, AD_Regular[i]->Channel, i + 1, AD_Regular[i]->SampleTime);
+        cycles += AD_ConvHalfCycles[AD_Regular[i]->SampleTime & 0x07];
+    }
+    AD_HalfScans = AD_BUF_LEN / AD_RegularNum / 2;
+
+    /*注入组序列，须先设置长度*/
+    if (AD_InjectedNum) {
+        ADC_InjectedSequencerLengthConfig(ADC1, AD_InjectedNum);
+        for (i = 0; i < AD_InjectedNum; i++) {
+            ADC_InjectedChannelConfig(ADC1, AD_Injected[i]->Channel, i + 1, AD_Injected[i]->SampleTime);
+        }
+        ADC_ExternalTrigInjectedConvConfig(ADC1, ADC_ExternalTrigInjecConv_None); // 软件触发
+    }
+
+    /*平均窗口*/
+    half_us = cycles * AD_HalfScans / (2 * AD_CLOCK_MHZ);
+    if (half_us == 0) half_us = 1;
+    for (i = 0; i < AD_RegularNum; i++) AD_SetWindow(AD_Regular[i], half_us, AD_HalfScans);
+    for (i = 0; i < AD_InjectedNum; i++) AD_SetWindow(AD_Injected[i], half_us, 1);
 
     /*ADC初始化*/
     ADC_InitTypeDef ADC_InitStructure;                                    // 定义结构体变量
     ADC_InitStructure.ADC_Mode               = ADC_Mode_Independent;      // 模式，选择独立模式，即单独使用ADC1
     ADC_InitStructure.ADC_DataAlign          = ADC_DataAlign_Right;       // 数据对齐，选择右对齐
     ADC_InitStructure.ADC_ExternalTrigConv   = ADC_ExternalTrigConv_None; // 外部触发，使用软件触发，不需要外部触发
-    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;                   // 连续转换，失能，每转换一次规则组序列后停止
-    ADC_InitStructure.ADC_ScanConvMode       = DISABLE;                   // 扫描模式，失能，只转换规则组的序列1这一个位置
-    ADC_InitStructure.ADC_NbrOfChannel       = 1;                         // 通道数，为1，仅在扫描模式下，才需要指定大于1的数，在非扫描模式下，只能是1
+    ADC_InitStructure.ADC_ContinuousConvMode = ENABLE;                    // 连续转换，一轮扫描结束后立即开始下一轮
+    ADC_InitStructure.ADC_ScanConvMode       = ENABLE;                    // 扫描模式，依次转换两个组的全部通道
+    ADC_InitStructure.ADC_NbrOfChannel       = AD_RegularNum;             // 规则组通道数
     ADC_Init(ADC1, &ADC_InitStructure);                                   // 将结构体变量交给ADC_Init，配置ADC1
 
-    /*ADC使能*/
-    ADC_Cmd(ADC1, ENABLE); // 使能ADC1，ADC开始运行
+    /*DMA初始化*/
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&ADC1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t)AD_Buf;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralSRC;
+    DMA_InitStructure.DMA_BufferSize         = AD_HalfScans * 2 * AD_RegularNum;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_HalfWord;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_HalfWord;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Circular;
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_High; // 高于OLED刷新，转换结果不能丢失
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel1, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel1, DMA_IT_HT | DMA_IT_TC, ENABLE);
+    DMA_Cmd(DMA1_Channel1, ENABLE);
 
-    /*ADC校准*/
-    ADC_ResetCalibration(ADC1); // 固定流程，内部有电路会自动执行校准
-    while (ADC_GetResetCalibrationStatus(ADC1) == SET);
-    ADC_StartCalibration(ADC1);
-    while (ADC_GetCalibrationStatus(ADC1) == SET);
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel                   = DMA1_Channel1_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_Init(&NVIC_InitStructure);
+
+    ADC_DMACmd(ADC1, ENABLE);
+
+    while (ADC_GetCalibrationStatus(ADC1) == SET); // 校准完成后只是一次寄存器读取
+    ADC_SoftwareStartConvCmd(ADC1, ENABLE);        // 连续模式下只需触发一次
+    if (AD_InjectedNum) ADC_SoftwareStartInjectedConvCmd(ADC1, ENABLE);
+}
+
+/**
+ * @brief    读取通道的平均值
+ * @param    Channel 通道句柄
+ * @return   uint16_t 转换结果，范围0~4095
+ */
+uint16_t AD_Read(const AD_Channel_t *Channel)
+{
+    return Channel->Value;
+}
+
+/**
+ * @brief    获取供电电压
+ * @param    无
+ * @return   供电电压（mV）
+ */
+uint16_t AD_GetVdd(void)
+{
+    uint16_t vref = AD_Vref.Value;
+
+    if (vref == 0) return 0;
+    return (uint16_t)((uint32_t)AD_VREFINT_MV * 4095 / vref);
+}
+
+/**
+ * @brief    获取芯片温度
+ * @details  温度传感器电压按实测的供电电压换算，不受供电波动影响
+ * @param    无
+ * @return   芯片温度（0.1°C）
+ */
+int16_t AD_GetChipTemp(void)
+{
+    uint16_t vref = AD_Vref.Value;
+    int32_t sense;
+
+    if (vref == 0) return 0;
+    sense = (int32_t)AD_Temp.Value * AD_VREFINT_MV / vref; // mV
+    return (int16_t)((AD_TEMP_V25 - sense) * 100 / 43 + 250);
 }
 
 /**
- * @brief    获取AD转换的值
+ * @brief    获取已处理的半缓冲数
+ * @param    无
+ * @return   半缓冲数
+ */
+uint32_t AD_GetBlocks(void)
+{
+    return AD_BlockCount;
+}
+
+/**
+ * @brief    DMA1通道1（ADC1规则组）中断服务函数
  * @details  完成以下操作：
- *          1. 配置ADC规则组的转换通道和采样时间
- *          2. 触发一次AD转换
- *          3. 等待转换完成
- *          4. 返回转换结果
- * @param    ADC_Channel 指定AD转换的通道，范围：ADC_Channel_x，其中x可以是0/1/2/3
- * @return   AD转换的结果，范围：0~4095
+ *          1. 半满时累加前半个缓冲，全满时累加后半个缓冲，DMA同时写入另一半
+ *          2. 读取上一次注入组转换的结果并累加，再触发下一次注入组转换
+ *          3. 各通道累计到自己的平均窗口后输出平均值
+ * @note     须在DMA写完另一半之前处理完
  */
-uint16_t AD_GetValue(uint8_t ADC_Channel)
+void DMA1_Channel1_IRQHandler(void)
 {
-    ADC_RegularChannelConfig(ADC1, ADC_Channel, 1, ADC_SampleTime_55Cycles5); // 在每次转换前，根据函数形参灵活更改规则组的通道1
-    ADC_SoftwareStartConvCmd(ADC1, ENABLE);                                   // 软件触发AD转换一次
-    while (ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC) == RESET);                   // 等待EOC标志位，即等待AD转换结束
-    return ADC_GetConversionValue(ADC1);                                      // 读数据寄存器，得到AD转换的结果
+    uint32_t sum[AD_REGULAR_MAX] = {0};
+    volatile uint16_t *scan;
+    uint16_t i;
+    uint8_t rank;
+
+    if (DMA_GetITStatus(DMA1_IT_HT1) == SET) {
+        DMA_ClearITPendingBit(DMA1_IT_HT1);
+        scan = &AD_Buf[0];
+    } else if (DMA_GetITStatus(DMA1_IT_TC1) == SET) {
+        DMA_ClearITPendingBit(DMA1_IT_TC1);
+        scan = &AD_Buf[AD_HalfScans * AD_RegularNum];
+    } else {
+        return;
+    }
+
+    for (i = 0; i < AD_HalfScans; i++) {
+        for (rank = 0; rank < AD_RegularNum; rank++) {
+            sum[rank] += *scan++;
+        }
+    }
+    for (rank = 0; rank < AD_RegularNum; rank++) {
+        AD_Accumulate(AD_Regular[rank], sum[rank]);
+    }
+
+    if (AD_InjectedNum && ADC_GetFlagStatus(ADC1, ADC_FLAG_JEOC) == SET) {
+        ADC_ClearFlag(ADC1, ADC_FLAG_JEOC);
+        for (rank = 0; rank < AD_InjectedNum; rank++) {
+            AD_Accumulate(AD_Injected[rank], ADC_GetInjectedConversionValue(ADC1, AD_InjectedReg[rank]));
+        }
+        ADC_SoftwareStartInjectedConvCmd(ADC1, ENABLE);
+    }
+
+    AD_BlockCount++;
 }
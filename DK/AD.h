@@ -1,7 +1,10 @@
 /**
  * @file     AD.h
  * @brief    STM32F10x ADC驱动程序头文件
- * @details  声明了ADC相关的函数接口
+ * @details  定义了ADC服务相关的：
+ *          - 扫描缓冲配置选项
+ *          - 通道描述结构
+ *          - 初始化、注册、启动和读取接口
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -12,20 +15,122 @@
 
 #include "dk_C8T6.h"
 
+/**
+ * @brief DMA环形缓冲长度（半字）
+ * @details 按规则通道数划分为偶数轮扫描，前后两半各产生一次中断；
+ *        只有PA0（239.5周期）时每半个缓冲约2.7ms
+ */
+#ifndef AD_BUF_LEN
+#define AD_BUF_LEN 192
+#endif
+
+/**
+ * @brief 规则组最多通道数
+ */
+#ifndef AD_REGULAR_MAX
+#define AD_REGULAR_MAX 8
+#endif
+
+/**
+ * @brief 注入组最多通道数（硬件限制）
+ */
+#define AD_INJECTED_MAX 4
+
+/**
+ * @brief 内部参考电压和温度传感器的输出周期（毫秒）
+ */
+#ifndef AD_INTERNAL_PERIOD_MS
+#define AD_INTERNAL_PERIOD_MS 1000
+#endif
+
+/**
+ * @brief 转换组
+ */
+typedef enum {
+    AD_GROUP_REGULAR = 0, /**< 规则组：连续扫描，DMA写入环形缓冲，适合需要大量采样平均的通道 */
+    AD_GROUP_INJECTED     /**< 注入组：每半个缓冲插入转换一次，适合变化缓慢的通道 */
+} AD_Group_t;
+
+/**
+ * @brief ADC通道
+ * @details 由使用者静态分配，指针即为句柄；注册后成员由ADC服务维护，使用者不应直接修改
+ */
+typedef struct {
+    uint8_t Channel;         /**< ADC_Channel_x */
+    uint8_t SampleTime;      /**< ADC_SampleTime_x */
+    uint8_t Group;           /**< 转换组，AD_Group_t */
+    uint8_t Rank;            /**< 在所属转换组中的位置 */
+    uint16_t PeriodMs;       /**< 输出周期（毫秒），即平均窗口 */
+    uint16_t Blocks;         /**< 每个输出包含的半缓冲数 */
+    uint16_t Count;          /**< 本次输出已累加的半缓冲数 */
+    uint32_t Samples;        /**< 每个输出包含的采样数 */
+    uint32_t Acc;            /**< 本次输出的累加值 */
+    volatile uint16_t Value; /**< 最近一次的平均值 */
+    volatile uint32_t Seq;   /**< 输出次数 */
+} AD_Channel_t;
+
 /**
  * @brief    初始化ADC
- * @details  配置ADC的时钟、GPIO、工作模式等参数，并完成校准
+ * @details  配置ADC的时钟并启动校准，注册内部参考电压和温度传感器；
+ *           重复调用时直接返回，ADC只校准一次
  * @param    无
  * @return   无
  */
 void AD_Init(void);
 
 /**
- * @brief    获取AD转换值
- * @details  对指定通道进行一次AD转换并返回结果
- * @param    ADC_Channel ADC通道号，可选值为ADC_Channel_x (x=0,1,2,3)
- * @return   AD转换结果，范围0~4095
+ * @brief    注册通道
+ * @details  PA0~PA7、PB0~PB1配置为模拟输入，通道16、17开启内部参考电压和温度传感器；
+ *           须在AD_Start之前调用，同一通道可以注册多次（例如不同的平均窗口）
+ * @param    Channel 通道句柄
+ * @param    ADC_Channel ADC_Channel_0~9、ADC_Channel_16、ADC_Channel_17
+ * @param    SampleTime ADC_SampleTime_x
+ * @param    Group 转换组
+ * @param    PeriodMs 输出周期（毫秒），0表示每半个缓冲输出一次
+ * @return   uint8_t 1-成功；0-通道不可用、转换组已满或扫描已启动
+ */
+uint8_t AD_Register(AD_Channel_t *Channel, uint8_t ADC_Channel, uint8_t SampleTime, AD_Group_t Group,
+                    uint16_t PeriodMs);
+
+/**
+ * @brief    启动后台扫描
+ * @details  按注册顺序配置规则组和注入组，换算各通道的平均窗口，
+ *           等待校准完成后开始连续扫描；注入组由规则组的DMA中断触发，至少需要一个规则通道
+ * @param    无
+ * @return   无
+ */
+void AD_Start(void);
+
+/**
+ * @brief    读取通道的平均值
+ * @details  只读取变量，不启动转换
+ * @param    Channel 通道句柄
+ * @return   uint16_t 转换结果，范围0~4095；尚无结果时为0
+ */
+uint16_t AD_Read(const AD_Channel_t *Channel);
+
+/**
+ * @brief    获取供电电压
+ * @details  由内部参考电压（典型值1.20V）的转换结果换算
+ * @param    无
+ * @return   供电电压（mV），尚无结果时为0
+ */
+uint16_t AD_GetVdd(void);
+
+/**
+ * @brief    获取芯片温度
+ * @details  按数据手册的典型值换算（25°C时1.43V，斜率4.3mV/°C），
+ *           个体偏差可达数摄氏度，只适合观察变化趋势
+ * @param    无
+ * @return   芯片温度（0.1°C），尚无结果时为0
+ */
+int16_t AD_GetChipTemp(void);
+
+/**
+ * @brief    获取已处理的半缓冲数
+ * @param    无
+ * @return   自启动以来的DMA中断次数
  */
-uint16_t AD_GetValue(uint8_t ADC_Channel);
+uint32_t AD_GetBlocks(void);
 
 #endif
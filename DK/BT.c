@@ -13,10 +13,6 @@
 
 #include "BT.h"
 
-/** @brief 蓝牙接收缓冲区大小为4字节 */
-uint8_t BT_RxBuffer[4];
-/** @brief 蓝牙接收完成标志，1表示接收到完整数据包 */
-uint8_t BT_RxFlag = 0;
 /** @brief 解析后的数据包结构体 */
 BT_Packet_t BT_Packet;
 
@@ -146,10 +142,9 @@ void BT_SendDataPacket(uint8_t count, uint8_t uvLevel, float humi, float temp)
  * @details 实现以下功能：
  *         1. 接收数据状态机:
  *            - 状态0：等待帧头(0xA5)
- *            - 状态1：接收数据内容
- *            - 状态2：接收包尾
- *         2. 数据包组装和存储
- *         3. 接收完成标志设置
+ *            - 状态1：接收其余BT_FRAME_LEN-1个字节
+ *         2. 收满一帧后投递EVENT_BT_FRAME事件，帧内容随事件传递，
+ *            控制线程来不及处理时后续帧在队列中排队，不会覆盖
  * @note   本函数为中断服务函数，由硬件自动调用
  * @param  无
  * @return 无
@@ -159,7 +154,7 @@ void USART2_IRQHandler(void)
     // 静态变量，用于记录接收状态
     static uint8_t RxState = 0;
     // 静态变量，用于存储接收到的数据包
-    static uint8_t RxPacket[8];
+    static uint8_t RxPacket[BT_FRAME_LEN];
     // 静态变量，用于记录接收位置
     static uint8_t RxPos = 0;
 
@@ -171,7 +166,7 @@ void USART2_IRQHandler(void)
         // 根据接收状态机处理数据
         if (RxState == 0) {
             // 状态0：等待帧头0xA5
-            if (RxData == 0xA5 && BT_RxFlag == 0) {
+            if (RxData == 0xA5) {
                 RxState = 1;
                 RxPos = 0;
                 RxPacket[RxPos++] = RxData; // 存储帧头
@@ -179,11 +174,8 @@ void USART2_IRQHandler(void)
         } else if (RxState == 1) {
             // 状态1：接收数据包内容
             RxPacket[RxPos++] = RxData;
-            if (RxPos >= 8) { // 已接收完整数据包
-                // 将数据包复制到接收缓冲区
-                memcpy(BT_RxBuffer, RxPacket, 8);
-                // 设置接收标志
-                BT_RxFlag = 1;
+            if (RxPos >= BT_FRAME_LEN) { // 已接收完整数据包
+                Event_PostFromISR(EVENT_BT_FRAME, RxPacket, BT_FRAME_LEN);
                 RxState = 0; // 重置状态机
             }
         }
@@ -199,33 +191,34 @@ void USART2_IRQHandler(void)
  *         1. 校验数据包格式（帧头0xA5，帧尾0x5A）
  *         2. 计算并验证校验和
  *         3. 解析各个标志位到结构体中
+ * @param  Frame 接收到的一帧（BT_FRAME_LEN字节）
  * @return 解析结果：
  *         - 0  : 解析成功
  *         - -1 : 校验和错误
  *         - -2 : 帧头帧尾错误
  */
-int8_t BT_ParsePacket(void)
+int8_t BT_ParsePacket(const uint8_t *Frame)
 {
     uint8_t checksum = 0;
 
     // 检查帧头和帧尾
-    if (BT_RxBuffer[0] != 0xA5 || BT_RxBuffer[3] != 0x5A) {
+    if (Frame[0] != 0xA5 || Frame[3] != 0x5A) {
         return -2;
     }
 
     // 计算校验和(5个标志位之和)
-    checksum = BT_RxBuffer[1];
+    checksum = Frame[1];
 
     // 验证校验和
-    if (BT_RxBuffer[2] != checksum) {
+    if (Frame[2] != checksum) {
         return -1;
     }
 
     // 解析数据到结构体
-    BT_Packet.header = BT_RxBuffer[0];
-    BT_Packet.flags = BT_RxBuffer[1];
-    BT_Packet.checksum = BT_RxBuffer[2];
-    BT_Packet.footer = BT_RxBuffer[3];
+    BT_Packet.header = Frame[0];
+    BT_Packet.flags = Frame[1];
+    BT_Packet.checksum = Frame[2];
+    BT_Packet.footer = Frame[3];
 
     return 0;
 }
@@ -29,12 +29,11 @@ typedef struct {
     uint8_t footer;   /**< 帧尾，固定为0x5A */
 } BT_Packet_t;
 
-/** @brief 接收缓冲区，用于存储接收到的数据 */
-extern uint8_t BT_RxBuffer[4];
+/** @brief 接收帧长度：帧头、标志位、校验和、帧尾 */
+#define BT_FRAME_LEN 4
+
 /** @brief 解析后的数据包结构体 */
 extern BT_Packet_t BT_Packet;
-/** @brief 接收完成标志，1表示接收到完整数据包 */
-extern uint8_t BT_RxFlag;
 
 /**
  * @brief  初始化蓝牙模块
@@ -61,11 +60,12 @@ void BT_SendDataPacket(uint8_t count, uint8_t uvLevel, float humi, float temp);
 
 /**
  * @brief  解析接收到的蓝牙数据包
+ * @param  Frame 接收到的一帧（BT_FRAME_LEN字节）
  * @return 解析结果：
  *         - 0  : 解析成功
  *         - -1 : 校验和错误
  *         - -2 : 帧头帧尾错误
  */
-int8_t BT_ParsePacket(void);
+int8_t BT_ParsePacket(const uint8_t *Frame);
 
 #endif // __BT_H
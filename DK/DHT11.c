@@ -2,11 +2,15 @@
  * @file     DHT11.c
  * @brief    DHT11温湿度传感器驱动程序
  * @details  实现DHT11的通信协议和数据读取功能。DHT11使用单总线通信，
- *          需要严格的时序控制。完整的通信过程包括：
- *          1. 主机发送起始信号
- *          2. DHT11响应
- *          3. DHT11连续发送40位数据
- *          4. 数据校验
+ *          读取过程全部由中断推进，不占用CPU等待：
+ *          1. 主机拉低数据线，由TIM4单次定时在DHT11_START_US后释放
+ *          2. 释放后开启外部中断，每个下降沿读取TIM4计数作为时刻
+ *          3. 第一个下降沿须在DHT11_RESPONSE_US内到来，之后每个下降沿须在上一个之后
+ *             DHT11_EDGE_TIMEOUT_US内到来，每一步重新设定单次定时，到期即结束读取
+ *          4. 收齐DHT11_EDGE_NUM个下降沿或超时后按相邻下降沿的间隔解码40位数据
+ *          5. 数据校验，调用完成回调
+ *          读取期间禁止进入停止模式，保证TIM4持续计数；传感器损坏或数据线异常时
+ *          读取也在DHT11_READ_MAX_US内结束，不会卡住任何线程
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -14,16 +18,25 @@
 
 #include "dht11.h"
 
-/* 延时函数配置，可根据需要切换不同的延时实现方式 */
+static volatile uint8_t DHT11_State     = DHT11_STATE_IDLE; /**< 读取状态（DHT11_State_t） */
+static volatile uint8_t DHT11_EdgeCount = 0;  /**< 已记录的下降沿数 */
+static uint16_t DHT11_Edges[DHT11_EDGE_NUM];  /**< 下降沿时刻（TIM4计数） */
+static DHT11_Callback_t DHT11_Done      = 0;  /**< 完成回调 */
 
-#define DHT11_DELAY_US(us) Delay_us(us)
-#define DHT11_DELAY_MS(ms) Delay_ms(ms)
+static OsSem_t DHT11_DoneSem;                 /**< 阻塞读取的完成信号 */
+static DHT11_Status_t DHT11_Result;           /**< 阻塞读取的结果 */
+static DHT11_Data_TypeDef DHT11_ResultData;   /**< 阻塞读取的数据 */
 
 /**
  * @brief  DHT11引脚配置函数（内部使用）
  */
 static void DHT11_GPIO_Config(void);
 
+/**
+ * @brief  DHT11外部中断配置函数（内部使用）
+ */
+static void DHT11_EXTI_Config(void);
+
 /**
  * @brief  将DHT11数据引脚配置为上拉输入模式（内部使用）
  */
@@ -34,21 +47,13 @@ static void DHT11_Mode_IPU(void);
  */
 static void DHT11_Mode_Out_PP(void);
 
-/**
- * @brief  从DHT11读取一个字节（内部使用）
- * @return 读取到的字节数据
- * @note   按照DHT11的通信协议，每bit数据的时间编码：
- *         - 26-28us的高电平表示数据'0'
- *         - 70us的高电平表示数据'1'
- */
-static uint8_t DHT11_ReadByte(void);
-
 /**
  * @brief  DHT11初始化
  * @details 完成以下配置：
  *         1. 配置DHT11的数据引脚
  *         2. 设置引脚为推挽输出模式
  *         3. 发送初始电平
+ *         4. 配置下降沿外部中断（读取时才开启）
  * @param  无
  * @return 无
  */
@@ -56,7 +61,10 @@ void DHT11_Init(void)
 {
     DHT11_GPIO_Config();
 
-    DHT11_H; // 拉高GPIOB10
+    DHT11_H; // 拉高GPIOB0
+
+    DHT11_EXTI_Config();
+    Os_SemInit(&DHT11_DoneSem, 0, 1);
 }
 
 /**
@@ -135,105 +143,285 @@ static void DHT11_Mode_Out_PP(void)
 }
 
 /**
- * @brief  从DHT11读取一个字节
- * @details 按照DHT11的通信协议读取8位数据：
- *         1. 每位数据以50us低电平开始
- *         2. 接着是26-28us或70us的高电平，表示0或1
- *         3. 按照MSB（最高位）先行的顺序接收
- * @return 读取到的字节数据
+ * @brief  配置DHT11数据引脚的外部中断
+ * @details 下降沿触发，初始化时关闭，只在接收期间开启。
+ *         优先级高于TIM4，使下降沿时刻不受其他中断推迟
+ * @param  无
+ * @return 无
  */
-static uint8_t DHT11_ReadByte(void)
+static void DHT11_EXTI_Config(void)
 {
-    uint8_t i, temp = 0;
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_AFIO, ENABLE); // AFIO时钟
+
+    GPIO_EXTILineConfig(DHT11_EXTI_PORT_SOURCE, DHT11_EXTI_PIN_SOURCE); // PB0映射到EXTI0
+
+    /*EXTI配置*/
+    EXTI_InitTypeDef EXTI_InitStructure;
+    EXTI_InitStructure.EXTI_Line    = DHT11_EXTI_LINE;
+    EXTI_InitStructure.EXTI_LineCmd = DISABLE;              // 读取时才开启
+    EXTI_InitStructure.EXTI_Mode    = EXTI_Mode_Interrupt;  // 中断模式
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling; // 下降沿触发
+    EXTI_Init(&EXTI_InitStructure);
+
+    /*NVIC配置*/
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel                   = DHT11_EXTI_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 1;
+    NVIC_Init(&NVIC_InitStructure);
+}
 
-    for (i = 0; i < 8; i++) {
-        /*每bit以50us低电平标置开始，轮询直到从机发出 的50us 低电平 结束*/
-        while (DHT11_IN() == Bit_RESET);
+/**
+ * @brief  开启或关闭下降沿外部中断
+ * @param  NewState ENABLE或DISABLE
+ * @return 无
+ */
+static void DHT11_EXTI_Cmd(FunctionalState NewState)
+{
+    EXTI_InitTypeDef EXTI_InitStructure;
 
-        /*DHT11 以26~28us的高电平表示“0”，以70us高电平表示“1”，
-         *通过检测 x us后的电平即可区别这两个状 ，x 即下面的延时
-         */
-        DHT11_DELAY_US(40); // 延时x us 这个延时需要大于数据0持续的时间即可
+    EXTI_InitStructure.EXTI_Line    = DHT11_EXTI_LINE;
+    EXTI_InitStructure.EXTI_LineCmd = NewState;
+    EXTI_InitStructure.EXTI_Mode    = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Falling;
+    EXTI_Init(&EXTI_InitStructure);
+}
 
-        if (DHT11_IN() == Bit_SET) /* x us后仍为高电平表示数据“1” */
-        {
-            /* 等待数据1的高电平结束 */
-            while (DHT11_IN() == Bit_SET);
+/**
+ * @brief  解码一次读取的下降沿时刻
+ * @details 相邻下降沿的间隔：
+ *         - Edges[1]-Edges[0]为响应（低80us+高80us）
+ *         - Edges[i+2]-Edges[i+1]为第i位（低50us+高26~28us或70us），MSB先行
+ *         先检查已收到的间隔，再检查数量，线路干扰和接收不完整可以区分
+ * @param  Edges 各下降沿的时刻（微秒）
+ * @param  Count 下降沿数量
+ * @param  Data 解码得到的数据
+ * @return DHT11_Status_t 读取结果
+ */
+DHT11_Status_t DHT11_Decode(const uint16_t *Edges, uint8_t Count, DHT11_Data_TypeDef *Data)
+{
+    uint8_t buf[5] = {0};
+    uint16_t width;
+    uint8_t i;
 
-            temp |= (uint8_t)(0x01 << (7 - i)); // 把第7-i位置1，MSB先行
-        } else                                  // x us后为低电平表示数据“0”
-        {
-            temp &= (uint8_t)~(0x01 << (7 - i)); // 把第7-i位置0，MSB先行
-        }
+    if (Count == 0) return DHT11_ERR_NO_RESPONSE;
+    if (Count < 2) return DHT11_ERR_TIMEOUT;
+
+    width = (uint16_t)(Edges[1] - Edges[0]);
+    if (width < DHT11_RESP_MIN_US || width > DHT11_RESP_MAX_US) return DHT11_ERR_BIT;
+
+    for (i = 0; i < 40 && i + 2 < Count; i++) {
+        width = (uint16_t)(Edges[i + 2] - Edges[i + 1]);
+        if (width < DHT11_BIT_MIN_US || width > DHT11_BIT_MAX_US) return DHT11_ERR_BIT;
+        if (width > DHT11_BIT_ONE_US) buf[i / 8] |= (uint8_t)(0x80 >> (i % 8));
     }
+    if (Count < DHT11_EDGE_NUM) return DHT11_ERR_TIMEOUT;
 
-    return temp;
+    Data->humi_int  = buf[0];
+    Data->humi_deci = buf[1];
+    Data->temp_int  = buf[2];
+    Data->temp_deci = buf[3];
+    Data->check_sum = buf[4];
+
+    if (buf[4] != (uint8_t)(buf[0] + buf[1] + buf[2] + buf[3])) return DHT11_ERR_CHECKSUM;
+    return DHT11_OK;
 }
 
 /**
- * @brief  从DHT11读取温湿度数据
- * @details 完整的数据传输过程：
- *         1. 主机发送起始信号（拉低18ms，再拉高30us）
- *         2. 等待DHT11响应（低80us，高80us）
- *         3. 接收40位数据：
- *            - 8位湿度整数
- *            - 8位湿度小数
- *            - 8位温度整数
- *            - 8位温度小数
- *            - 8位校验和
- * @param  DHT11_Data 存储读取到的温湿度数据
- * @return 操作结果：
- *         - SUCCESS: 读取成功
- *         - ERROR: 读取失败
+ * @brief  结束接收，解码并调用完成回调
+ * @details 收齐下降沿和阶段超时都会调用，可能相互抢占，只有先进入的一方执行
+ * @param  无
+ * @return 无
  */
-uint8_t DHT11_Read_TempAndHumidity(DHT11_Data_TypeDef *DHT11_Data)
+static void DHT11_Finish(void)
 {
-    /*输出模式*/
-    DHT11_Mode_Out_PP();
-    /*主机拉低*/
-    DHT11_L;
-    /*延时18ms*/
-    DHT11_DELAY_MS(18);
+    uint32_t state = Os_EnterCritical();
+    DHT11_Callback_t callback;
+    DHT11_Data_TypeDef data;
+    DHT11_Status_t status;
+
+    if (DHT11_State != DHT11_STATE_RESPONSE && DHT11_State != DHT11_STATE_DATA) {
+        Os_ExitCritical(state);
+        return;
+    }
+    DHT11_State = DHT11_STATE_DONE;
+    DHT11_EXTI_Cmd(DISABLE);
+    Timer_StopOneShot();
+    Os_ExitCritical(state);
+
+    // 响应阶段超时时没有下降沿，解码为无响应；数据阶段超时时下降沿不足，解码为位超时
+    status = DHT11_Decode(DHT11_Edges, DHT11_EdgeCount, &data);
 
-    /*总线拉高 主机延时30us*/
+    /*读取结束，引脚改为输出模式，主机拉高*/
+    DHT11_Mode_Out_PP();
     DHT11_H;
+    Idle_StopUnlock();
 
-    DHT11_DELAY_US(30); // 延时30us
+    callback    = DHT11_Done;
+    DHT11_State = DHT11_STATE_IDLE; // 回调中可以启动下一次读取
+    if (callback) callback(status, &data);
+}
 
-    /*主机设为输入 判断从机响应信号*/
+/**
+ * @brief  阶段超时（TIM4中断中执行）
+ * @param  无
+ * @return 无
+ */
+static void DHT11_OnTimeout(void)
+{
+    DHT11_Finish();
+}
+
+/**
+ * @brief  起始信号结束（TIM4中断中执行）
+ * @details 释放总线由上拉电阻拉高，开启下降沿中断，进入响应阶段
+ * @param  无
+ * @return 无
+ */
+static void DHT11_OnStartEnd(void)
+{
+    DHT11_EdgeCount = 0;
+    DHT11_State     = DHT11_STATE_RESPONSE;
     DHT11_Mode_IPU();
 
-    /*判断从机是否有低电平响应信号 如不响应则跳出，响应则向下运行*/
-    if (DHT11_IN() == Bit_RESET) {
-        /*轮询直到从机发出 的80us 低电平 响应信号结束*/
-        while (DHT11_IN() == Bit_RESET);
+    EXTI_ClearITPendingBit(DHT11_EXTI_LINE);
+    DHT11_EXTI_Cmd(ENABLE);
+    Timer_StartOneShot(DHT11_RESPONSE_US, DHT11_OnTimeout);
+}
 
-        /*轮询直到从机发出的 80us 高电平 标置信号结束*/
-        while (DHT11_IN() == Bit_SET);
+/**
+ * @brief  启动一次异步读取
+ * @param  Callback 完成回调，在中断中执行
+ * @return uint8_t 1-已启动，0-上一次读取尚未结束
+ */
+uint8_t DHT11_StartRead(DHT11_Callback_t Callback)
+{
+    uint32_t state = Os_EnterCritical();
 
-        /*开始接收数据*/
-        DHT11_Data->humi_int = DHT11_ReadByte();
+    if (DHT11_State != DHT11_STATE_IDLE) {
+        Os_ExitCritical(state);
+        return 0;
+    }
+    DHT11_State = DHT11_STATE_START;
+    Os_ExitCritical(state);
 
-        DHT11_Data->humi_deci = DHT11_ReadByte();
+    DHT11_Done = Callback;
+    Idle_StopLock(); // 停止模式下TIM4暂停，读取期间只允许睡眠
 
-        DHT11_Data->temp_int = DHT11_ReadByte();
+    /*主机拉低，单次定时到期后释放*/
+    DHT11_Mode_Out_PP();
+    DHT11_L;
+    Timer_StartOneShot(DHT11_START_US, DHT11_OnStartEnd);
+    return 1;
+}
 
-        DHT11_Data->temp_deci = DHT11_ReadByte();
+/**
+ * @brief  获取读取状态
+ * @param  无
+ * @return DHT11_State_t 当前所处的阶段
+ */
+DHT11_State_t DHT11_GetState(void)
+{
+    return (DHT11_State_t)DHT11_State;
+}
 
-        DHT11_Data->check_sum = DHT11_ReadByte();
+/**
+ * @brief  中止进行中的读取，不调用完成回调
+ * @details 只在阻塞读取等待超时时使用（TIM4未运行等异常情况）
+ * @param  无
+ * @return 无
+ */
+static void DHT11_Abort(void)
+{
+    uint32_t state = Os_EnterCritical();
 
-        /*读取结束，引脚改为输出模式*/
+    Timer_StopOneShot();
+    DHT11_EXTI_Cmd(DISABLE);
+    if (DHT11_State != DHT11_STATE_IDLE) {
         DHT11_Mode_Out_PP();
-        /*主机拉高*/
         DHT11_H;
+        Idle_StopUnlock();
+        DHT11_State = DHT11_STATE_IDLE;
+    }
+    Os_ExitCritical(state);
+}
 
-        /*检查读取的数据是否正确*/
-        if (DHT11_Data->check_sum == DHT11_Data->humi_int + DHT11_Data->humi_deci + DHT11_Data->temp_int + DHT11_Data->temp_deci)
-            return SUCCESS;
-        else
-            return ERROR;
+/**
+ * @brief  外部中断服务函数
+ * @details 先读取TIM4计数再处理标志，中断响应延迟对每个下降沿基本相同，不影响间隔；
+ *         记录下降沿后重新设定到下一个下降沿的时限
+ * @note   此函数会被硬件自动调用
+ */
+void DHT11_EXTI_IRQHandler(void)
+{
+    uint16_t now = (uint16_t)TIM_GetCounter(TIM4);
+
+    if (EXTI_GetITStatus(DHT11_EXTI_LINE) == SET) {
+        EXTI_ClearITPendingBit(DHT11_EXTI_LINE);
+
+        if ((DHT11_State == DHT11_STATE_RESPONSE || DHT11_State == DHT11_STATE_DATA) &&
+            DHT11_EdgeCount < DHT11_EDGE_NUM) {
+            DHT11_Edges[DHT11_EdgeCount++] = now;
+            DHT11_State                    = DHT11_STATE_DATA;
+            if (DHT11_EdgeCount == DHT11_EDGE_NUM) {
+                DHT11_Finish();
+            } else {
+                Timer_StartOneShot(DHT11_EDGE_TIMEOUT_US, DHT11_OnTimeout);
+            }
+        }
     }
+}
 
-    else
-        return ERROR;
+/**
+ * @brief  阻塞读取的完成回调（中断中执行）
+ * @param  Status 读取结果
+ * @param  Data 读取到的数据
+ * @return 无
+ */
+static void DHT11_ReadDone(DHT11_Status_t Status, const DHT11_Data_TypeDef *Data)
+{
+    DHT11_Result = Status;
+    if (Status == DHT11_OK) DHT11_ResultData = *Data;
+    Os_SemGive(&DHT11_DoneSem);
+}
+
+/**
+ * @brief  从DHT11读取温湿度数据并返回详细结果
+ * @details 启动异步读取后在信号量上阻塞，起始信号和接收期间线程不占用CPU，
+ *         其他线程照常调度；数据格式：
+ *            - 8位湿度整数
+ *            - 8位湿度小数
+ *            - 8位温度整数
+ *            - 8位温度小数
+ *            - 8位校验和
+ * @note   须在线程中调用
+ * @param  Data 存储读取到的温湿度数据
+ * @return DHT11_Status_t 读取结果
+ */
+DHT11_Status_t DHT11_Read(DHT11_Data_TypeDef *Data)
+{
+    Os_SemTake(&DHT11_DoneSem, 0); // 丢弃此前中止的读取遗留的完成信号
+
+    if (!DHT11_StartRead(DHT11_ReadDone)) return DHT11_ERR_BUSY;
+
+    if (!Os_SemTake(&DHT11_DoneSem, DHT11_READ_TIMEOUT_MS)) {
+        DHT11_Abort();
+        return DHT11_ERR_BUSY;
+    }
+    if (DHT11_Result == DHT11_OK) *Data = DHT11_ResultData;
+    return DHT11_Result;
+}
+
+/**
+ * @brief  从DHT11读取温湿度数据
+ * @note   须在线程中调用
+ * @param  DHT11_Data 存储读取到的温湿度数据
+ * @return 操作结果：
+ *         - SUCCESS: 读取成功
+ *         - ERROR: 读取失败
+ */
+uint8_t DHT11_Read_TempAndHumidity(DHT11_Data_TypeDef *DHT11_Data)
+{
+    return DHT11_Read(DHT11_Data) == DHT11_OK ? SUCCESS : ERROR;
 }
@@ -2,9 +2,9 @@
  * @file     DHT11.h
  * @brief    DHT11温湿度传感器驱动程序头文件
  * @details  定义了DHT11相关的：
- *          - 数据结构
- *          - 硬件连接配置
- *          - 功能函数接口
+ *          - 数据结构与读取结果
+ *          - 硬件连接与时序配置
+ *          - 异步读取、解码与阻塞读取接口
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -37,6 +37,91 @@ typedef struct
 #define DHT11_GPIO_CLK          RCC_APB2Periph_GPIOB    /**< GPIO时钟 */
 #define DHT11_GPIO_PORT         GPIOB                    /**< GPIO端口 */
 #define DHT11_GPIO_PIN          GPIO_Pin_0               /**< GPIO引脚 */
+#define DHT11_EXTI_PORT_SOURCE  GPIO_PortSourceGPIOB     /**< 外部中断端口 */
+#define DHT11_EXTI_PIN_SOURCE   GPIO_PinSource0          /**< 外部中断引脚 */
+#define DHT11_EXTI_LINE         EXTI_Line0               /**< 外部中断线 */
+#define DHT11_EXTI_IRQn         EXTI0_IRQn               /**< 外部中断通道 */
+#define DHT11_EXTI_IRQHandler   EXTI0_IRQHandler         /**< 外部中断服务函数 */
+
+/**
+ * @brief DHT11上电稳定时间（毫秒），期间传感器不响应，不应发送起始信号
+ */
+#ifndef DHT11_POWERUP_MS
+#define DHT11_POWERUP_MS 1000
+#endif
+
+/**
+ * @brief DHT11时序参数（微秒）
+ * @details 起始信号后传感器先以80us低、80us高响应，随后每位以50us低电平开始，
+ *         接着26~28us（0）或70us（1）的高电平。按相邻下降沿的间隔解码：
+ *         响应约160us，位0约76~78us，位1约120us
+ */
+#ifndef DHT11_START_US
+#define DHT11_START_US 20000 /**< 起始信号低电平时间，不少于18ms */
+#endif
+#ifndef DHT11_RESPONSE_US
+#define DHT11_RESPONSE_US 200 /**< 释放总线后等待响应的时限，传感器20~40us后拉低 */
+#endif
+#ifndef DHT11_EDGE_TIMEOUT_US
+#define DHT11_EDGE_TIMEOUT_US 250 /**< 相邻下降沿的时限，大于最长的响应间隔 */
+#endif
+#define DHT11_RESP_MIN_US 120 /**< 响应间隔下限 */
+#define DHT11_RESP_MAX_US 200 /**< 响应间隔上限 */
+#define DHT11_BIT_MIN_US  60  /**< 位间隔下限 */
+#define DHT11_BIT_MAX_US  160 /**< 位间隔上限 */
+#define DHT11_BIT_ONE_US  98  /**< 位间隔超过此值为1 */
+
+/**
+ * @brief 一次读取的下降沿数：响应1个、40位各1个、最后一位结束1个
+ */
+#define DHT11_EDGE_NUM 42
+
+/**
+ * @brief 一次读取从启动到完成回调的最长时间（微秒）
+ * @details 每个阶段都有单次定时保证的时限：起始信号、等待响应、每个下降沿，
+ *         无论传感器是否响应、数据线是否被干扰，都在此时间内结束
+ */
+#define DHT11_READ_MAX_US (DHT11_START_US + DHT11_RESPONSE_US + (DHT11_EDGE_NUM - 1) * DHT11_EDGE_TIMEOUT_US)
+
+/**
+ * @brief 线程等待一次读取完成的最长时间（毫秒）
+ * @details 读取本身不超过DHT11_READ_MAX_US，等满只在TIM4未运行等异常情况下发生
+ */
+#ifndef DHT11_READ_TIMEOUT_MS
+#define DHT11_READ_TIMEOUT_MS (DHT11_READ_MAX_US / 1000 + 10)
+#endif
+
+/**
+ * @brief 读取状态
+ * @details 起始信号由TIM4单次定时结束，之后每个下降沿由外部中断推进一步，
+ *         每一步重新设定本阶段的时限，到期即结束读取
+ */
+typedef enum {
+    DHT11_STATE_IDLE = 0, /**< 空闲 */
+    DHT11_STATE_START,    /**< 主机拉低数据线，等待起始信号结束 */
+    DHT11_STATE_RESPONSE, /**< 已释放总线，等待传感器响应的第一个下降沿 */
+    DHT11_STATE_DATA,     /**< 接收响应和数据位的下降沿 */
+    DHT11_STATE_DONE      /**< 解码并调用完成回调 */
+} DHT11_State_t;
+
+/**
+ * @brief DHT11读取结果
+ */
+typedef enum {
+    DHT11_OK = 0,          /**< 读取成功 */
+    DHT11_ERR_NO_RESPONSE, /**< 释放总线后DHT11_RESPONSE_US内没有响应（未接传感器或尚未上电稳定） */
+    DHT11_ERR_TIMEOUT,     /**< 位超时：有响应，但某个下降沿在DHT11_EDGE_TIMEOUT_US内没有到来 */
+    DHT11_ERR_BIT,         /**< 响应或位间隔超出范围（线路干扰） */
+    DHT11_ERR_CHECKSUM,    /**< 校验和错误 */
+    DHT11_ERR_BUSY         /**< 上一次读取尚未结束，或等待完成超时被中止 */
+} DHT11_Status_t;
+
+/**
+ * @brief 读取完成回调，在中断中执行
+ * @param Status 读取结果
+ * @param Data 读取到的数据，仅Status为DHT11_OK时有效
+ */
+typedef void (*DHT11_Callback_t)(DHT11_Status_t Status, const DHT11_Data_TypeDef *Data);
 
 /**
  * @brief DHT11输入输出控制宏
@@ -52,8 +137,44 @@ typedef struct
  */
 void DHT11_Init(void);
 
+/**
+ * @brief  启动一次异步读取
+ * @details 拉低数据线并由单次定时在DHT11_START_US后释放，之后由外部中断记录下降沿时刻，
+ *         收齐或任一阶段超时后解码并调用Callback；整个过程不占用CPU等待，
+ *         不超过DHT11_READ_MAX_US。每次中断只做常数步操作，收齐后的解码最多40次循环
+ * @param  Callback 完成回调，在中断中执行
+ * @return uint8_t 1-已启动，0-上一次读取尚未结束
+ */
+uint8_t DHT11_StartRead(DHT11_Callback_t Callback);
+
+/**
+ * @brief  获取读取状态
+ * @param  无
+ * @return DHT11_State_t 当前所处的阶段
+ */
+DHT11_State_t DHT11_GetState(void);
+
+/**
+ * @brief  解码一次读取的下降沿时刻
+ * @details 只依赖输入数据，不访问硬件
+ * @param  Edges 各下降沿的时刻（微秒，16位计数，回绕后差值仍然正确）
+ * @param  Count 下降沿数量
+ * @param  Data 解码得到的数据
+ * @return DHT11_Status_t 读取结果
+ */
+DHT11_Status_t DHT11_Decode(const uint16_t *Edges, uint8_t Count, DHT11_Data_TypeDef *Data);
+
+/**
+ * @brief  读取DHT11的温湿度数据并返回详细结果
+ * @details 启动异步读取后阻塞等待完成，须在线程中调用
+ * @param  Data 读取到的数据，仅返回DHT11_OK时有效
+ * @return DHT11_Status_t 读取结果
+ */
+DHT11_Status_t DHT11_Read(DHT11_Data_TypeDef *Data);
+
 /**
  * @brief  读取DHT11的温湿度数据
+ * @details 同DHT11_Read，只区分成功和失败
  * @param  DHT11_Data 指向存储测量数据的结构体的指针
  * @return 操作结果
  *         - SUCCESS: 读取成功
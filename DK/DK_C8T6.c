@@ -17,6 +17,7 @@
  * @version  v1.0
  */
 
+#include <stdio.h> // printf（调试串口统计输出）
 #include "DK_C8T6.h"
 #include "Timer.h" // 包含Timer.h以访问定时器相关变量
 
@@ -42,16 +43,15 @@ static uint8_t fixed_humi_int             = 0;           // 固定湿度值的
 static uint8_t fixed_humi_deci            = 0;           // 固定湿度值的小数部分
 
 /**
- * @brief 系统运行时间和定时器变量（由Timer.c维护）
+ * @brief 模式定时：红外触发的UV灯脉冲和循环模式的开关节拍都由软件定时器完成
  */
-extern uint32_t system_runtime_s;  // 系统运行秒数
-extern uint32_t ms_count;          // 毫秒计数器
-extern uint32_t uv_timer_ms;       // 红外触发UV灯计时器
-extern uint8_t uv_infrared_active; // 红外触发UV灯工作标志
-extern uint32_t cycle_timer_ms;    // 循环模式计时器
-extern uint8_t cycle_state;        // 循环模式状态
-extern uint8_t update_flag;        // 定时更新标志
-extern uint8_t RED_Flag;           // 红外检测标志
+#define UV_PULSE_MS   2000 /**< 红外触发UV灯的工作时间 */
+#define CYCLE_HALF_MS 5000 /**< 循环模式开启、关闭各持续的时间 */
+
+static SoftTimer_t uv_pulse_timer;     // 红外触发UV灯定时器
+static SoftTimer_t cycle_timer;        // 循环模式定时器
+static uint8_t uv_infrared_active = 0; // 红外触发UV灯工作标志
+static uint8_t cycle_state        = 0; // 循环模式状态
 
 /**
  * @brief 系统工作模式，默认为手动模式
@@ -59,101 +59,197 @@ extern uint8_t RED_Flag;           // 红外检测标志
 SystemMode_t currentMode = MODE_MANUAL;
 
 /**
- * @brief 保存上次有效的传感器数据
- * @note  用于传感器读取失败时保持上次的有效数据
+ * @brief  红外触发UV灯脉冲结束（单次定时器回调）
+ * @details 仍在自动模式时关闭UV灯并让舵机复位；已切换模式时设备已由模式切换关闭
+ */
+static void OnUvPulseEnd(void)
+{
+    uv_infrared_active = 0;
+    if (currentMode == MODE_AUTO) {
+        UV_OFF();
+        Servo_SetAngle(0);
+    }
+}
+
+/**
+ * @brief  循环模式开关切换（周期定时器回调）
+ */
+static void OnCycleToggle(void)
+{
+    if (cycle_state == 0) {
+        Fan_ON();
+        UV_ON();
+        Buzzer_ON();
+        Motor_SetSpeed(20);
+        cycle_state = 1;
+    } else {
+        Fan_OFF();
+        UV_OFF();
+        Buzzer_OFF();
+        Motor_SetSpeed(0);
+        cycle_state = 0;
+    }
+}
+
+/**
+ * @brief  进入循环模式
+ * @details 立即开启设备，之后每CYCLE_HALF_MS切换一次
+ */
+static void Cycle_Start(void)
+{
+    cycle_state = 0;
+    OnCycleToggle();
+    SoftTimer_Start(&cycle_timer, CYCLE_HALF_MS, CYCLE_HALF_MS, OnCycleToggle);
+}
+
+/**
+ * @brief  退出循环模式
+ */
+static void Cycle_Stop(void)
+{
+    SoftTimer_Stop(&cycle_timer);
+    cycle_state = 0;
+}
+
+/**
+ * @brief 最新显示数据，由显示任务整理和使用
+ */
+static DisplayData_t display_data;
+
+/**
+ * @brief 显示任务统计
  */
-SensorData_t last_valid_sensor_data = {0};
+DisplayStats_t display_stats = {0};
 
-// 存储上一次显示的值，用于比较是否需要更新
-static struct {
-    int keyValue;
-    uint8_t dht11_status;
-    uint8_t humi_int;
-    uint8_t humi_deci;
-    uint8_t temp_int;
-    uint8_t temp_deci;
-    uint8_t uvLevel;
-    uint8_t redValue;
-    int8_t bt_status;
-    uint8_t initialized;
-} last_display = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+/**
+ * @brief 启动阶段时间戳
+ */
+uint32_t boot_time_us[BOOT_STAGE_NUM] = {0};
+static uint8_t boot_marked            = 0; // 已记录阶段的位图
+
+/**
+ * @brief  记录启动阶段时间戳
+ * @details 每个阶段只记录第一次，时间为自定时器启动起的微秒数
+ * @param  Stage 启动阶段
+ * @return 无
+ */
+void Boot_Mark(BootStage_t Stage)
+{
+    if (boot_marked & (1 << Stage)) return;
+    boot_marked |= (1 << Stage);
+    boot_time_us[Stage] = Timer_GetMicros();
+}
+
+#if SYS_DEBUG_SERIAL
+/**
+ * @brief  从调试串口输出启动耗时分解
+ * @details 每个阶段输出结束时间和相对上一阶段的耗时
+ * @param  无
+ * @return 无
+ */
+static void Boot_Report(void)
+{
+    static const char *const names[BOOT_STAGE_NUM] = {
+        "timer", "comm", "io", "sensor", "oled", "first packet", "first frame"};
+    uint32_t prev = 0;
+    uint8_t i;
+
+    for (i = 0; i < BOOT_STAGE_NUM; i++) {
+        printf("[BOOT] %-12s %7luus (+%luus)\r\n", names[i],
+               (unsigned long)boot_time_us[i], (unsigned long)(boot_time_us[i] - prev));
+        prev = boot_time_us[i];
+    }
+}
+#endif
 
 /**
  * @brief  系统初始化
  * @details 完成所有外设的初始化配置：
+ *         - DWT周期计数器与定时器（最先启动，作为延时、启动计时和等待的时基）
  *         - 通信接口（蓝牙、串口）
- *         - 传感器（DHT11、SD12等）
  *         - 执行器（电机、舵机等）
- *         - 人机交互（按键、LED、OLED等）
- *         - 定时器
+ *         - 人机交互（按键、LED）
+ *         - 传感器（DHT11、SD12等），ADC校准在后台进行，完成后开始后台扫描
+ *         - OLED：屏幕上电等待与上面的初始化重叠，
+ *           只等待剩余时间，不再使用空循环延时
+ *         每个阶段结束时调用Boot_Mark记录时间戳
  * @param  无
  * @return 无
  */
 void Sys_Init(void)
 {
-    BT_Init();      // 初始化蓝牙
+    Delay_Init(); // 使能DWT周期计数器，延时函数依赖它
+    Timer_Init(); // 初始化定时器
+    Boot_Mark(BOOT_STAGE_TIMER);
+
+    BT_Init(); // 初始化蓝牙
+    Boot_Mark(BOOT_STAGE_COMM);
+
     Buzzer_Init();  // 初始化蜂鸣器
     Fan_Init();     // 初始化风扇
     LED_Sys_Init(); // 初始化LED灯
     UV_Init();      // 初始化紫外线灯
     Key_Init();     // 初始化按键
     Motor_Init();   // 初始化电机
-    RED_Init();     // 初始化红外传感器
-    SD12_Init();    // 初始化SD12紫外线传感器
-    DHT11_Init();   // 初始化DHT11传感器
     Servo_Init();   // 初始化舵机
-    OLED_Init();    // 初始化OLED屏幕
-    Timer_Init();   // 初始化定时器
+    Boot_Mark(BOOT_STAGE_IO);
+
+    RED_Init();   // 初始化红外传感器
+    SD12_Init();  // 初始化SD12紫外线传感器（启动ADC校准，不等待）
+    DHT11_Init(); // 初始化DHT11传感器
+    Sensor_Init(); // 初始化传感器采样缓存
+    AD_Start();    // 按注册的通道配置ADC，等待校准完成后开始后台扫描
+    Boot_Mark(BOOT_STAGE_SENSOR);
+
+    while (Timer_GetMicros() < OLED_POWERUP_MS * 1000); // 等待屏幕上电完成的剩余时间
+    OLED_Init();                                        // 初始化OLED屏幕
+    Boot_Mark(BOOT_STAGE_OLED);
+
+#if SYS_DEBUG_SERIAL
+    Serial_Init(); // 初始化调试串口（须在Key_Init之后，接管PA9/PA10）
+#endif
+
+    Idle_Init(); // 初始化空闲休眠
 }
 
 /**
  * @brief  获取所有传感器数据
- * @details 读取并整合所有传感器数据：
- *         1. DHT11温湿度数据
- *         2. SD12紫外线数据
- *         3. 红外传感器数据
- * @note   当DHT11读取失败时，会使用上次的有效数据
+ * @details 整合传感器采样缓存和控制状态快照，不访问硬件，可在任意线程中调用：
+ *         1. DHT11温湿度数据（按模式选择传感器缓存或固定值）及其序号和年龄
+ *         2. SD12紫外线等级（最新采样）
+ *         3. 红外传感器状态（控制状态快照）
+ * @note   DHT11读取失败或处于上电稳定期时，缓存保持上次的有效数据
  * @return 包含所有传感器数据的结构体
  */
 SensorData_t GetAllSensorData(void)
 {
     SensorData_t data;
-    DHT11_Data_TypeDef DHT11_Data;
-
-    // 获取DHT11数据
-    if (DHT11_Read_TempAndHumidity(&DHT11_Data) == SUCCESS) {
-        // 读取成功，保存为有效数据
-        data.dht11_status                = 0;
-        last_valid_sensor_data.humi_int  = DHT11_Data.humi_int;
-        last_valid_sensor_data.humi_deci = DHT11_Data.humi_deci;
-        last_valid_sensor_data.temp_int  = DHT11_Data.temp_int;
-        last_valid_sensor_data.temp_deci = DHT11_Data.temp_deci;
-    } else {
-        // 读取失败
-        data.dht11_status = 1;
-    }
+    SensorDht11_t dht11;
+    SensorSample_t uv;
+    ControlState_t ctrl;
+
+    GetControlState(&ctrl);
+    Sensor_GetDht11(&dht11);
+    data.dht11_status = dht11.Health == SENSOR_HEALTH_FAULT ? 1 : 0;
+    data.dht11_seq    = dht11.Seq;
+    data.dht11_age    = dht11.Age;
 
     // 根据模式选择返回的温湿度值
-    if (currentTempHumiMode == MODE_SENSOR) {
-        // 使用传感器数据（成功时用新数据，失败时用上次有效数据）
-        data.humi_int  = last_valid_sensor_data.humi_int;
-        data.humi_deci = last_valid_sensor_data.humi_deci;
-        data.temp_int  = last_valid_sensor_data.temp_int;
-        data.temp_deci = last_valid_sensor_data.temp_deci;
+    if (!ctrl.fixed_mode) {
+        data.humi_int  = dht11.HumiInt;
+        data.humi_deci = dht11.HumiDeci;
+        data.temp_int  = dht11.TempInt;
+        data.temp_deci = dht11.TempDeci;
     } else {
         // 使用固定值
-        data.humi_int  = fixed_humi_int;
-        data.humi_deci = fixed_humi_deci;
-        data.temp_int  = fixed_temp_int;
-        data.temp_deci = fixed_temp_deci;
+        data.humi_int  = ctrl.fixed_humi_int;
+        data.humi_deci = ctrl.fixed_humi_deci;
+        data.temp_int  = ctrl.fixed_temp_int;
+        data.temp_deci = ctrl.fixed_temp_deci;
     }
 
-    // 获取SD12紫外线数据
-    uint16_t uvValue = SD12_GetADCValue(10);
-    data.uvLevel     = SD12_GetIntensity(uvValue);
-
-    // 获取红外数据
-    data.redValue = RED_Get();
+    data.uvLevel  = Sensor_GetLatest(SENSOR_CH_UV, &uv) ? (uint8_t)uv.Value : 0;
+    data.redValue = ctrl.red_value;
 
     return data;
 }
@@ -161,7 +257,7 @@ SensorData_t GetAllSensorData(void)
 /**
  * @brief  处理按键事件
  * @details 按键功能：
- *         1. 模式切换（按键16）
+ *         1. 模式切换（短按按键16）
  *            - 手动模式：可直接控制各个设备
  *            - 自动模式：系统自动控制
  *            - 蓝牙模式：通过蓝牙控制
@@ -171,6 +267,7 @@ SensorData_t GetAllSensorData(void)
  *            - 按键5/6：紫外线灯开关
  *            - 按键7/8/9：电机控制
  *            - 按键10/11/12：舵机角度控制
+ *         长按按键16切换页面，由界面线程在Task_Key中处理，不会到达这里
  * @param  currentKeyValue 当前按键值
  * @return KeyStatus_t 按键状态：
  *         - keyValue：当前按键值
@@ -183,6 +280,9 @@ KeyStatus_t HandleKeyPress(int currentKeyValue)
     // 初始化状态结构体，初始时按键值设为上次的按键值，更改标志设为0
     KeyStatus_t status = {lastKeyValue, 0};
 
+    // 长按按短按处理
+    currentKeyValue &= ~KEY_LONG_FLAG;
+
     // 当当前按键值不为0时，表示有按键按下
     if (currentKeyValue != 0) {
         // 更新状态结构体的按键值和更改标志
@@ -204,9 +304,11 @@ KeyStatus_t HandleKeyPress(int currentKeyValue)
                     Fan_OFF();
                     Buzzer_OFF();
                     Motor_SetSpeed(0);
+                    Cycle_Start();
                     break;
                 case MODE_CYCLE:
                     // 从循环模式切换出去时，关闭所有设备
+                    Cycle_Stop();
                     UV_OFF();
                     Fan_OFF();
                     Buzzer_OFF();
@@ -296,187 +398,258 @@ KeyStatus_t HandleKeyPress(int currentKeyValue)
 }
 
 /**
- * @brief  处理系统主要任务
- * @details 包含以下功能：
- *         1. 按键输入和传感器数据的处理（100ms周期）
- *         2. 自动模式和循环模式的控制逻辑
- *         3. 蓝牙数据的处理
- *         4. OLED显示的更新
- * @param  无
+ * @brief 控制线程的工作状态，其他线程通过控制状态快照读取
+ */
+static KeyStatus_t key_status = {0, 0}; // 按键状态
+static BTStatus_t bt_status   = {0};    // 蓝牙状态
+static uint32_t bt_rx_time    = 0;      // 最近一次收到蓝牙数据包的时刻
+static uint8_t bt_rx_seen     = 0;      // 是否收到过蓝牙数据包
+static volatile uint8_t bt_stats_request = 0; // 收到蓝牙统计请求，由通信线程发送
+static uint8_t red_value      = 0;      // 红外状态，按事件顺序更新
+
+static ControlState_t control_state; // 控制状态快照，由控制线程发布
+static OsSeq_t control_seq;          // 控制状态快照的顺序锁
+
+/**
+ * @brief  发布控制状态快照
+ * @details 控制线程处理完一批事件和软件定时器后调用，一次写入所有字段
+ */
+static void Control_Publish(void)
+{
+    Os_SeqWriteBegin(&control_seq);
+    control_state.mode            = currentMode;
+    control_state.key_value       = key_status.keyValue;
+    control_state.bt_status       = bt_status.status;
+    control_state.bt_rx_seen      = bt_rx_seen;
+    control_state.bt_rx_time      = bt_rx_time;
+    control_state.red_value       = red_value;
+    control_state.fixed_mode      = (currentTempHumiMode == MODE_FIXED);
+    control_state.fixed_temp_int  = fixed_temp_int;
+    control_state.fixed_temp_deci = fixed_temp_deci;
+    control_state.fixed_humi_int  = fixed_humi_int;
+    control_state.fixed_humi_deci = fixed_humi_deci;
+    Os_SeqWriteEnd(&control_seq);
+}
+
+/**
+ * @brief  获取控制状态快照
+ * @details 复制期间控制线程发布了新的快照时重新复制
+ * @param  State 状态副本
  * @return 无
  */
-void ProcessSystemTasks(void)
+void GetControlState(ControlState_t *State)
 {
-    static uint32_t last_update_time = 0;
-    static BTStatus_t btStatus       = {0};    // 蓝牙状态
-    static KeyStatus_t keyStatus     = {0, 0}; // 按键状态
-
-    // 处理按键输入和传感器数据（100ms一次）
-    if (system_runtime_s * 1000 + ms_count - last_update_time >= 100) {
-        keyStatus = HandleKeyPress(Key_GetNum());
-        // 获取当前有效的温湿度值（可能是传感器值或固定值）
-        SensorData_t sensorData = GetAllSensorData();
-
-        // 计算温湿度浮点数值（用于自动控制逻辑，使用当前有效值）
-        float humi = (float)sensorData.humi_int + (float)sensorData.humi_deci / 10.0;
-        float temp = (float)sensorData.temp_int + (float)sensorData.temp_deci / 10.0;
-
-        // 处理定时器更新的标志
-        if (update_flag) {
-            update_flag = 0; // 清除标志
-
-            // 自动模式逻辑
-            if (currentMode == MODE_AUTO) {
-                // 检查是否有红外触发
-                if (RED_Flag == 1) {
-                    uv_infrared_active = 1;
-                    uv_timer_ms        = 0;
-                    Servo_SetAngle(90);
-                    UV_ON();
-                    RED_Flag = 0;
-                }
+    uint32_t start;
 
-                // 检查UV灯定时关闭
-                if (uv_infrared_active && uv_timer_ms >= 2000) {
-                    uv_infrared_active = 0;
-                    UV_OFF();
-                    Servo_SetAngle(0);
-                }
-
-                // 温湿度控制
-                if (!uv_infrared_active) {
-                    if (temp > TEMP_THRESHOLD && humi > HUMI_THRESHOLD) {
-                        Fan_ON();
-                        UV_ON();
-                    } else {
-                        Fan_OFF();
-                        UV_OFF();
-                    }
-                }
-            }
-            // 循环模式逻辑
-            else if (currentMode == MODE_CYCLE) {
-                if (cycle_timer_ms < 5000) {
-                    if (cycle_state == 0) {
-                        Fan_ON();
-                        UV_ON();
-                        Buzzer_ON();
-                        Motor_SetSpeed(20);
-                        cycle_state = 1;
-                    }
-                } else {
-                    if (cycle_state == 1) {
-                        Fan_OFF();
-                        UV_OFF();
-                        Buzzer_OFF();
-                        Motor_SetSpeed(0);
-                        cycle_state = 0;
-                    }
-                }
-            }
+    do {
+        start  = Os_SeqReadBegin(&control_seq);
+        *State = control_state;
+    } while (Os_SeqReadRetry(&control_seq, start));
+}
+
+/**
+ * @brief  红外电平变化处理
+ * @details 自动模式下检测到障碍物时打开UV灯并转动舵机，UV_PULSE_MS后由定时器关闭；
+ *         脉冲期间再次触发则重新计时
+ * @param  Level 1-检测到障碍物，0-离开
+ */
+static void OnPir(uint8_t Level)
+{
+    if (currentMode == MODE_AUTO && Level == 1) {
+        uv_infrared_active = 1;
+        Servo_SetAngle(90);
+        UV_ON();
+        SoftTimer_Start(&uv_pulse_timer, UV_PULSE_MS, 0, OnUvPulseEnd);
+    }
+}
+
+/**
+ * @brief  事件任务（控制线程取得事件信号量后执行）
+ * @details 读空队列；读取期间新到的事件会再次释放信号量，不会遗漏；
+ *         事件按产生时刻先后处理
+ */
+static void Task_Event(void)
+{
+    Event_t event;
+
+    while (Event_Get(&event)) {
+        switch (event.Type) {
+            case EVENT_PIR:
+                red_value = event.Data[0];
+                Sensor_Push(SENSOR_CH_PIR, event.Time, event.Data[0]);
+                OnPir(event.Data[0]);
+                break;
+            case EVENT_BT_FRAME:
+                bt_status  = HandleBluetooth(event.Data);
+                bt_rx_time = event.Time;
+                bt_rx_seen = 1;
+                break;
+            case EVENT_KEY:
+                key_status = HandleKeyPress(event.Data[0]);
+                break;
+            default:
+                break;
         }
+    }
+}
 
-        // 发送蓝牙数据包
-        BT_SendDataPacket(sensorData.redValue, sensorData.uvLevel, humi, temp);
+/**
+ * @brief  按键扫描任务（KEY_SCAN_MS周期）
+ * @details 扫描到按键时投递EVENT_KEY事件，由事件任务处理；
+ *         长按按键16切换显示页面，在界面线程中直接处理，
+ *         页面切换和渲染都在本线程，切换不会插入到渲染中途
+ */
+static void Task_Key(void)
+{
+    uint8_t key = Key_GetNum();
 
-        // 处理蓝牙数据
-        btStatus = HandleBluetooth();
+    if (key == (KEY_LONG_FLAG | 16)) {
+        Display_NextPage();
+    } else if (key != 0) {
+        Event_Post(EVENT_KEY, &key, 1);
+    }
+}
 
-        // 更新显示
-        OLED_UpdateDisplay(keyStatus.keyValue, sensorData.dht11_status,
-                           sensorData.humi_int, sensorData.humi_deci,
-                           sensorData.temp_int, sensorData.temp_deci,
-                           sensorData.uvLevel, sensorData.redValue, btStatus.status);
+/**
+ * @brief  控制任务（CONTROL_PERIOD_MS周期）
+ * @details 自动模式的温湿度控制逻辑
+ */
+static void Task_Control(void)
+{
+    SensorData_t sensorData = GetAllSensorData();
+
+    // 计算温湿度浮点数值（用于自动控制逻辑，使用当前有效值）
+    float humi = (float)sensorData.humi_int + (float)sensorData.humi_deci / 10.0;
+    float temp = (float)sensorData.temp_int + (float)sensorData.temp_deci / 10.0;
+
+    // 自动模式逻辑
+    if (currentMode == MODE_AUTO) {
+        // 温湿度控制（红外触发的UV灯脉冲期间不干预）
+        if (!uv_infrared_active) {
+            if (temp > TEMP_THRESHOLD && humi > HUMI_THRESHOLD) {
+                Fan_ON();
+                UV_ON();
+            } else {
+                Fan_OFF();
+                UV_OFF();
+            }
+        }
+    }
+}
 
-        last_update_time = system_runtime_s * 1000 + ms_count;
+/**
+ * @brief  蓝牙数据上报任务（BT_TELEMETRY_MS周期）
+ * @details 发送数据包；收到统计请求后追加一行文本统计，格式同调试串口的[CTRL]行
+ */
+static void Task_Telemetry(void)
+{
+    SensorData_t sensorData = GetAllSensorData();
+    float humi              = (float)sensorData.humi_int + (float)sensorData.humi_deci / 10.0;
+    float temp              = (float)sensorData.temp_int + (float)sensorData.temp_deci / 10.0;
+    char line[MONITOR_LINE_LEN];
+
+    PROF_BEGIN(PROF_BT_SEND);
+    BT_SendDataPacket(sensorData.redValue, sensorData.uvLevel, humi, temp);
+    PROF_END(PROF_BT_SEND);
+    Boot_Mark(BOOT_STAGE_FIRST_PACKET);
+
+    // 收到统计请求时在数据包之后追加一行控制周期统计
+    if (bt_stats_request) {
+        bt_stats_request = 0;
+        Monitor_Format(line, sizeof(line));
+        BT_SendString(line);
     }
 }
 
 /**
  * @brief  处理蓝牙通信
  * @details 完成以下功能：
- *         1. 接收并解析蓝牙数据包
+ *         1. 解析蓝牙数据包
  *         2. 根据数据包内容控制设备：
  *            - UV灯控制
  *            - 舵机控制
  *            - 风扇控制
  *            - 电机控制
  * @note   仅在蓝牙模式下处理数据包
+ * @param  Frame 接收到的一帧（由EVENT_BT_FRAME事件携带）
  * @return BTStatus_t 蓝牙状态结构体
  */
-BTStatus_t HandleBluetooth(void)
+BTStatus_t HandleBluetooth(const uint8_t *Frame)
 {
     BTStatus_t btStatus = {0}; // 初始化为0
 
-    if (BT_RxFlag == 1) {    // 始终接收并解析数据包
-        BT_RxFlag       = 0; // 清除接收标志
-        btStatus.status = BT_ParsePacket();
-
-        if (btStatus.status == 0) {
-            // 从flags字节中提取各个标志位
-            btStatus.uv_flag    = (BT_Packet.flags >> 0) & 0x01;
-            btStatus.servo_flag = (BT_Packet.flags >> 1) & 0x01;
-            btStatus.fan_flag   = (BT_Packet.flags >> 2) & 0x01;
-            btStatus.motor_flag = (BT_Packet.flags >> 3) & 0x01;
-            btStatus.mode_flag  = (BT_Packet.flags >> 4) & 0x01;
-
-            // 无论当前模式如何，都处理模式标志位
-            if (btStatus.mode_flag) {
-                // 在三种模式间循环切换：手动->自动->蓝牙->手动
-                switch (currentMode) {
-                    case MODE_MANUAL:
-                        currentMode = MODE_AUTO;
-                        break;
-                    case MODE_AUTO:
-                        currentMode = MODE_CYCLE;
-                        // 从自动模式切换出去时，关闭所有设备
-                        UV_OFF();
-                        Fan_OFF();
-                        Buzzer_OFF();
-                        Motor_SetSpeed(0);
-                        break;
-                    case MODE_CYCLE:
-                        // 从循环模式切换出去时，关闭所有设备
-                        UV_OFF();
-                        Fan_OFF();
-                        Buzzer_OFF();
-                        Motor_SetSpeed(0);
-                        currentMode = MODE_BT;
-                        break;
-                    case MODE_BT:
-                        currentMode = MODE_MANUAL;
-                        // 切换到手动模式时，关闭所有设备
-                        UV_OFF();
-                        Fan_OFF();
-                        Buzzer_OFF();
-                        Motor_SetSpeed(0);
-                        break;
-                }
-            }
+    btStatus.status = BT_ParsePacket(Frame); // 始终解析数据包
 
-            // 只有在蓝牙模式下才处理设备控制
-            if (currentMode == MODE_BT) {
-                if (btStatus.uv_flag)
-                    UV_ON();
-                else
-                    UV_OFF();
+    if (btStatus.status == 0) {
+        // 从flags字节中提取各个标志位
+        btStatus.uv_flag    = (BT_Packet.flags >> 0) & 0x01;
+        btStatus.servo_flag = (BT_Packet.flags >> 1) & 0x01;
+        btStatus.fan_flag   = (BT_Packet.flags >> 2) & 0x01;
+        btStatus.motor_flag = (BT_Packet.flags >> 3) & 0x01;
+        btStatus.mode_flag  = (BT_Packet.flags >> 4) & 0x01;
+        btStatus.stats_flag = (BT_Packet.flags >> 5) & 0x01;
 
-                if (btStatus.servo_flag)
-                    Servo_SetAngle(90);
-                else
-                    Servo_SetAngle(0);
+        // 统计请求与模式无关，由通信线程在下一次上报时发送，控制线程不等待串口
+        if (btStatus.stats_flag) bt_stats_request = 1;
 
-                if (btStatus.fan_flag)
-                    Fan_ON();
-                else
+        // 无论当前模式如何，都处理模式标志位
+        if (btStatus.mode_flag) {
+            // 在三种模式间循环切换：手动->自动->蓝牙->手动
+            switch (currentMode) {
+                case MODE_MANUAL:
+                    currentMode = MODE_AUTO;
+                    break;
+                case MODE_AUTO:
+                    currentMode = MODE_CYCLE;
+                    // 从自动模式切换出去时，关闭所有设备
+                    UV_OFF();
                     Fan_OFF();
-
-                if (btStatus.motor_flag)
-                    Motor_SetSpeed(50);
-                else
+                    Buzzer_OFF();
                     Motor_SetSpeed(0);
+                    Cycle_Start();
+                    break;
+                case MODE_CYCLE:
+                    // 从循环模式切换出去时，关闭所有设备
+                    Cycle_Stop();
+                    UV_OFF();
+                    Fan_OFF();
+                    Buzzer_OFF();
+                    Motor_SetSpeed(0);
+                    currentMode = MODE_BT;
+                    break;
+                case MODE_BT:
+                    currentMode = MODE_MANUAL;
+                    // 切换到手动模式时，关闭所有设备
+                    UV_OFF();
+                    Fan_OFF();
+                    Buzzer_OFF();
+                    Motor_SetSpeed(0);
+                    break;
             }
         }
+
+        // 只有在蓝牙模式下才处理设备控制
+        if (currentMode == MODE_BT) {
+            if (btStatus.uv_flag)
+                UV_ON();
+            else
+                UV_OFF();
+
+            if (btStatus.servo_flag)
+                Servo_SetAngle(90);
+            else
+                Servo_SetAngle(0);
+
+            if (btStatus.fan_flag)
+                Fan_ON();
+            else
+                Fan_OFF();
+
+            if (btStatus.motor_flag)
+                Motor_SetSpeed(50);
+            else
+                Motor_SetSpeed(0);
+        }
     }
 
     return btStatus;
@@ -490,134 +663,349 @@ BTStatus_t HandleBluetooth(void)
  *         3. 温湿度值
  *         4. 紫外线等级
  *         5. 红外传感器状态
- *         6. 蓝牙通信状态
+ *         6. 蓝牙接收标志
  *         7. 当前工作模式
- * @note   使用状态缓存，仅在数据变化时更新显示
+ * @note   只负责准备显示数据，不访问屏幕；绘制和刷新由显示任务
+ *         按自己的帧率完成，慢速的屏幕传输不占用其他任务的时间
  * @param  keyValue    按键值
- * @param  dht11_status DHT11状态
+ * @param  dht11_status DHT11状态（已由传感器缓存做过连续失败判定）
  * @param  humi_int    湿度整数部分
  * @param  humi_deci   湿度小数部分
  * @param  temp_int    温度整数部分
  * @param  temp_deci   温度小数部分
  * @param  uvLevel     紫外线等级
  * @param  redValue    红外传感器值
- * @param  bt_status   蓝牙状态
+ * @param  bt_rx       蓝牙接收标志
+ * @param  mode        工作模式
  * @return 无
  */
 void OLED_UpdateDisplay(int keyValue, uint8_t dht11_status,
                         uint8_t humi_int, uint8_t humi_deci,
                         uint8_t temp_int, uint8_t temp_deci,
-                        uint8_t uvLevel, uint8_t redValue, int8_t bt_status)
+                        uint8_t uvLevel, uint8_t redValue,
+                        uint8_t bt_rx, uint8_t mode)
+{
+    display_data.keyValue  = keyValue;
+    display_data.redValue  = redValue ? 1 : 0;
+    display_data.dht11_err = dht11_status ? 1 : 0;
+    display_data.uvLevel   = uvLevel;
+    display_data.humi      = DISPLAY_FIXED(humi_int, humi_deci);
+    display_data.temp      = DISPLAY_FIXED(temp_int, temp_deci);
+    display_data.bt_rx     = bt_rx ? 1 : 0;
+    display_data.mode      = mode;
+    display_data.runtime_s = Timer_GetSeconds();
+}
+
+/**
+ * @brief 线程控制块与栈
+ */
+static OsThread_t control_thread;
+static OsThread_t comm_thread;
+static OsThread_t sensor_thread;
+static OsThread_t ui_thread;
+static uint32_t control_stack[CONTROL_STACK_WORDS];
+static uint32_t comm_stack[COMM_STACK_WORDS];
+static uint32_t sensor_stack[SENSOR_STACK_WORDS];
+static uint32_t ui_stack[UI_STACK_WORDS];
+
+/**
+ * @brief  整理诊断页数据
+ * @details CPU负载、全局变量占用和各栈从未使用过的字节数
+ * @param  无
+ * @return 无
+ */
+static void Display_FillDiag(void)
 {
-    // 首次显示时初始化所有内容
-    if (!last_display.initialized) {
-        OLED_ShowString(1, 1, "K:");
-        OLED_ShowString(1, 5, "R:");
-        OLED_ShowString(1, 9, "D:");
-        OLED_ShowString(2, 1, "hm:");
-        OLED_ShowString(3, 1, "T:");
-        OLED_ShowString(3, 5, ".");
-        OLED_ShowString(3, 7, "C UV:");
-        OLED_ShowString(4, 1, "T:");
-        OLED_ShowString(4, 9, "B:");
-        OLED_ShowString(4, 12, "M:");
-
-        last_display.initialized = 1;
+    DiagRam_t ram;
+
+    Diag_GetRam(&ram);
+    display_data.cpu_load      = Diag_GetCpuLoad();
+    display_data.ram_static    = (uint16_t)ram.Static;
+    display_data.stack_control = Os_GetStackFree(&control_thread) * 4;
+    display_data.stack_comm    = Os_GetStackFree(&comm_thread) * 4;
+    display_data.stack_sensor  = Os_GetStackFree(&sensor_thread) * 4;
+    display_data.stack_ui      = Os_GetStackFree(&ui_thread) * 4;
+    display_data.stack_idle    = Os_GetStackFree(Os_GetThread(Os_GetThreadNum() - 1)) * 4;
+    display_data.stack_msp     = (uint16_t)Diag_GetMspFree();
+}
+
+/**
+ * @brief  显示任务（DISPLAY_FRAME_MS周期）
+ * @details 与其他任务相互独立：
+ *         1. 从控制状态快照和传感器缓存整理显示数据
+ *         2. 按布局表把变化的字段绘制到显存（纯内存操作）
+ *         3. 分段刷新脏区，每段之间检查时间预算，
+ *            预算用完时剩余脏区保留到下一帧继续发送，不阻塞其他任务
+ *         4. 记录帧耗时与顺延统计
+ */
+static void Task_Display(void)
+{
+    SensorData_t sensorData = GetAllSensorData();
+    ControlState_t ctrl;
+    uint32_t start;
+    uint8_t dirty;
+
+    PROF_BEGIN(PROF_DISPLAY);
+    start = Timer_GetMicros();
+
+    // 整理显示数据
+    GetControlState(&ctrl);
+    OLED_UpdateDisplay(ctrl.key_value, sensorData.dht11_status,
+                       sensorData.humi_int, sensorData.humi_deci,
+                       sensorData.temp_int, sensorData.temp_deci,
+                       sensorData.uvLevel, sensorData.redValue,
+                       ctrl.bt_rx_seen && Timer_GetMillis() - ctrl.bt_rx_time < BT_RX_HOLD_MS,
+                       ctrl.mode);
+
+    // 诊断页数据需要扫描各个栈，只在显示诊断页时整理
+    if (Display_GetPage() == DISPLAY_PAGE_DIAG) Display_FillDiag();
+
+    // 按布局表只重绘变化的字段
+    Display_Render(&display_data);
+
+    // 在预算内分段刷新变化区域
+    while (OLED_UpdateStep()) {
+        if (Timer_GetMicros() - start >= DISPLAY_FRAME_BUDGET_US) break;
     }
+    PROF_END(PROF_DISPLAY);
 
-    // 更新按键值（如果改变）
-    if (last_display.keyValue != keyValue) {
-        OLED_ShowNum(1, 3, keyValue, 2); // K:##
-        last_display.keyValue = keyValue;
+    // 更新统计
+    display_stats.frame_us = Timer_GetMicros() - start;
+    if (display_stats.frame_us > display_stats.frame_max_us) {
+        display_stats.frame_max_us = display_stats.frame_us;
     }
+    display_stats.frames++;
 
-    // 更新红外值（强制每次更新）
-    OLED_ShowString(1, 7, redValue ? "Y" : "N"); // R:Y/N
-    last_display.redValue = redValue;
-
-    // 更新DHT11状态（成功显示OK，连续三次失败才显示ERR）
-    static uint8_t err_count = 0;
-    if (dht11_status == 0) {
-        // 成功时立即显示OK
-        OLED_ShowString(1, 10, "OK ");
-        last_display.dht11_status = 0;
-        err_count                 = 0;
-    } else {
-        // 错误时累计次数
-        err_count++;
-        if (err_count >= 3) {
-            // 连续三次失败时显示ERR
-            OLED_ShowString(1, 10, "ERR");
-            last_display.dht11_status = 1;
+    dirty = OLED_GetDirtyPages();
+    if (dirty) {
+        display_stats.over_budget++;
+        for (; dirty; dirty &= dirty - 1) {
+            display_stats.deferred++;
         }
-        // 否则保持原来的显示状态
+    } else if (!OLED_IsBusy() && !(boot_marked & (1 << BOOT_STAGE_FIRST_FRAME))) {
+        // 第一帧已完整显示
+        Boot_Mark(BOOT_STAGE_FIRST_FRAME);
+#if SYS_DEBUG_SERIAL
+        Boot_Report();
+#endif
     }
+}
 
-    // 更新湿度（如果改变）
-    float humi                   = humi_int + humi_deci / 10.0f;
-    int humi_display             = (int)(humi * 10); // 保留一位小数
-    static int last_humi_display = -1;
-
-    if (last_humi_display != humi_display) {
-        OLED_ShowNum(2, 4, humi_display / 10, 2); // 整数部分
-        OLED_ShowString(2, 6, ".");               // 小数点
-        OLED_ShowNum(2, 7, humi_display % 10, 1); // 小数部分
-        OLED_ShowString(2, 8, "%");               // 百分号
-        last_humi_display = humi_display;
+#if SYS_DEBUG_SERIAL
+/**
+ * @brief  调试统计输出任务（DEBUG_STATS_PERIOD_S周期）
+ * @details 输出CPU负载、RAM占用、事件、传感器采样、ADC扫描、控制周期、显示任务统计，
+ *         以及各线程被切换运行的次数、错过的周期数和栈的最大使用量
+ */
+static void Task_Report(void)
+{
+    const OsThread_t *thread;
+    SensorDht11_t dht11;
+    DiagRam_t ram;
+    char line[MONITOR_LINE_LEN];
+    int16_t chip_temp;
+    uint8_t i;
+
+    Diag_GetRam(&ram);
+    printf("[CPU] load=%u%% stop=%lu\r\n", (unsigned int)Diag_GetCpuLoad(),
+           (unsigned long)Idle_GetStopCount());
+    printf("[RAM] static=%luB msp=%luB heap=%luB free=%luB msp_unused=%luB\r\n",
+           (unsigned long)ram.Static, (unsigned long)ram.Msp, (unsigned long)ram.Heap,
+           (unsigned long)ram.Free, (unsigned long)Diag_GetMspFree());
+
+    printf("[EVT] dropped=%lu\r\n", (unsigned long)Event_GetDropped());
+
+    Sensor_GetDht11(&dht11);
+    printf("[DHT11] seq=%lu age=%lums health=%u fails=%u reads=%lu err=%lu/%lu/%lu/%lu\r\n",
+           (unsigned long)dht11.Seq, (unsigned long)dht11.Age, (unsigned int)dht11.Health,
+           (unsigned int)dht11.Fails, (unsigned long)dht11.Reads, (unsigned long)dht11.NoResponse,
+           (unsigned long)dht11.Timeout, (unsigned long)dht11.BitError, (unsigned long)dht11.Checksum);
+    printf("[ACQ] temp=%lu humi=%lu uv=%lu pir=%lu\r\n", (unsigned long)Sensor_GetHead(SENSOR_CH_TEMP),
+           (unsigned long)Sensor_GetHead(SENSOR_CH_HUMI), (unsigned long)Sensor_GetHead(SENSOR_CH_UV),
+           (unsigned long)Sensor_GetHead(SENSOR_CH_PIR));
+    chip_temp = AD_GetChipTemp();
+    printf("[ADC] blocks=%lu uv=%u vdd=%umV chip=%s%u.%uC\r\n", (unsigned long)AD_GetBlocks(),
+           (unsigned int)SD12_GetADCValue(), (unsigned int)AD_GetVdd(), chip_temp < 0 ? "-" : "",
+           (unsigned int)(chip_temp < 0 ? -chip_temp : chip_temp) / 10,
+           (unsigned int)(chip_temp < 0 ? -chip_temp : chip_temp) % 10);
+
+    Monitor_Format(line, sizeof(line));
+    printf("%s", line);
+
+    printf("[OLED] frames=%lu last=%luus max=%luus over=%lu deferred=%lu\r\n",
+           (unsigned long)display_stats.frames, (unsigned long)display_stats.frame_us,
+           (unsigned long)display_stats.frame_max_us, (unsigned long)display_stats.over_budget,
+           (unsigned long)display_stats.deferred);
+
+    for (i = 0; i < Os_GetThreadNum(); i++) {
+        thread = Os_GetThread(i);
+        printf("[THREAD] %-7s prio=%u switches=%lu overruns=%lu stack=%lu/%luB\r\n", thread->Name,
+               (unsigned int)thread->Priority, (unsigned long)thread->Switches,
+               (unsigned long)thread->Overruns,
+               (unsigned long)(thread->StackWords - Os_GetStackFree(thread)) * 4,
+               (unsigned long)thread->StackWords * 4);
     }
+}
 
-    // 更新温度（如果改变）
-    if (last_display.temp_int != temp_int) {
-        OLED_ShowNum(3, 3, temp_int, 2);
-        last_display.temp_int = temp_int;
-    }
-    if (last_display.temp_deci != temp_deci) {
-        OLED_ShowNum(3, 6, temp_deci, 1);
-        last_display.temp_deci = temp_deci;
+/**
+ * @brief  调试串口命令处理（界面线程每次扫描时调用）
+ * @details 命令为单个字符：
+ *         - s：立即输出统计
+ *         - c：清除控制周期统计
+ *         - p：输出执行时间分析报告
+ *         - r：清除执行时间分析统计
+ */
+static void Task_Command(void)
+{
+    switch (Serial_GetCmd()) {
+        case 's':
+            Task_Report();
+            break;
+        case 'c':
+            Monitor_Reset();
+            break;
+#if PROF_ENABLE
+        case 'p':
+            Prof_Report();
+            break;
+        case 'r':
+            Prof_Reset();
+            break;
+#endif
+        default:
+            break;
     }
+}
+#endif
+
+/**
+ * @brief  判断时刻是否已到达
+ * @details 按有符号差值比较，计数器回绕时仍然正确
+ */
+#define SYS_REACHED(now, t) ((int32_t)((now) - (t)) >= 0)
 
-    // 更新紫外线等级（如果改变）
-    if (last_display.uvLevel != uvLevel) {
-        OLED_ShowNum(3, 12, uvLevel, 2);
-        last_display.uvLevel = uvLevel;
+/**
+ * @brief  控制线程
+ * @details 等待事件信号量，超时取下一个控制周期和最早的软件定时器到期中较早者：
+ *         1. 处理所有待处理事件（红外、蓝牙数据包、按键）
+ *         2. 执行到期的软件定时器回调（红外UV脉冲、循环模式节拍）
+ *         3. 到达控制周期时执行控制逻辑，落后一个周期以上时跳过错过的周期；
+ *            起始偏差、执行时间和超时由周期监视统计
+ */
+static void Thread_Control(void)
+{
+    uint32_t next = Timer_GetMillis() + CONTROL_PERIOD_MS;
+    uint32_t timeout, timer, skipped;
+    int32_t left;
+
+    Monitor_Init();
+    red_value = RED_Get(); // 之后按EVENT_PIR事件更新
+    Control_Publish();
+
+    while (1) {
+        left    = (int32_t)(next - Timer_GetMillis());
+        timeout = (left > 0) ? (uint32_t)left : 0;
+        timer   = SoftTimer_GetIdleTime();
+        if (timer < timeout) timeout = timer;
+
+        Os_SemTake(&Event_Sem, timeout);
+        PROF_BEGIN(PROF_EVENT);
+        Task_Event();
+        PROF_END(PROF_EVENT);
+        SoftTimer_Run();
+        Control_Publish();
+
+        if (SYS_REACHED(Timer_GetMillis(), next)) {
+            Monitor_TickStart(next);
+            PROF_BEGIN(PROF_CONTROL);
+            Task_Control();
+            PROF_END(PROF_CONTROL);
+            next += CONTROL_PERIOD_MS;
+            for (skipped = 0; SYS_REACHED(Timer_GetMillis(), next); skipped++) next += CONTROL_PERIOD_MS;
+            Monitor_TickEnd(skipped);
+        }
     }
+}
 
-    // 更新第四行：运行时间、蓝牙状态和模式
-    static uint32_t last_runtime = 0xFFFFFFFF;
-    static uint8_t last_bt_rx    = 0;
-    static uint8_t last_mode     = 0xFF;
+/**
+ * @brief  通信线程
+ * @details 每BT_TELEMETRY_MS上报一次数据，发送期间不影响控制线程响应事件
+ */
+static void Thread_Comm(void)
+{
+    uint32_t wake = Timer_GetMillis();
 
-    // 更新运行时间（如果改变）
-    if (last_runtime != system_runtime_s) {
-        OLED_ShowNum(4, 3, system_runtime_s, 4); // T:####
-        OLED_ShowString(4, 7, "s");              // s
-        last_runtime = system_runtime_s;
+    while (1) {
+        Task_Telemetry();
+        Os_SleepUntil(&wake, BT_TELEMETRY_MS);
     }
+}
+
+/**
+ * @brief  传感器线程
+ * @details 每UV_SAMPLE_MS调用一次传感器采样调度：紫外线每次采样，DHT11按DHT11_PERIOD_MS读取；
+ *         DHT11读取由定时器和外部中断完成，期间线程阻塞，不锁定调度
+ */
+static void Thread_Sensor(void)
+{
+    uint32_t wake = Timer_GetMillis();
 
-    // 更新蓝牙状态（如果改变）
-    if (BT_RxFlag == 1 && !last_bt_rx) {
-        OLED_ShowString(4, 11, "R"); // 显示接收标志
-    } else if (BT_RxFlag == 0 && last_bt_rx) {
-        OLED_ShowString(4, 11, " "); // 清除接收标志
+    while (1) {
+        Sensor_Poll();
+        Os_SleepUntil(&wake, UV_SAMPLE_MS);
     }
-    last_bt_rx = BT_RxFlag;
+}
 
-    // 更新Mode标志（如果改变）
-    if (last_mode != currentMode) {
-        switch (currentMode) {
-            case MODE_MANUAL:
-                OLED_ShowString(4, 14, "MN");
-                break;
-            case MODE_AUTO:
-                OLED_ShowString(4, 14, "AU");
-                break;
-            case MODE_CYCLE:
-                OLED_ShowString(4, 14, "CY");
-                break;
-            case MODE_BT:
-                OLED_ShowString(4, 14, "BT");
-                break;
+/**
+ * @brief  界面线程（最低优先级）
+ * @details 每KEY_SCAN_MS扫描一次按键，每DISPLAY_FRAME_MS刷新一帧，
+ *         开启调试串口时每DEBUG_STATS_PERIOD_S秒输出一次统计，并响应串口命令；
+ *         按住按键期间按键扫描会等待释放，显示随之暂停
+ */
+static void Thread_Ui(void)
+{
+    uint32_t wake         = Timer_GetMillis();
+    uint32_t display_next = wake;
+#if SYS_DEBUG_SERIAL
+    uint32_t report_next = wake + DEBUG_STATS_PERIOD_S * 1000;
+#endif
+
+    while (1) {
+        Task_Key();
+        Diag_Update();
+        if (SYS_REACHED(wake, display_next)) {
+            display_next += DISPLAY_FRAME_MS;
+            Task_Display();
         }
-        last_mode = currentMode;
+#if SYS_DEBUG_SERIAL
+        if (SYS_REACHED(wake, report_next)) {
+            report_next += DEBUG_STATS_PERIOD_S * 1000;
+            Task_Report();
+        }
+        Task_Command();
+#endif
+        Os_SleepUntil(&wake, KEY_SCAN_MS);
     }
 }
+
+/**
+ * @brief  启动任务调度
+ * @details 创建各线程并启动内核，不再返回。优先级（数值越小越优先）：
+ *         - 控制：事件、软件定时器和控制逻辑，响应最及时
+ *         - 通信：蓝牙上报
+ *         - 传感器：紫外线和DHT11采样
+ *         - 界面：按键扫描、显示和调试输出
+ *         没有就绪线程时空闲线程调用Idle_Enter休眠
+ * @param  无
+ * @return 无
+ */
+void Sys_StartTasks(void)
+{
+    Os_ThreadCreate(&control_thread, "control", Thread_Control, control_stack, CONTROL_STACK_WORDS, 0);
+    Os_ThreadCreate(&comm_thread, "comm", Thread_Comm, comm_stack, COMM_STACK_WORDS, 1);
+    Os_ThreadCreate(&sensor_thread, "sensor", Thread_Sensor, sensor_stack, SENSOR_STACK_WORDS, 2);
+    Os_ThreadCreate(&ui_thread, "ui", Thread_Ui, ui_stack, UI_STACK_WORDS, 3);
+
+    Diag_Init(); // 填充主栈，此后主栈只供中断使用
+    Os_Start(Idle_Enter);
+}
@@ -22,18 +22,90 @@
 #include "Buzzer.h"
 #include "Delay.h"
 #include "DHT11.h"
+#include "Diag.h"
+#include "Display.h"
+#include "Event.h"
 #include "fan.h"
+#include "Idle.h"
 #include "Key.h"
 #include "LED.h"
+#include "Monitor.h"
 #include "Motor.h"
 #include "OLED.h"
+#include "Os.h"
+#include "Prof.h"
 #include "PWM.h"
 #include "RED.h"
 #include "SD12.h"
+#include "Sensor.h"
 #include "Serial.h"
 #include "Servo.h"
+#include "SoftTimer.h"
 #include "Timer.h"
 
+/**
+ * @brief 任务周期（毫秒）
+ */
+#ifndef KEY_SCAN_MS
+#define KEY_SCAN_MS 10 /**< 按键扫描 */
+#endif
+#ifndef UV_SAMPLE_MS
+#define UV_SAMPLE_MS 50 /**< 紫外线采样 */
+#endif
+#ifndef CONTROL_PERIOD_MS
+#define CONTROL_PERIOD_MS 100 /**< 自动/循环模式控制逻辑 */
+#endif
+#ifndef DHT11_PERIOD_MS
+#define DHT11_PERIOD_MS 2000 /**< DHT11采样，传感器两次读取至少间隔1s */
+#endif
+#ifndef BT_TELEMETRY_MS
+#define BT_TELEMETRY_MS 100 /**< 蓝牙数据上报 */
+#endif
+#ifndef BT_RX_HOLD_MS
+#define BT_RX_HOLD_MS 1000 /**< 收到蓝牙数据包后界面接收标志保持的时间 */
+#endif
+
+/**
+ * @brief 线程栈大小（字）
+ */
+#ifndef CONTROL_STACK_WORDS
+#define CONTROL_STACK_WORDS 192 /**< 控制线程：事件处理、模式切换与软件定时器回调 */
+#endif
+#ifndef COMM_STACK_WORDS
+#define COMM_STACK_WORDS 192 /**< 通信线程：蓝牙上报与统计格式化（snprintf） */
+#endif
+#ifndef SENSOR_STACK_WORDS
+#define SENSOR_STACK_WORDS 128 /**< 传感器线程：紫外线与DHT11采样 */
+#endif
+#ifndef UI_STACK_WORDS
+#define UI_STACK_WORDS 256 /**< 界面线程：按键、显示与调试输出（printf） */
+#endif
+
+/**
+ * @brief 显示任务参数
+ */
+#ifndef DISPLAY_FRAME_MS
+#define DISPLAY_FRAME_MS 50 /**< 显示帧周期（毫秒），与100ms控制周期相互独立 */
+#endif
+#ifndef DISPLAY_FRAME_BUDGET_US
+#define DISPLAY_FRAME_BUDGET_US 5000 /**< 每帧刷新时间预算（微秒），超出部分顺延到下一帧 */
+#endif
+
+/**
+ * @brief 调试串口统计输出
+ * @note  0：关闭
+ *        1：由Sys_Init初始化USART1，并每DEBUG_STATS_PERIOD_S秒输出一次统计；
+ *           界面线程响应串口命令：s-立即输出统计，c-清除控制周期统计，
+ *           p/r-输出/清除执行时间分析（需开启PROF_ENABLE）；
+ *           USART1的PA9/PA10与矩阵键盘第2、3行复用，开启后这两行按键不可用
+ */
+#ifndef SYS_DEBUG_SERIAL
+#define SYS_DEBUG_SERIAL 0
+#endif
+#ifndef DEBUG_STATS_PERIOD_S
+#define DEBUG_STATS_PERIOD_S 5 /**< 统计输出周期（秒） */
+#endif
+
 /**
  * @brief 系统工作模式枚举
  */
@@ -61,8 +133,46 @@ typedef struct {
     uint8_t temp_deci;    /**< 温度小数部分 */
     uint8_t uvLevel;      /**< 紫外线等级(0-11) */
     uint8_t redValue;     /**< 红外传感器值(0-1) */
+    uint32_t dht11_seq;   /**< DHT11数据序号，0表示尚无有效数据 */
+    uint32_t dht11_age;   /**< DHT11数据年龄（毫秒） */
 } SensorData_t;
 
+/**
+ * @brief 启动阶段
+ * @details 每个阶段结束时记录一次时间戳（自定时器启动起的微秒数）
+ */
+typedef enum {
+    BOOT_STAGE_TIMER = 0,     /**< 时基启动 */
+    BOOT_STAGE_COMM,          /**< 蓝牙串口就绪 */
+    BOOT_STAGE_IO,            /**< 执行器、按键、LED就绪 */
+    BOOT_STAGE_SENSOR,        /**< 传感器就绪（ADC已启动校准） */
+    BOOT_STAGE_OLED,          /**< 屏幕上电等待结束并完成配置 */
+    BOOT_STAGE_FIRST_PACKET,  /**< 第一个蓝牙数据包发出 */
+    BOOT_STAGE_FIRST_FRAME,   /**< 第一帧完整显示到屏幕 */
+    BOOT_STAGE_NUM            /**< 阶段数量 */
+} BootStage_t;
+
+/**
+ * @brief 各启动阶段的时间戳（微秒），由Boot_Mark记录
+ */
+extern uint32_t boot_time_us[BOOT_STAGE_NUM];
+
+/**
+ * @brief 显示任务统计
+ */
+typedef struct {
+    uint32_t frames;       /**< 已执行的帧数 */
+    uint32_t frame_us;     /**< 最近一帧耗时（微秒） */
+    uint32_t frame_max_us; /**< 最大帧耗时（微秒） */
+    uint32_t over_budget;  /**< 预算用完、有脏区顺延的帧数 */
+    uint32_t deferred;     /**< 顺延到下一帧的脏页累计数 */
+} DisplayStats_t;
+
+/**
+ * @brief 显示任务统计，由显示任务维护
+ */
+extern DisplayStats_t display_stats;
+
 /**
  * @brief 按键处理结果结构体
  */
@@ -81,20 +191,55 @@ typedef struct {
     uint8_t fan_flag;   /**< 风扇控制标志 */
     uint8_t motor_flag; /**< 电机控制标志 */
     uint8_t mode_flag;  /**< 模式控制标志 */
+    uint8_t stats_flag; /**< 统计请求标志 */
 } BTStatus_t;
 
+/**
+ * @brief 控制状态快照
+ * @details 由控制线程处理完一批事件后整体发布，其他线程读取一致的副本
+ */
+typedef struct {
+    uint8_t mode;            /**< 工作模式 */
+    uint8_t key_value;       /**< 最近一次按键值 */
+    int8_t bt_status;        /**< 最近一次蓝牙数据包的解析结果 */
+    uint8_t bt_rx_seen;      /**< 是否收到过蓝牙数据包 */
+    uint32_t bt_rx_time;     /**< 最近一次收到蓝牙数据包的时刻（毫秒） */
+    uint8_t red_value;       /**< 红外状态，按事件顺序更新，与控制逻辑看到的一致 */
+    uint8_t fixed_mode;      /**< 温湿度使用固定值 */
+    uint8_t fixed_temp_int;  /**< 固定温度值的整数部分 */
+    uint8_t fixed_temp_deci; /**< 固定温度值的小数部分 */
+    uint8_t fixed_humi_int;  /**< 固定湿度值的整数部分 */
+    uint8_t fixed_humi_deci; /**< 固定湿度值的小数部分 */
+} ControlState_t;
+
 /**
  * @brief  系统初始化
  * @return 无
  */
 void Sys_Init(void);
 
+/**
+ * @brief  记录启动阶段时间戳
+ * @details 每个阶段只记录第一次
+ * @param  Stage 启动阶段
+ * @return 无
+ */
+void Boot_Mark(BootStage_t Stage);
+
 /**
  * @brief  获取所有传感器数据
  * @return SensorData_t 传感器数据结构体
  */
 SensorData_t GetAllSensorData(void);
 
+/**
+ * @brief  获取控制状态快照
+ * @details 以顺序锁复制，不会读到控制线程更新了一半的状态；不能在中断中调用
+ * @param  State 状态副本
+ * @return 无
+ */
+void GetControlState(ControlState_t *State);
+
 /**
  * @brief  处理按键输入
  * @param  currentKeyValue 当前按键值
@@ -104,12 +249,14 @@ KeyStatus_t HandleKeyPress(int currentKeyValue);
 
 /**
  * @brief  处理蓝牙数据
+ * @param  Frame 接收到的一帧
  * @return BTStatus_t 蓝牙处理结果
  */
-BTStatus_t HandleBluetooth(void);
+BTStatus_t HandleBluetooth(const uint8_t *Frame);
 
 /**
- * @brief  更新OLED显示
+ * @brief  更新显示数据
+ * @details 只保存数据，由显示任务按帧率绘制和刷新
  * @param  keyValue     按键值
  * @param  dht11_status DHT11状态
  * @param  humi_int     湿度整数
@@ -118,24 +265,26 @@ BTStatus_t HandleBluetooth(void);
  * @param  temp_deci    温度小数
  * @param  uvLevel      紫外线等级
  * @param  redValue     红外值
- * @param  bt_status    蓝牙状态
+ * @param  bt_rx        蓝牙接收标志
+ * @param  mode         工作模式
  * @return 无
  */
 void OLED_UpdateDisplay(int keyValue, uint8_t dht11_status,
                         uint8_t humi_int, uint8_t humi_deci,
                         uint8_t temp_int, uint8_t temp_deci,
-                        uint8_t uvLevel, uint8_t redValue, int8_t bt_status);
+                        uint8_t uvLevel, uint8_t redValue,
+                        uint8_t bt_rx, uint8_t mode);
 
 /**
- * @brief  处理系统主要任务
- * @details 包含以下功能：
- *         1. 按键输入和传感器数据的处理（100ms周期）
- *         2. 自动模式和循环模式的控制逻辑
- *         3. 蓝牙数据的处理
- *         4. OLED显示的更新
+ * @brief  启动任务调度
+ * @details 创建以下线程并启动抢占式内核，不再返回：
+ *         - 控制：事件处理（红外、蓝牙数据包、按键）、软件定时器、CONTROL_PERIOD_MS控制逻辑
+ *         - 通信：BT_TELEMETRY_MS蓝牙上报
+ *         - 传感器：UV_SAMPLE_MS紫外线采样、DHT11_PERIOD_MS DHT11采样
+ *         - 界面：KEY_SCAN_MS按键扫描、DISPLAY_FRAME_MS显示
  * @param  无
  * @return 无
  */
-void ProcessSystemTasks(void);
+void Sys_StartTasks(void);
 
 #endif /* __DK_C8T6_H */
@@ -1,10 +1,13 @@
 /**
  * @file     Delay.c
  * @brief    系统延时功能实现
- * @details  基于SysTick定时器实现的延时函数，包括：
+ * @details  基于DWT周期计数器实现的延时函数，包括：
+ *          - 周期计数时间戳
  *          - 微秒级延时
  *          - 毫秒级延时
  *          - 秒级延时
+ *          CYCCNT只读不写，延时函数没有共享状态，可在中断中重入；
+ *          SysTick不再被占用
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -13,35 +16,63 @@
 #include "stm32f10x.h"
 #include "dk_C8T6.h"
 
+#define DWT_CTRL            (*(volatile uint32_t *)0xE0001000) /**< DWT控制寄存器 */
+#define DWT_CTRL_CYCCNTENA  (1ul << 0)                         /**< 周期计数器使能位 */
+#define DELAY_CYCLES_PER_MS (DELAY_CPU_MHZ * 1000)             /**< 每毫秒的周期数 */
+
+/**
+ * @brief  延时初始化
+ * @details 1. 置位DEMCR的TRCENA，使能DWT模块
+ *         2. 清零并启动CYCCNT
+ * @param  无
+ * @return 无
+ */
+void Delay_Init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DELAY_CYCCNT = 0;
+    DWT_CTRL |= DWT_CTRL_CYCCNTENA;
+}
+
+/**
+ * @brief  获取周期计数
+ * @param  无
+ * @return uint32_t 周期计数
+ */
+uint32_t Delay_GetCycles(void)
+{
+    return DELAY_CYCCNT;
+}
+
 /**
  * @brief  微秒级延时函数
- * @details 利用SysTick定时器实现延时，计算原理：
- *         - STM32系统主频为72MHz
- *         - SysTick计数器每个计数需要 1/72 微秒
- *         - reload值 = 延时时间(us) * 72
- * @note   由于定时器最大值限制，延时范围：0~233015微秒
- * @param  xus 延时时长，单位：微秒，范围：0~233015
+ * @details 记录起始计数，等待差值达到 us * DELAY_CPU_MHZ 个周期；
+ *         无符号差值在计数器回绕时仍然正确
+ * @param  xus 延时时长，单位：微秒，范围：0~59652323
  * @return 无
  */
 void Delay_us(uint32_t xus)
 {
-    SysTick->LOAD = 72 * xus;              // 设置定时器重装值
-    SysTick->VAL  = 0x00;                  // 清空当前计数值
-    SysTick->CTRL = 0x00000005;            // 设置时钟源为HCLK，启动定时器
-    while (!(SysTick->CTRL & 0x00010000)); // 等待计数到0
-    SysTick->CTRL = 0x00000004;            // 关闭定时器
+    uint32_t start  = DELAY_CYCCNT;
+    uint32_t cycles = xus * DELAY_CPU_MHZ;
+
+    while (DELAY_CYCCNT - start < cycles);
 }
 
 /**
  * @brief  毫秒级延时函数
- * @details 通过调用微秒级延时函数实现，将毫秒转换为微秒
+ * @details 每毫秒的结束时刻在上一毫秒的结束时刻上累加，
+ *         循环本身的开销不会累积，总时长仍为周期精确
  * @param  xms 延时时长，单位：毫秒，范围：0~4294967295
  * @return 无
  */
 void Delay_ms(uint32_t xms)
 {
+    uint32_t start = DELAY_CYCCNT;
+
     while (xms--) {
-        Delay_us(1000);
+        while (DELAY_CYCCNT - start < DELAY_CYCLES_PER_MS);
+        start += DELAY_CYCLES_PER_MS;
     }
 }
 
@@ -2,6 +2,7 @@
  * @file     Delay.h
  * @brief    系统延时功能头文件
  * @details  声明了系统延时相关的函数接口：
+ *          - 周期计数器初始化与时间戳
  *          - 微秒级延时
  *          - 毫秒级延时
  *          - 秒级延时
@@ -13,11 +14,45 @@
 #ifndef __DELAY_H
 #define __DELAY_H
 
+#include <stdint.h>
+
+/**
+ * @brief 内核主频（MHz），即每微秒的周期数
+ */
+#ifndef DELAY_CPU_MHZ
+#define DELAY_CPU_MHZ 72
+#endif
+
+/**
+ * @brief 周期计数器
+ * @details 默认为DWT的CYCCNT寄存器。在主机上编译时可重新定义为模拟时钟，
+ *         例如 -D"DELAY_CYCCNT=(*Host_CycCnt())"，Host_CycCnt每次调用推进模拟时间
+ *         并返回计数变量的地址，从而在主机上运行依赖延时的时序代码，见tests/host/host_clock.h
+ */
+#ifndef DELAY_CYCCNT
+#define DELAY_CYCCNT (*(volatile uint32_t *)0xE0001004)
+#endif
+
+/**
+ * @brief  延时初始化
+ * @details 使能DWT周期计数器，须在使用任何延时函数之前调用
+ * @param  无
+ * @return 无
+ */
+void Delay_Init(void);
+
+/**
+ * @brief  获取周期计数
+ * @details 内核时钟周期数，72MHz下约59.6秒回绕一次，只能用差值测量时间间隔
+ * @param  无
+ * @return uint32_t 周期计数
+ */
+uint32_t Delay_GetCycles(void);
+
 /**
  * @brief  微秒级延时
- * @details 提供最高精度的延时功能，适用于短时间延时场景
- * @note   延时范围受限于SysTick定时器的最大计数值
- * @param  us 延时时长，单位：微秒，范围：0~233015
+ * @details 按周期计数忙等，精度为一个时钟周期，可在中断中调用
+ * @param  us 延时时长，单位：微秒，范围：0~59652323
  * @return 无
  */
 void Delay_us(uint32_t us);
@@ -0,0 +1,120 @@
+/**
+ * @file     Diag.c
+ * @brief    运行诊断
+ * @details  统计可用于评估RAM余量的运行数据：
+ *          - 主栈水位：启动时填充主栈未使用的部分，之后从栈底向上统计仍为填充值的部分；
+ *            线程栈由内核在创建线程时填充，见Os_GetStackFree
+ *          - CPU负载：每个统计周期内非休眠时间的占比，休眠时间由空闲处理累计
+ *          - RAM占用：由链接器生成的符号计算全局变量、主栈和堆的大小
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+#if defined(__CC_ARM)
+/* ARMCC：执行域和启动代码中STACK、HEAP段的链接器符号，主栈和堆位于RW_IRAM1内 */
+extern uint32_t Image$$RW_IRAM1$$Base[];
+extern uint32_t Image$$RW_IRAM1$$ZI$$Limit[];
+extern uint32_t STACK$$Base[];
+extern uint32_t STACK$$Limit[];
+extern uint32_t HEAP$$Base[];
+extern uint32_t HEAP$$Limit[];
+
+#define DIAG_MSP_BASE  STACK$$Base
+#define DIAG_MSP_LIMIT STACK$$Limit
+#define DIAG_HEAP_SIZE ((uint32_t)((uint8_t *)HEAP$$Limit - (uint8_t *)HEAP$$Base))
+#define DIAG_RW_SIZE   ((uint32_t)((uint8_t *)Image$$RW_IRAM1$$ZI$$Limit - (uint8_t *)Image$$RW_IRAM1$$Base))
+#define DIAG_MSP_SIZE  ((uint32_t)((uint8_t *)DIAG_MSP_LIMIT - (uint8_t *)DIAG_MSP_BASE))
+#define DIAG_STATIC_SIZE (DIAG_RW_SIZE - DIAG_MSP_SIZE - DIAG_HEAP_SIZE)
+#else
+/* GCC：ST链接脚本的符号，主栈位于RAM顶端，大小和堆大小为绝对符号 */
+extern uint32_t _sdata[];
+extern uint32_t _ebss[];
+extern uint32_t _estack[];
+extern uint32_t _Min_Stack_Size[];
+extern uint32_t _Min_Heap_Size[];
+
+#define DIAG_MSP_BASE    ((uint32_t *)((uint8_t *)_estack - (uint32_t)(uintptr_t)_Min_Stack_Size))
+#define DIAG_MSP_LIMIT   _estack
+#define DIAG_HEAP_SIZE   ((uint32_t)(uintptr_t)_Min_Heap_Size)
+#define DIAG_MSP_SIZE    ((uint32_t)((uint8_t *)DIAG_MSP_LIMIT - (uint8_t *)DIAG_MSP_BASE))
+#define DIAG_STATIC_SIZE ((uint32_t)((uint8_t *)_ebss - (uint8_t *)_sdata))
+#endif
+
+/**
+ * @brief 填充主栈时在当前栈指针以下保留的字数，留给填充过程本身和期间的中断
+ */
+#define DIAG_MSP_MARGIN_WORDS 16
+
+static uint8_t Diag_CpuLoad   = 0; /**< 最近一个统计周期的CPU负载（%） */
+static uint32_t Diag_LoadTime = 0; /**< 本统计周期开始的时刻（毫秒） */
+
+/**
+ * @brief  运行诊断初始化
+ * @details 只填充当前栈指针以下的部分，正在使用的栈帧不受影响
+ * @param  无
+ * @return 无
+ */
+void Diag_Init(void)
+{
+    uint32_t *p   = DIAG_MSP_BASE;
+    uint32_t *top = (uint32_t *)(uintptr_t)__get_MSP() - DIAG_MSP_MARGIN_WORDS;
+
+    while (p < top) *p++ = OS_STACK_FILL;
+
+    Diag_LoadTime = Timer_GetMillis();
+    Idle_GetResidency(); // 开始新的休眠统计窗口
+}
+
+/**
+ * @brief  更新CPU负载
+ * @param  无
+ * @return 无
+ */
+void Diag_Update(void)
+{
+    uint32_t now = Timer_GetMillis();
+
+    if (now - Diag_LoadTime < DIAG_LOAD_PERIOD_MS) return;
+    Diag_LoadTime = now;
+    Diag_CpuLoad  = 100 - Idle_GetResidency();
+}
+
+/**
+ * @brief  获取CPU负载
+ * @param  无
+ * @return uint8_t CPU负载（%）
+ */
+uint8_t Diag_GetCpuLoad(void)
+{
+    return Diag_CpuLoad;
+}
+
+/**
+ * @brief  获取主栈的剩余量
+ * @param  无
+ * @return uint32_t 从未使用过的主栈（字节）
+ */
+uint32_t Diag_GetMspFree(void)
+{
+    const uint32_t *p = DIAG_MSP_BASE;
+
+    while (p < DIAG_MSP_LIMIT && *p == OS_STACK_FILL) p++;
+    return (uint32_t)((const uint8_t *)p - (const uint8_t *)DIAG_MSP_BASE);
+}
+
+/**
+ * @brief  获取RAM占用
+ * @param  Ram RAM占用
+ * @return 无
+ */
+void Diag_GetRam(DiagRam_t *Ram)
+{
+    Ram->Static = DIAG_STATIC_SIZE;
+    Ram->Msp    = DIAG_MSP_SIZE;
+    Ram->Heap   = DIAG_HEAP_SIZE;
+    Ram->Free   = DIAG_RAM_SIZE - Ram->Static - Ram->Msp - Ram->Heap;
+}
@@ -0,0 +1,82 @@
+/**
+ * @file     Diag.h
+ * @brief    运行诊断头文件
+ * @details  定义了运行诊断相关的：
+ *          - RAM容量与负载统计周期配置
+ *          - RAM占用结构
+ *          - 主栈水位、CPU负载与RAM占用接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __DIAG_H
+#define __DIAG_H
+
+#include <stdint.h>
+
+/**
+ * @brief 片上RAM容量（字节），STM32F103C8T6为20KB
+ */
+#ifndef DIAG_RAM_SIZE
+#define DIAG_RAM_SIZE 0x5000
+#endif
+
+/**
+ * @brief CPU负载统计周期（毫秒）
+ */
+#ifndef DIAG_LOAD_PERIOD_MS
+#define DIAG_LOAD_PERIOD_MS 1000
+#endif
+
+/**
+ * @brief RAM占用（字节）
+ * @details 取自链接器生成的符号，编译后即固定
+ */
+typedef struct {
+    uint32_t Static; /**< 全局和静态变量（含线程栈，不含主栈和堆） */
+    uint32_t Msp;    /**< 主栈，启动代码分配，内核启动后只供中断使用 */
+    uint32_t Heap;   /**< 堆，启动代码分配 */
+    uint32_t Free;   /**< 未分配 */
+} DiagRam_t;
+
+/**
+ * @brief  运行诊断初始化
+ * @details 填充主栈中当前栈指针以下的部分，用于统计主栈的最大使用量；
+ *         须在主栈上调用，即在Os_Start之前
+ * @param  无
+ * @return 无
+ */
+void Diag_Init(void);
+
+/**
+ * @brief  更新CPU负载
+ * @details 由空闲休眠占比换算，每DIAG_LOAD_PERIOD_MS计算一次，未到周期时直接返回
+ * @param  无
+ * @return 无
+ */
+void Diag_Update(void);
+
+/**
+ * @brief  获取CPU负载
+ * @param  无
+ * @return uint8_t 最近一个统计周期的CPU负载（0~100%）
+ */
+uint8_t Diag_GetCpuLoad(void);
+
+/**
+ * @brief  获取主栈的剩余量
+ * @details 从栈底向上统计仍为填充值的字节数
+ * @param  无
+ * @return uint32_t 从未使用过的主栈（字节）
+ */
+uint32_t Diag_GetMspFree(void);
+
+/**
+ * @brief  获取RAM占用
+ * @param  Ram RAM占用
+ * @return 无
+ */
+void Diag_GetRam(DiagRam_t *Ram);
+
+#endif /* __DIAG_H */
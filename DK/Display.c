@@ -0,0 +1,392 @@
+/**
+ * @file     Display.c
+ * @brief    OLED界面布局
+ * @details  以表格方式描述各个页面：
+ *          - 静态标签表：首帧绘制一次
+ *          - 字段表：位置、宽度、数据来源、格式化函数
+ *          - 通用渲染器：比较字段值，只重绘变化的字段
+ *          新增字段只需在字段表中增加一行，无需新的缓存变量
+ *          趋势页以环形缓冲保存最近的采样，按列扫描绘制：
+ *          每个新采样只重写写入列及其后的光标列，不重绘整幅曲线
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+#include "Display.h"
+
+/**
+ * @brief 静态标签
+ */
+typedef struct {
+    uint8_t Line;     /**< 行号 */
+    uint8_t Column;   /**< 列号 */
+    char *Text;       /**< 标签文本 */
+} DisplayLabel_t;
+
+/**
+ * @brief  数字字段格式化：定长十进制，前补0
+ */
+static void Display_FmtNum(const DisplayField_t *Field, uint32_t Value)
+{
+    OLED_ShowNum(Field->Line, Field->Column, Value, Field->Width);
+}
+
+/**
+ * @brief  定点数字段格式化：整数.小数，宽度含小数点和一位小数
+ */
+static void Display_FmtFixed(const DisplayField_t *Field, uint32_t Value)
+{
+    OLED_ShowFixedNum(Field->Line, Field->Column, Value >> 8, Value & 0xFF, Field->Width - 2);
+}
+
+/**
+ * @brief  文本字段格式化：以字段值为下标查文本表
+ */
+static void Display_FmtText(const DisplayField_t *Field, uint32_t Value)
+{
+    OLED_ShowString(Field->Line, Field->Column, (char *)Field->Texts[Value]);
+}
+
+static const char *const Display_TextYN[]   = {"N", "Y"};
+static const char *const Display_TextDHT[]  = {"OK ", "ERR"};
+static const char *const Display_TextRx[]   = {" ", "R"};
+static const char *const Display_TextMode[] = {"MN", "AU", "CY", "BT"};
+
+/**
+ * @brief 主界面静态标签
+ */
+static const DisplayLabel_t Display_MainLabels[] = {
+    {1, 1, "K:"},
+    {1, 5, "R:"},
+    {1, 9, "D:"},
+    {2, 1, "hm:"},
+    {2, 8, "%"},
+    {3, 1, "T:"},
+    {3, 7, "C UV:"},
+    {4, 1, "T:"},
+    {4, 7, "s"},
+    {4, 9, "B:"},
+    {4, 12, "M:"},
+};
+
+/**
+ * @brief 主界面字段
+ */
+static const DisplayField_t Display_MainFields[] = {
+    {1, 3, 2, DISPLAY_SRC(keyValue), Display_FmtNum, 0},                 // K:##
+    {1, 7, 1, DISPLAY_SRC(redValue), Display_FmtText, Display_TextYN},   // R:Y/N
+    {1, 10, 3, DISPLAY_SRC(dht11_err), Display_FmtText, Display_TextDHT}, // D:OK/ERR
+    {2, 4, 4, DISPLAY_SRC(humi), Display_FmtFixed, 0},                   // hm:##.#%
+    {3, 3, 4, DISPLAY_SRC(temp), Display_FmtFixed, 0},                   // T:##.#C
+    {3, 12, 2, DISPLAY_SRC(uvLevel), Display_FmtNum, 0},                 // UV:##
+    {4, 3, 4, DISPLAY_SRC(runtime_s), Display_FmtNum, 0},                // T:####s
+    {4, 11, 1, DISPLAY_SRC(bt_rx), Display_FmtText, Display_TextRx},     // B:R
+    {4, 14, 2, DISPLAY_SRC(mode), Display_FmtText, Display_TextMode},    // M:MN/AU/CY/BT
+};
+
+/**
+ * @brief 趋势页静态标签
+ */
+static const DisplayLabel_t Display_TrendLabels[] = {
+    {1, 1, "T"},
+    {1, 6, "H"},
+    {1, 11, "UV"},
+};
+
+/**
+ * @brief 趋势页字段：标题行显示当前值，曲线自上而下依次为温度、湿度、紫外线
+ */
+static const DisplayField_t Display_TrendFields[] = {
+    {1, 2, 4, DISPLAY_SRC(temp), Display_FmtFixed, 0},   // T##.#
+    {1, 7, 4, DISPLAY_SRC(humi), Display_FmtFixed, 0},   // H##.#
+    {1, 13, 2, DISPLAY_SRC(uvLevel), Display_FmtNum, 0}, // UV##
+};
+
+/**
+ * @brief 诊断页静态标签：CT/CM/SN/UI/ID为各线程，MS为主栈
+ */
+static const DisplayLabel_t Display_DiagLabels[] = {
+    {1, 1, "CPU:"},
+    {1, 8, "% S:"},
+    {2, 1, "CT:"},
+    {2, 9, "CM:"},
+    {3, 1, "SN:"},
+    {3, 9, "UI:"},
+    {4, 1, "ID:"},
+    {4, 9, "MS:"},
+};
+
+/**
+ * @brief 诊断页字段：栈为从未使用过的字节数
+ */
+static const DisplayField_t Display_DiagFields[] = {
+    {1, 5, 3, DISPLAY_SRC(cpu_load), Display_FmtNum, 0},       // CPU:###%
+    {1, 12, 5, DISPLAY_SRC(ram_static), Display_FmtNum, 0},    // S:#####
+    {2, 4, 4, DISPLAY_SRC(stack_control), Display_FmtNum, 0},  // CT:####
+    {2, 12, 4, DISPLAY_SRC(stack_comm), Display_FmtNum, 0},    // CM:####
+    {3, 4, 4, DISPLAY_SRC(stack_sensor), Display_FmtNum, 0},   // SN:####
+    {3, 12, 4, DISPLAY_SRC(stack_ui), Display_FmtNum, 0},      // UI:####
+    {4, 4, 4, DISPLAY_SRC(stack_idle), Display_FmtNum, 0},     // ID:####
+    {4, 12, 4, DISPLAY_SRC(stack_msp), Display_FmtNum, 0},     // MS:####
+};
+
+#define DISPLAY_ARRAY_NUM(a) (sizeof(a) / sizeof((a)[0]))
+#define DISPLAY_MAX(a, b)    ((a) > (b) ? (a) : (b))
+
+/**
+ * @brief 各页面字段数的最大值，字段缓存按此分配；增加页面时须同时加入这里
+ */
+#define DISPLAY_FIELD_MAX                                                                     \
+    DISPLAY_MAX(DISPLAY_MAX(DISPLAY_ARRAY_NUM(Display_MainFields),                           \
+                            DISPLAY_ARRAY_NUM(Display_TrendFields)),                         \
+                DISPLAY_ARRAY_NUM(Display_DiagFields))
+
+/**
+ * @brief 页面描述
+ */
+typedef struct {
+    const DisplayLabel_t *Labels; /**< 静态标签表 */
+    uint8_t LabelNum;             /**< 标签数量 */
+    const DisplayField_t *Fields; /**< 字段表 */
+    uint8_t FieldNum;             /**< 字段数量 */
+    void (*Draw)(void);           /**< 首帧附加绘制（可为0） */
+} DisplayPageDesc_t;
+
+static void Display_TrendDraw(void);
+
+static const DisplayPageDesc_t Display_Pages[DISPLAY_PAGE_NUM] = {
+    {Display_MainLabels, DISPLAY_ARRAY_NUM(Display_MainLabels),
+     Display_MainFields, DISPLAY_ARRAY_NUM(Display_MainFields), 0},
+    {Display_TrendLabels, DISPLAY_ARRAY_NUM(Display_TrendLabels),
+     Display_TrendFields, DISPLAY_ARRAY_NUM(Display_TrendFields), Display_TrendDraw},
+    {Display_DiagLabels, DISPLAY_ARRAY_NUM(Display_DiagLabels),
+     Display_DiagFields, DISPLAY_ARRAY_NUM(Display_DiagFields), 0},
+};
+
+/**
+ * @brief 字段缓存：当前页面每个字段上次绘制的值（按字段最多的页面分配）
+ */
+static uint32_t Display_Cache[DISPLAY_FIELD_MAX];
+static uint8_t Display_Drawn      = 0;                 /**< 0表示下一帧需要全部重绘 */
+static DisplayPage_t Display_Page = DISPLAY_PAGE_MAIN; /**< 当前页面 */
+
+/**
+ * @brief 趋势图参数
+ */
+#define DISPLAY_TREND_LEN    128 /**< 采样点数，等于屏幕列数，必须为2的幂 */
+#define DISPLAY_TREND_HEIGHT 16  /**< 每条曲线高度（像素），占两页 */
+#define DISPLAY_TREND_SCALE(max) ((uint16_t)(((DISPLAY_TREND_HEIGHT - 1) * 256 + (max) - 1) / (max)))
+
+/**
+ * @brief 趋势曲线描述
+ */
+typedef struct {
+    uint8_t Page;   /**< 曲线所在的起始页，占Page和Page+1两页 */
+    uint16_t Scale; /**< 高度 = (值 * Scale) >> 8，超出量程时限幅 */
+} DisplayTrace_t;
+
+static const DisplayTrace_t Display_Traces[] = {
+    {2, DISPLAY_TREND_SCALE(50)},  // 温度，0~50℃（DHT11量程）
+    {4, DISPLAY_TREND_SCALE(100)}, // 湿度，0~100%
+    {6, DISPLAY_TREND_SCALE(11)},  // 紫外线等级，0~11
+};
+
+#define DISPLAY_TRACE_NUM DISPLAY_ARRAY_NUM(Display_Traces)
+
+/**
+ * @brief 趋势环形缓冲：保存换算后的高度，下标即屏幕列号
+ */
+static uint8_t Display_TrendBuf[DISPLAY_TRACE_NUM][DISPLAY_TREND_LEN];
+static uint8_t Display_TrendHead  = 0; /**< 下一个采样的写入位置，也是光标（空白）列 */
+static uint8_t Display_TrendCount = 0; /**< 有效采样数 */
+static uint32_t Display_TrendTime = 0; /**< 上次采样时间（秒） */
+
+/**
+ * @brief  读取字段来源值
+ * @param  Data 显示数据
+ * @param  Field 字段描述
+ * @return uint32_t 字段值
+ */
+static uint32_t Display_ReadSource(const DisplayData_t *Data, const DisplayField_t *Field)
+{
+    const uint8_t *p = (const uint8_t *)Data + Field->Offset;
+
+    switch (Field->Size) {
+        case 1:
+            return *p;
+        case 2:
+            return *(const uint16_t *)p;
+        default:
+            return *(const uint32_t *)p;
+    }
+}
+
+/**
+ * @brief  绘制趋势图的一列
+ * @details 每条曲线在该列画出从上一采样到本采样的竖线，使曲线连续；
+ *         光标列和尚无数据的列画为空白
+ * @param  X 列号，范围0~127
+ * @return 无
+ */
+static void Display_TrendColumn(uint8_t X)
+{
+    uint8_t t, cur, prev, lo, hi;
+    uint8_t prevX = (X - 1) & (DISPLAY_TREND_LEN - 1);
+    uint16_t mask;
+    uint8_t valid = (X != Display_TrendHead) &&
+                    (Display_TrendCount == DISPLAY_TREND_LEN || X < Display_TrendCount);
+    uint8_t joined = valid && prevX != Display_TrendHead &&
+                     (Display_TrendCount == DISPLAY_TREND_LEN || X > 0);
+
+    for (t = 0; t < DISPLAY_TRACE_NUM; t++) {
+        mask = 0;
+        if (valid) {
+            cur  = Display_TrendBuf[t][X];
+            prev = joined ? Display_TrendBuf[t][prevX] : cur;
+            lo   = (cur < prev) ? cur : prev;
+            hi   = (cur < prev) ? prev : cur;
+            // 高度0在底部：行号 = 15 - 高度，覆盖[15-hi, 15-lo]行
+            mask = (uint16_t)((1UL << (DISPLAY_TREND_HEIGHT - lo)) - (1UL << (DISPLAY_TREND_HEIGHT - 1 - hi)));
+        }
+        OLED_DrawColumn(Display_Traces[t].Page, X, mask & 0xFF);
+        OLED_DrawColumn(Display_Traces[t].Page + 1, X, mask >> 8);
+    }
+}
+
+/**
+ * @brief  完整绘制趋势图（进入趋势页时调用一次）
+ * @param  无
+ * @return 无
+ */
+static void Display_TrendDraw(void)
+{
+    uint8_t x = 0;
+
+    do {
+        Display_TrendColumn(x);
+    } while (++x < DISPLAY_TREND_LEN);
+}
+
+/**
+ * @brief  记录趋势采样
+ * @details 每DISPLAY_TREND_PERIOD_S秒记录一次温度、湿度和紫外线等级。
+ *         在趋势页时只更新三列：新采样列、其后的光标列，
+ *         以及光标后的列（最旧的采样不再与被擦除的列相连）
+ * @param  Data 显示数据
+ * @return 无
+ */
+static void Display_TrendSample(const DisplayData_t *Data)
+{
+    uint8_t t, x;
+    uint32_t value[DISPLAY_TRACE_NUM];
+    uint32_t height;
+
+    if (Data->runtime_s - Display_TrendTime < DISPLAY_TREND_PERIOD_S) return;
+    Display_TrendTime = Data->runtime_s;
+
+    value[0] = Data->temp >> 8;
+    value[1] = Data->humi >> 8;
+    value[2] = Data->uvLevel;
+
+    x = Display_TrendHead;
+    for (t = 0; t < DISPLAY_TRACE_NUM; t++) {
+        height = (value[t] * Display_Traces[t].Scale) >> 8;
+        Display_TrendBuf[t][x] = (height >= DISPLAY_TREND_HEIGHT) ? DISPLAY_TREND_HEIGHT - 1 : height;
+    }
+    Display_TrendHead = (x + 1) & (DISPLAY_TREND_LEN - 1);
+    if (Display_TrendCount < DISPLAY_TREND_LEN) Display_TrendCount++;
+
+    if (Display_Page == DISPLAY_PAGE_TREND) {
+        Display_TrendColumn(x);
+        Display_TrendColumn(Display_TrendHead);
+        Display_TrendColumn((Display_TrendHead + 1) & (DISPLAY_TREND_LEN - 1));
+    }
+}
+
+/**
+ * @brief  重置界面
+ * @details 回到主界面并清除字段缓存，下一次渲染时重绘全部标签和字段
+ * @param  无
+ * @return 无
+ */
+void Display_Init(void)
+{
+    Display_Page  = DISPLAY_PAGE_MAIN;
+    Display_Drawn = 0;
+}
+
+/**
+ * @brief  切换到指定页面
+ * @details 清空显存，下一次渲染时完整绘制新页面；
+ *         只能在调用Display_Render的线程（界面线程）中调用
+ * @param  Page 页面编号
+ * @return 无
+ */
+void Display_SetPage(DisplayPage_t Page)
+{
+    if (Page >= DISPLAY_PAGE_NUM) return;
+
+    Display_Page  = Page;
+    Display_Drawn = 0;
+    OLED_Clear();
+}
+
+/**
+ * @brief  切换到下一个页面（循环）
+ * @param  无
+ * @return 无
+ */
+void Display_NextPage(void)
+{
+    Display_SetPage((Display_Page + 1 < DISPLAY_PAGE_NUM) ? (DisplayPage_t)(Display_Page + 1) : DISPLAY_PAGE_MAIN);
+}
+
+/**
+ * @brief  获取当前页面
+ * @param  无
+ * @return DisplayPage_t 当前页面编号
+ */
+DisplayPage_t Display_GetPage(void)
+{
+    return Display_Page;
+}
+
+/**
+ * @brief  渲染当前页面
+ * @details 渲染过程：
+ *         1. 记录趋势采样（趋势页时增量绘制曲线）
+ *         2. 首帧绘制全部静态标签及页面附加图形
+ *         3. 遍历字段表，读取来源值
+ *         4. 与缓存比较，变化（或首帧）时调用格式化函数重绘并更新缓存
+ * @note   只写入显存，由调用者在帧结束时调用OLED_Update
+ * @param  Data 显示数据
+ * @return 无
+ */
+void Display_Render(const DisplayData_t *Data)
+{
+    const DisplayPageDesc_t *page = &Display_Pages[Display_Page];
+    uint8_t i;
+    uint32_t value;
+
+    Display_TrendSample(Data);
+
+    if (!Display_Drawn) {
+        for (i = 0; i < page->LabelNum; i++) {
+            OLED_ShowString(page->Labels[i].Line, page->Labels[i].Column, page->Labels[i].Text);
+        }
+        if (page->Draw) page->Draw();
+    }
+
+    for (i = 0; i < page->FieldNum; i++) {
+        value = Display_ReadSource(Data, &page->Fields[i]);
+        if (!Display_Drawn || value != Display_Cache[i]) {
+            page->Fields[i].Format(&page->Fields[i], value);
+            Display_Cache[i] = value;
+        }
+    }
+
+    Display_Drawn = 1;
+}
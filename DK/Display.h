@@ -0,0 +1,125 @@
+/**
+ * @file     Display.h
+ * @brief    OLED界面布局头文件
+ * @details  定义了界面相关的：
+ *          - 显示数据结构
+ *          - 字段描述结构
+ *          - 页面编号与趋势图参数
+ *          - 渲染函数接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __DISPLAY_H
+#define __DISPLAY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/**
+ * @brief 显示页面编号
+ */
+typedef enum {
+    DISPLAY_PAGE_MAIN = 0, /**< 主界面：各项状态 */
+    DISPLAY_PAGE_TREND,    /**< 趋势页：温度、湿度、紫外线曲线 */
+    DISPLAY_PAGE_DIAG,     /**< 诊断页：CPU负载、RAM占用、各栈剩余量 */
+    DISPLAY_PAGE_NUM       /**< 页面数量 */
+} DisplayPage_t;
+
+/**
+ * @brief 趋势图采样周期（秒），屏幕宽128列，即显示最近约128个周期的数据
+ */
+#ifndef DISPLAY_TREND_PERIOD_S
+#define DISPLAY_TREND_PERIOD_S 1
+#endif
+
+/**
+ * @brief 将整数/小数两部分打包为一个定点值，供定点数字段使用
+ */
+#define DISPLAY_FIXED(i, d) ((uint16_t)(((uint16_t)(i) << 8) | (uint8_t)(d)))
+
+/**
+ * @brief 界面显示数据
+ * @details 渲染器只从这里读取字段值，每帧由调用者填充
+ */
+typedef struct {
+    uint8_t keyValue;   /**< 按键值 */
+    uint8_t redValue;   /**< 红外状态：0-N，1-Y */
+    uint8_t dht11_err;  /**< DHT11状态：0-OK，1-ERR */
+    uint8_t uvLevel;    /**< 紫外线等级 */
+    uint16_t humi;      /**< 湿度，DISPLAY_FIXED打包 */
+    uint16_t temp;      /**< 温度，DISPLAY_FIXED打包 */
+    uint8_t bt_rx;      /**< 蓝牙接收标志 */
+    uint8_t mode;       /**< 工作模式 */
+    uint32_t runtime_s; /**< 运行时间（秒） */
+    uint8_t cpu_load;       /**< CPU负载（%），仅诊断页 */
+    uint16_t ram_static;    /**< 全局和静态变量占用（字节），仅诊断页 */
+    uint16_t stack_control; /**< 控制线程栈剩余（字节），仅诊断页 */
+    uint16_t stack_comm;    /**< 通信线程栈剩余（字节），仅诊断页 */
+    uint16_t stack_sensor;  /**< 传感器线程栈剩余（字节），仅诊断页 */
+    uint16_t stack_ui;      /**< 界面线程栈剩余（字节），仅诊断页 */
+    uint16_t stack_idle;    /**< 空闲线程栈剩余（字节），仅诊断页 */
+    uint16_t stack_msp;     /**< 主栈剩余（字节），仅诊断页 */
+} DisplayData_t;
+
+/**
+ * @brief 字段描述
+ * @details 每个字段声明位置、宽度、数据来源和格式化函数，
+ *         渲染器比较来源值与缓存值，只重绘发生变化的字段
+ */
+typedef struct DisplayField {
+    uint8_t Line;              /**< 行号，范围1~4 */
+    uint8_t Column;            /**< 列号，范围1~16 */
+    uint8_t Width;             /**< 显示宽度（字符数） */
+    uint8_t Size;              /**< 来源成员大小：1/2/4字节 */
+    uint16_t Offset;           /**< 来源成员在DisplayData_t中的偏移 */
+    void (*Format)(const struct DisplayField *Field, uint32_t Value); /**< 格式化函数 */
+    const char *const *Texts;  /**< 文本表（仅文本字段使用） */
+} DisplayField_t;
+
+/**
+ * @brief 声明字段来源：DisplayData_t中的成员名
+ */
+#define DISPLAY_SRC(member) sizeof(((DisplayData_t *)0)->member), offsetof(DisplayData_t, member)
+
+/**
+ * @brief  重置界面
+ * @details 清除字段缓存，下一次渲染时重绘全部标签和字段
+ * @param  无
+ * @return 无
+ */
+void Display_Init(void);
+
+/**
+ * @brief  渲染当前页面
+ * @details 记录趋势采样，并只把发生变化的字段写入显存，不负责刷新屏幕
+ * @param  Data 显示数据
+ * @return 无
+ */
+void Display_Render(const DisplayData_t *Data);
+
+/**
+ * @brief  切换到指定页面
+ * @details 清空显存，下一次渲染时完整绘制新页面；
+ *         只能在调用Display_Render的线程（界面线程）中调用
+ * @param  Page 页面编号
+ * @return 无
+ */
+void Display_SetPage(DisplayPage_t Page);
+
+/**
+ * @brief  切换到下一个页面（循环）
+ * @param  无
+ * @return 无
+ */
+void Display_NextPage(void);
+
+/**
+ * @brief  获取当前页面
+ * @param  无
+ * @return DisplayPage_t 当前页面编号
+ */
+DisplayPage_t Display_GetPage(void);
+
+#endif /* __DISPLAY_H */
@@ -0,0 +1,161 @@
+/**
+ * @file     Event.c
+ * @brief    事件队列
+ * @details  中断、线程与控制线程之间传递事件：
+ *          - 每个生产者上下文一个单生产者/单消费者无锁队列，无需关中断
+ *          - 事件带类型和产生时刻，连续到来的事件不会相互覆盖
+ *          - 读取时按产生时刻合并各队列，保持事件的先后顺序
+ *          - 投递后释放信号量，唤醒等待事件的线程
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+#define EVENT_QUEUE_MASK (EVENT_QUEUE_SIZE - 1)
+
+/**
+ * @brief 内存屏障
+ * @details 同时阻止编译器和处理器重排访存，保证高优化等级下事件内容先于下标可见。
+ *         主机测试中重新定义为模拟抢占点，在屏障处插入中断或高优先级线程
+ */
+#ifndef EVENT_BARRIER
+#define EVENT_BARRIER() __DMB()
+#endif
+
+static EventQueue_t Event_IsrQueue;    /**< 中断投递的事件 */
+static EventQueue_t Event_ThreadQueue; /**< 线程投递的事件 */
+
+OsSem_t Event_Sem = {0, 1}; /**< 有事件待处理 */
+
+/**
+ * @brief  写入一个事件
+ * @details 1. 队列已满则丢弃并计数
+ *         2. 写入事件内容
+ *         3. 屏障后发布新的Head
+ * @param  Queue 队列
+ * @param  Event 事件
+ * @return uint8_t 1-成功，0-队列已满，事件被丢弃
+ */
+uint8_t EventQueue_Push(EventQueue_t *Queue, const Event_t *Event)
+{
+    uint8_t head = Queue->Head;
+
+    if ((uint8_t)(head - Queue->Tail) >= EVENT_QUEUE_SIZE) {
+        Queue->Dropped++;
+        return 0;
+    }
+
+    Queue->Buf[head & EVENT_QUEUE_MASK] = *Event;
+    EVENT_BARRIER();
+    Queue->Head = head + 1;
+    return 1;
+}
+
+/**
+ * @brief  读出一个事件
+ * @details 1. 队列为空则返回
+ *         2. 屏障后读出事件内容，保证读到的是生产者发布Head之前写入的内容
+ *         3. 屏障后发布新的Tail，之后该位置才允许被生产者覆盖
+ * @param  Queue 队列
+ * @param  Event 读出的事件
+ * @return uint8_t 1-成功，0-队列为空
+ */
+uint8_t EventQueue_Pop(EventQueue_t *Queue, Event_t *Event)
+{
+    uint8_t tail = Queue->Tail;
+
+    if (tail == Queue->Head) return 0;
+
+    EVENT_BARRIER();
+    *Event = Queue->Buf[tail & EVENT_QUEUE_MASK];
+    EVENT_BARRIER();
+    Queue->Tail = tail + 1;
+    return 1;
+}
+
+/**
+ * @brief  填写事件并写入队列
+ * @param  Queue 队列
+ * @param  Type 事件类型
+ * @param  Data 事件参数
+ * @param  Len 参数长度
+ * @return 无
+ */
+static void Event_Put(EventQueue_t *Queue, EventType_t Type, const uint8_t *Data, uint8_t Len)
+{
+    Event_t event;
+    uint8_t i;
+
+    event.Time = Timer_GetMillis();
+    event.Type = Type;
+    for (i = 0; i < sizeof(event.Data); i++) {
+        event.Data[i] = (i < Len) ? Data[i] : 0;
+    }
+
+    if (EventQueue_Push(Queue, &event)) {
+        Os_SemGive(&Event_Sem);
+    }
+}
+
+/**
+ * @brief  从中断中投递事件
+ * @param  Type 事件类型
+ * @param  Data 事件参数
+ * @param  Len 参数长度（不超过4）
+ * @return 无
+ */
+void Event_PostFromISR(EventType_t Type, const uint8_t *Data, uint8_t Len)
+{
+    Event_Put(&Event_IsrQueue, Type, Data, Len);
+}
+
+/**
+ * @brief  从线程中投递事件
+ * @param  Type 事件类型
+ * @param  Data 事件参数
+ * @param  Len 参数长度（不超过4）
+ * @return 无
+ */
+void Event_Post(EventType_t Type, const uint8_t *Data, uint8_t Len)
+{
+    Event_Put(&Event_ThreadQueue, Type, Data, Len);
+}
+
+/**
+ * @brief  读取最早的一个事件
+ * @details 比较两个队列队首事件的产生时刻，先读出较早的一个；
+ *         时刻相同时中断事件优先
+ * @param  Event 读出的事件
+ * @return uint8_t 1-成功，0-没有事件
+ */
+uint8_t Event_Get(Event_t *Event)
+{
+    EventQueue_t *irq_q  = &Event_IsrQueue;
+    EventQueue_t *thr_q  = &Event_ThreadQueue;
+    uint8_t irq_tail;
+
+    if (thr_q->Tail == thr_q->Head) return EventQueue_Pop(irq_q, Event);
+
+    irq_tail = irq_q->Tail;
+    if (irq_tail != irq_q->Head) {
+        EVENT_BARRIER();
+        if ((int32_t)(irq_q->Buf[irq_tail & EVENT_QUEUE_MASK].Time -
+                      thr_q->Buf[thr_q->Tail & EVENT_QUEUE_MASK].Time) <= 0) {
+            return EventQueue_Pop(irq_q, Event);
+        }
+    }
+    return EventQueue_Pop(thr_q, Event);
+}
+
+/**
+ * @brief  获取丢弃的事件总数
+ * @param  无
+ * @return uint32_t 丢弃的事件数
+ */
+uint32_t Event_GetDropped(void)
+{
+    return Event_IsrQueue.Dropped + Event_ThreadQueue.Dropped;
+}
@@ -0,0 +1,116 @@
+/**
+ * @file     Event.h
+ * @brief    事件队列头文件
+ * @details  定义了事件相关的：
+ *          - 事件类型与事件结构
+ *          - 单生产者/单消费者无锁队列
+ *          - 投递与读取接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __EVENT_H
+#define __EVENT_H
+
+#include <stdint.h>
+#include "Os.h"
+
+/**
+ * @brief 每个队列的容量，须为2的幂且不大于128
+ */
+#ifndef EVENT_QUEUE_SIZE
+#define EVENT_QUEUE_SIZE 16
+#endif
+
+/**
+ * @brief 事件类型
+ */
+typedef enum {
+    EVENT_NONE = 0, /**< 无事件 */
+    EVENT_PIR,      /**< 红外电平变化，Data[0]：1-检测到障碍物，0-离开 */
+    EVENT_BT_FRAME, /**< 蓝牙收到一帧，Data[0~3]：帧头、标志位、校验和、帧尾 */
+    EVENT_KEY       /**< 按键，Data[0]：键值（长按带KEY_LONG_FLAG） */
+} EventType_t;
+
+/**
+ * @brief 事件
+ */
+typedef struct {
+    uint32_t Time;   /**< 产生时刻（毫秒） */
+    uint8_t Type;    /**< 事件类型，见EventType_t */
+    uint8_t Data[4]; /**< 事件参数 */
+} Event_t;
+
+/**
+ * @brief 单生产者/单消费者无锁队列
+ * @details Head只由生产者修改，Tail只由消费者修改，两者自由递增，
+ *         差值即为队列中的事件数。生产者先写入事件再发布Head，
+ *         消费者先读出事件再发布Tail，中间以内存屏障分隔
+ */
+typedef struct {
+    Event_t Buf[EVENT_QUEUE_SIZE]; /**< 事件缓冲 */
+    volatile uint8_t Head;         /**< 写位置 */
+    volatile uint8_t Tail;         /**< 读位置 */
+    volatile uint32_t Dropped;     /**< 队列满时丢弃的事件数（生产者维护） */
+} EventQueue_t;
+
+/**
+ * @brief 有事件待处理信号量（二值）
+ * @details 投递事件后释放；消费者线程在此等待，醒来后读空所有队列
+ */
+extern OsSem_t Event_Sem;
+
+/**
+ * @brief  写入一个事件（生产者调用）
+ * @param  Queue 队列
+ * @param  Event 事件
+ * @return uint8_t 1-成功，0-队列已满，事件被丢弃
+ */
+uint8_t EventQueue_Push(EventQueue_t *Queue, const Event_t *Event);
+
+/**
+ * @brief  读出一个事件（消费者调用）
+ * @param  Queue 队列
+ * @param  Event 读出的事件
+ * @return uint8_t 1-成功，0-队列为空
+ */
+uint8_t EventQueue_Pop(EventQueue_t *Queue, Event_t *Event);
+
+/**
+ * @brief  从中断中投递事件
+ * @details 所有调用者须处于相同的抢占优先级（当前为1：红外EXTI和蓝牙USART2），
+ *         彼此不会嵌套，对队列而言是同一个生产者
+ * @param  Type 事件类型
+ * @param  Data 事件参数
+ * @param  Len 参数长度（不超过4）
+ * @return 无
+ */
+void Event_PostFromISR(EventType_t Type, const uint8_t *Data, uint8_t Len);
+
+/**
+ * @brief  从线程中投递事件
+ * @details 对队列而言只能有一个生产者线程（当前为界面线程的按键扫描）
+ * @param  Type 事件类型
+ * @param  Data 事件参数
+ * @param  Len 参数长度（不超过4）
+ * @return 无
+ */
+void Event_Post(EventType_t Type, const uint8_t *Data, uint8_t Len);
+
+/**
+ * @brief  读取最早的一个事件
+ * @details 在中断队列和线程队列之间按产生时刻先后读取，只能在消费者线程中调用
+ * @param  Event 读出的事件
+ * @return uint8_t 1-成功，0-没有事件
+ */
+uint8_t Event_Get(Event_t *Event);
+
+/**
+ * @brief  获取丢弃的事件总数
+ * @param  无
+ * @return uint32_t 丢弃的事件数
+ */
+uint32_t Event_GetDropped(void);
+
+#endif /* __EVENT_H */
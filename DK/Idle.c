@@ -0,0 +1,261 @@
+/**
+ * @file     Idle.c
+ * @brief    空闲休眠
+ * @details  没有就绪线程时让处理器休眠（内核的空闲钩子）：
+ *          - 由内核得到距最早一个线程唤醒的时间
+ *          - 默认进入睡眠模式（WFI），在该时刻由内核的SysTick定时中断唤醒，
+ *            外设中断也会提前唤醒
+ *          - 可选：空闲时间较长时进入停止模式，由RTC闹钟唤醒，
+ *            唤醒后恢复72MHz时钟并按RTC计数补齐TIM4停止期间的时间
+ *          - 统计休眠时间占比，用于观察CPU负载
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+static uint32_t Idle_SleepUs     = 0; /**< 本统计窗口内的休眠时长（微秒） */
+static uint32_t Idle_WindowStart = 0; /**< 统计窗口起点（微秒） */
+static uint32_t Idle_StopCount   = 0; /**< 进入停止模式的次数 */
+static volatile uint8_t Idle_StopLocks = 0; /**< 禁止停止模式的嵌套计数 */
+
+#if IDLE_USE_STOP
+/**
+ * @brief RTC分频值：32768Hz / (31 + 1) = 1024Hz，1024个计数为1000ms
+ */
+#define IDLE_RTC_PRESCALER 31
+
+/**
+ * @brief 单次停止模式的最长时间（毫秒），避免计数换算溢出
+ */
+#define IDLE_STOP_MAX_MS 60000
+
+static uint8_t Idle_RtcReady  = 0; /**< RTC已配置 */
+static uint32_t Idle_RtcFrac  = 0; /**< 换算为毫秒后剩余的RTC计数（单位1/128ms） */
+
+/**
+ * @brief  配置RTC闹钟唤醒
+ * @details LSE起振后调用一次：
+ *         1. 选择LSE作为RTC时钟，分频为1024Hz
+ *         2. 使能闹钟中断，闹钟经EXTI线17唤醒停止模式
+ * @param  无
+ * @return 无
+ */
+static void Idle_RtcConfig(void)
+{
+    EXTI_InitTypeDef EXTI_InitStructure;
+    NVIC_InitTypeDef NVIC_InitStructure;
+
+    /*RTC时钟配置*/
+    RCC_RTCCLKConfig(RCC_RTCCLKSource_LSE);
+    RCC_RTCCLKCmd(ENABLE);
+    RTC_WaitForSynchro();
+    RTC_WaitForLastTask();
+    RTC_SetPrescaler(IDLE_RTC_PRESCALER);
+    RTC_WaitForLastTask();
+    RTC_ITConfig(RTC_IT_ALR, ENABLE);
+    RTC_WaitForLastTask();
+
+    /*EXTI线17：RTC闹钟*/
+    EXTI_ClearITPendingBit(EXTI_Line17);
+    EXTI_InitStructure.EXTI_Line    = EXTI_Line17;
+    EXTI_InitStructure.EXTI_Mode    = EXTI_Mode_Interrupt;
+    EXTI_InitStructure.EXTI_Trigger = EXTI_Trigger_Rising;
+    EXTI_InitStructure.EXTI_LineCmd = ENABLE;
+    EXTI_Init(&EXTI_InitStructure);
+
+    /*NVIC中断优先级配置*/
+    NVIC_InitStructure.NVIC_IRQChannel                   = RTCAlarm_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 2;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 2;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_Init(&NVIC_InitStructure);
+
+    Idle_RtcReady = 1;
+}
+
+/**
+ * @brief  恢复系统时钟
+ * @details 停止模式唤醒后系统时钟为HSI，重新启动HSE和PLL并切换回72MHz，
+ *         PLL倍频等配置在停止模式中保持不变
+ * @param  无
+ * @return 无
+ */
+static void Idle_RestoreClock(void)
+{
+    RCC_HSEConfig(RCC_HSE_ON);
+    if (RCC_WaitForHSEStartUp() == SUCCESS) {
+        RCC_PLLCmd(ENABLE);
+        while (RCC_GetFlagStatus(RCC_FLAG_PLLRDY) == RESET);
+        RCC_SYSCLKConfig(RCC_SYSCLKSource_PLLCLK);
+        while (RCC_GetSYSCLKSource() != 0x08);
+    }
+}
+
+/**
+ * @brief  进入停止模式
+ * @details 须在关中断状态下调用：
+ *         1. 设置RTC闹钟，提前约1ms唤醒，留出恢复时钟的时间
+ *         2. 进入停止模式，闹钟或其他外部中断唤醒
+ *         3. 恢复时钟，按实际经过的RTC计数推进系统时间，不足1ms的部分留到下次
+ * @param  Ms 空闲时间（毫秒）
+ * @return 无
+ */
+static void Idle_EnterStop(uint32_t Ms)
+{
+    uint32_t start, elapsed;
+
+    if (Ms > IDLE_STOP_MAX_MS) Ms = IDLE_STOP_MAX_MS;
+
+    start = RTC_GetCounter();
+    RTC_SetAlarm(start + (Ms - 1) * 128 / 125);
+    RTC_WaitForLastTask();
+
+    PWR_EnterSTOPMode(PWR_Regulator_LowPower, PWR_STOPEntry_WFI);
+
+    Idle_RestoreClock();
+    RTC_WaitForSynchro();
+    elapsed = (RTC_GetCounter() - start) * 125 + Idle_RtcFrac;
+    Idle_RtcFrac = elapsed % 128;
+    Timer_Advance(elapsed / 128);
+    Idle_StopCount++;
+}
+
+/**
+ * @brief  RTC闹钟中断服务函数
+ * @details 只用于唤醒停止模式，清除标志即可
+ * @note   此函数会被硬件自动调用
+ */
+void RTCAlarm_IRQHandler(void)
+{
+    if (RTC_GetITStatus(RTC_IT_ALR) != RESET) {
+        RTC_ClearITPendingBit(RTC_IT_ALR);
+        RTC_WaitForLastTask();
+    }
+    EXTI_ClearITPendingBit(EXTI_Line17);
+}
+#endif
+
+/**
+ * @brief  空闲处理初始化
+ * @details 记录统计窗口起点。使用停止模式时：
+ *         1. 开启PWR、BKP时钟并允许访问后备域
+ *         2. 复位后备域，以便重新选择RTC时钟源
+ *         3. 启动LSE，起振需要数百毫秒，不在此等待
+ * @param  无
+ * @return 无
+ */
+void Idle_Init(void)
+{
+    Idle_WindowStart = Timer_GetMicros();
+
+#if IDLE_USE_STOP
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_PWR | RCC_APB1Periph_BKP, ENABLE);
+    PWR_BackupAccessCmd(ENABLE);
+    RCC_BackupResetCmd(ENABLE);
+    RCC_BackupResetCmd(DISABLE);
+    RCC_LSEConfig(RCC_LSE_ON);
+#endif
+}
+
+/**
+ * @brief  空闲处理
+ * @details 处理过程：
+ *         1. 关中断后向内核查询空闲时间，已有线程就绪则立即返回
+ *         2. 空闲时间足够长、RTC可用且未被禁止时进入停止模式，唤醒后让内核按补齐的时间处理超时；
+ *            否则执行WFI进入睡眠模式，内核已在最早的唤醒时刻设置了SysTick定时
+ *         3. 在关中断状态下累计休眠时间，再开中断，唤醒源的中断在此得到服务，
+ *            有线程就绪时随即切换，切换后的运行时间不计入休眠
+ *         关中断期间到来的中断保持挂起，WFI会立即返回，不会错过事件
+ * @param  无
+ * @return 无
+ */
+void Idle_Enter(void)
+{
+    uint32_t start, idle;
+
+#if IDLE_USE_STOP
+    if (!Idle_RtcReady && RCC_GetFlagStatus(RCC_FLAG_LSERDY) == SET) {
+        Idle_RtcConfig();
+    }
+#endif
+
+    __disable_irq();
+    start = Timer_GetMicros();
+    idle  = Os_GetIdleTime();
+    if (idle == 0) {
+        __enable_irq();
+        return;
+    }
+
+#if IDLE_USE_STOP
+    if (Idle_RtcReady && idle >= IDLE_STOP_MIN_MS && Idle_StopLocks == 0) {
+        Idle_EnterStop(idle);
+        Os_Tick();
+    } else
+#endif
+    {
+        __WFI();
+    }
+    Idle_SleepUs += Timer_GetMicros() - start;
+    __enable_irq();
+}
+
+/**
+ * @brief  禁止进入停止模式
+ * @param  无
+ * @return 无
+ */
+void Idle_StopLock(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    Idle_StopLocks++;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  允许进入停止模式
+ * @param  无
+ * @return 无
+ */
+void Idle_StopUnlock(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    if (Idle_StopLocks) Idle_StopLocks--;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  获取休眠占比
+ * @details 按统计窗口内的休眠时长除以窗口总时长计算，调用后开始新的窗口
+ * @param  无
+ * @return uint8_t 休眠占比（0~100）
+ */
+uint8_t Idle_GetResidency(void)
+{
+    uint32_t now   = Timer_GetMicros();
+    uint32_t total = now - Idle_WindowStart;
+    uint32_t pct   = 0;
+
+    if (total >= 100) {
+        pct = Idle_SleepUs / (total / 100);
+        if (pct > 100) pct = 100;
+    }
+    Idle_WindowStart = now;
+    Idle_SleepUs     = 0;
+    return (uint8_t)pct;
+}
+
+/**
+ * @brief  获取进入停止模式的次数
+ * @param  无
+ * @return uint32_t 停止模式次数
+ */
+uint32_t Idle_GetStopCount(void)
+{
+    return Idle_StopCount;
+}
@@ -0,0 +1,84 @@
+/**
+ * @file     Idle.h
+ * @brief    空闲休眠头文件
+ * @details  定义了空闲处理相关的：
+ *          - 停止模式配置选项
+ *          - 空闲处理与休眠统计接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __IDLE_H
+#define __IDLE_H
+
+#include <stdint.h>
+
+/**
+ * @brief 停止模式开关
+ * @details 0：空闲时只进入睡眠模式（WFI），由内核的SysTick定时或外设中断唤醒；
+ *        1：空闲时间不少于IDLE_STOP_MIN_MS时进入停止模式，由RTC闹钟唤醒。
+ *        停止模式下TIM4、PWM输出、串口接收和ADC后台扫描都会停止，
+ *        只适合执行器全部关闭、不需要蓝牙接收的场合；需要外接32.768kHz晶振
+ */
+#ifndef IDLE_USE_STOP
+#define IDLE_USE_STOP 0
+#endif
+
+/**
+ * @brief 进入停止模式的最短空闲时间（毫秒）
+ * @details 停止模式唤醒后需重新启动HSE和PLL，空闲时间太短时得不偿失
+ */
+#ifndef IDLE_STOP_MIN_MS
+#define IDLE_STOP_MIN_MS 20
+#endif
+
+/**
+ * @brief  空闲处理初始化
+ * @details 开始休眠统计；使用停止模式时启动LSE，起振完成后再配置RTC
+ * @param  无
+ * @return 无
+ */
+void Idle_Init(void);
+
+/**
+ * @brief  空闲处理
+ * @details 作为内核的空闲钩子，没有就绪线程时反复调用，按距最早线程唤醒的时间选择休眠方式
+ * @param  无
+ * @return 无
+ */
+void Idle_Enter(void);
+
+/**
+ * @brief  禁止进入停止模式
+ * @details 可嵌套，可在中断中调用。依赖TIM4时序或外设时钟的异步操作进行期间调用，
+ *         期间空闲时只进入睡眠模式
+ * @param  无
+ * @return 无
+ */
+void Idle_StopLock(void);
+
+/**
+ * @brief  允许进入停止模式
+ * @details 与Idle_StopLock成对调用，可在中断中调用
+ * @param  无
+ * @return 无
+ */
+void Idle_StopUnlock(void);
+
+/**
+ * @brief  获取休眠占比
+ * @details 返回自上次调用以来处于休眠状态的时间百分比，并开始新的统计窗口
+ * @param  无
+ * @return uint8_t 休眠占比（0~100）
+ */
+uint8_t Idle_GetResidency(void);
+
+/**
+ * @brief  获取进入停止模式的次数
+ * @param  无
+ * @return uint32_t 停止模式次数
+ */
+uint32_t Idle_GetStopCount(void);
+
+#endif /* __IDLE_H */
@@ -15,7 +15,6 @@
  */
 
 #include "stm32f10x.h" // STM32F10x外设库头文件
-#include "Delay.h"     // 延时函数
 #include "dk_C8T6.h"   // 项目主头文件
 
 /**
@@ -78,14 +77,17 @@ void Key_Init(void)
  *              [5 ] [6 ] [7 ] [8 ]
  *              [9 ] [10] [11] [12]
  *              [13] [14] [15] [16]
- * @note   此函数为阻塞式操作，会等待按键释放
+ *         3. 等待释放期间计时，按住超过KEY_LONG_PRESS_MS时
+ *            在键码上附加KEY_LONG_FLAG
+ * @note   此函数为阻塞式操作，会等待按键释放；须在线程中调用，消抖和等待期间线程休眠
  * @param  无
- * @return uint8_t 按键键码（0-16）
+ * @return uint8_t 按键键码（0-16，长按时附加KEY_LONG_FLAG）
  */
 uint8_t Key_GetNum(void)
 {
     uint8_t KeyNum = 0;
     uint8_t row, col;
+    uint32_t press, holdTime;
     uint16_t rowPins[4] = {KEY_ROW1_PIN, KEY_ROW2_PIN, KEY_ROW3_PIN, KEY_ROW4_PIN};
     uint16_t colPins[4] = {KEY_COL1_PIN, KEY_COL2_PIN, KEY_COL3_PIN, KEY_COL4_PIN};
 
@@ -107,10 +109,15 @@ uint8_t Key_GetNum(void)
                 // OLED_ShowNum(2, 3, col, 1); // 显示列号
                 // OLED_ShowNum(3, 1, 88, 2);  // 显示一个固定数字，表示进入了按键检测分支
 
-                Delay_ms(20);                                            // 延时消抖
-                while (GPIO_ReadInputDataBit(GPIOB, colPins[col]) == 0); // 等待按键释放
-                Delay_ms(20);                                            // 延时消抖
-                KeyNum = (3 - col) * 4 + (3 - row) + 1;                  // 计算键值(1-16)
+                Os_Sleep(20); // 延时消抖
+                press = Timer_GetMillis();
+                while (GPIO_ReadInputDataBit(GPIOB, colPins[col]) == 0) { // 等待按键释放
+                    Os_Sleep(1);
+                }
+                holdTime = Timer_GetMillis() - press;   // 记录按住时间
+                Os_Sleep(20);                           // 延时消抖
+                KeyNum = (3 - col) * 4 + (3 - row) + 1; // 计算键值(1-16)
+                if (holdTime >= KEY_LONG_PRESS_MS) KeyNum |= KEY_LONG_FLAG;
                 break;
             }
         }
@@ -20,6 +20,12 @@
 #define KEY_ROW_NUM 4  /**< 行数 */
 #define KEY_COL_NUM 4  /**< 列数 */
 
+/**
+ * @brief 长按参数定义
+ */
+#define KEY_LONG_PRESS_MS 800  /**< 按住超过该时间视为长按（毫秒） */
+#define KEY_LONG_FLAG     0x80 /**< 长按标志，与键码按位或 */
+
 /**
  * @brief  矩阵键盘初始化函数
  * @details 配置GPIO引脚和默认状态：
@@ -41,6 +47,7 @@ void Key_Init(void);
  * @return uint8_t 按键键码：
  *         - 0：无按键按下
  *         - 1-16：对应的按键编号
+ *         - 长按时附加KEY_LONG_FLAG
  */
 uint8_t Key_GetNum(void);
 
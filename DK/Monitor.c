@@ -0,0 +1,202 @@
+/**
+ * @file     Monitor.c
+ * @brief    控制周期监视
+ * @details  监视控制线程的周期执行情况：
+ *          - 每个周期开始时记录相对理想时刻的起始偏差，结束时记录执行时间
+ *          - 完成时刻晚于理想时刻MONITOR_DEADLINE_US计为超时，跳过的周期也计为超时
+ *          - 超时时比较控制线程等待CPU的时间和自身执行的时间，记录占用较多的一方：
+ *            等待较多时为切换到控制线程前最后运行的线程，否则为控制线程自身
+ *          - 开启MONITOR_WWDG时由窗口看门狗的提前唤醒中断检查控制周期，
+ *            超过MONITOR_SEVERE_MS没有开始新周期时停止喂狗使系统复位
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <stdio.h>     // snprintf
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+static MonitorStats_t Monitor_Stats;           /**< 统计 */
+static uint32_t Monitor_IdealUs;               /**< 本周期理想起始时刻（微秒） */
+static uint32_t Monitor_StartUs;               /**< 本周期实际起始时刻（微秒） */
+static uint32_t Monitor_WaitUs;                /**< 本周期就绪后等待CPU的时间（微秒） */
+static const char *Monitor_Waiter;             /**< 等待期间最后运行的线程 */
+static volatile uint32_t Monitor_LastStart;    /**< 最近一次周期开始的时刻（毫秒） */
+static uint8_t Monitor_WwdgReset;              /**< 上次复位由窗口看门狗引起 */
+
+/**
+ * @brief WWDG计数器重装值（7位，递减到0x3F时复位）
+ */
+#define MONITOR_WWDG_RELOAD 0x7F
+
+/**
+ * @brief  控制周期监视初始化
+ * @param  无
+ * @return 无
+ */
+void Monitor_Init(void)
+{
+    if (RCC_GetFlagStatus(RCC_FLAG_WWDGRST) == SET) Monitor_WwdgReset = 1;
+    RCC_ClearFlag();
+
+    Monitor_LastStart = Timer_GetMillis();
+
+#if MONITOR_WWDG
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_WWDG, ENABLE);
+    DBGMCU_Config(DBGMCU_WWDG_STOP, ENABLE); // 调试暂停时看门狗同时暂停
+
+    // 36MHz / 4096 / 8 ≈ 1099Hz，0x7F递减到0x40约57ms
+    WWDG_SetPrescaler(WWDG_Prescaler_8);
+    WWDG_SetWindowValue(MONITOR_WWDG_RELOAD); // 窗口上限取最大值，任何时刻都可以喂狗
+    WWDG_ClearFlag();
+    WWDG_EnableIT();
+
+    // 最高优先级：线程全部卡住或其他中断过长时仍能检查
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel                   = WWDG_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 0;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 0;
+    NVIC_Init(&NVIC_InitStructure);
+
+    WWDG_Enable(MONITOR_WWDG_RELOAD);
+#endif
+}
+
+/**
+ * @brief  控制周期开始
+ * @details 理想时刻按64位毫秒时基换算为微秒，32位毫秒计数回绕后仍然正确；
+ *         控制线程在理想时刻之后才被切换进来时，两者之差即等待CPU的时间
+ * @param  Ideal 本周期的理想起始时刻（毫秒）
+ * @return 无
+ */
+void Monitor_TickStart(uint32_t Ideal)
+{
+    uint64_t now = Timer_GetMicros64();
+    uint64_t ms  = now / 1000;
+    const OsThread_t *previous;
+    uint32_t switch_us;
+
+    Monitor_IdealUs   = (uint32_t)((ms - (uint32_t)((uint32_t)ms - Ideal)) * 1000);
+    Monitor_StartUs   = (uint32_t)now;
+    Monitor_LastStart = (uint32_t)ms;
+
+    previous = Os_GetLastSwitch(&switch_us);
+    if (previous && (int32_t)(switch_us - Monitor_IdealUs) > 0) {
+        Monitor_WaitUs = switch_us - Monitor_IdealUs;
+        Monitor_Waiter = previous->Name;
+    } else {
+        Monitor_WaitUs = 0;
+        Monitor_Waiter = 0;
+    }
+}
+
+/**
+ * @brief  控制周期结束
+ * @param  Skipped 本周期结束后跳过的周期数
+ * @return 无
+ */
+void Monitor_TickEnd(uint32_t Skipped)
+{
+    uint32_t now    = Timer_GetMicros();
+    uint32_t jitter = Monitor_StartUs - Monitor_IdealUs;
+    uint32_t exec   = now - Monitor_StartUs;
+    uint32_t late   = now - Monitor_IdealUs;
+    uint32_t state  = Os_EnterCritical();
+
+    Monitor_Stats.Ticks++;
+    Monitor_Stats.JitterLast = jitter;
+    Monitor_Stats.JitterSum += jitter;
+    if (jitter > Monitor_Stats.JitterMax) Monitor_Stats.JitterMax = jitter;
+    if (exec > Monitor_Stats.ExecMax) Monitor_Stats.ExecMax = exec;
+
+    Monitor_Stats.Skipped += Skipped;
+    if (late > MONITOR_DEADLINE_US || Skipped) {
+        Monitor_Stats.Misses += 1 + Skipped;
+        Monitor_Stats.MissTime = Monitor_LastStart;
+        Monitor_Stats.MissLate = late;
+        // 等待CPU的时间多于自身执行的时间时归咎于等待期间运行的线程
+        if (Monitor_Waiter && Monitor_WaitUs > late - Monitor_WaitUs) {
+            Monitor_Stats.MissThread = Monitor_Waiter;
+        } else {
+            Monitor_Stats.MissThread = Os_Current->Name;
+        }
+    }
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  读取统计
+ * @param  Stats 统计副本
+ * @return 无
+ */
+void Monitor_Get(MonitorStats_t *Stats)
+{
+    uint32_t state = Os_EnterCritical();
+
+    *Stats           = Monitor_Stats;
+    Stats->WwdgReset = Monitor_WwdgReset;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  清除统计
+ * @details 复位原因保留
+ * @param  无
+ * @return 无
+ */
+void Monitor_Reset(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    Monitor_Stats.Ticks      = 0;
+    Monitor_Stats.Misses     = 0;
+    Monitor_Stats.Skipped    = 0;
+    Monitor_Stats.JitterLast = 0;
+    Monitor_Stats.JitterMax  = 0;
+    Monitor_Stats.JitterSum  = 0;
+    Monitor_Stats.ExecMax    = 0;
+    Monitor_Stats.MissTime   = 0;
+    Monitor_Stats.MissLate   = 0;
+    Monitor_Stats.MissThread = 0;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  格式化统计为一行文本
+ * @param  Buf 输出缓冲
+ * @param  Size 缓冲大小
+ * @return 无
+ */
+void Monitor_Format(char *Buf, uint16_t Size)
+{
+    MonitorStats_t stats;
+    uint32_t avg;
+
+    Monitor_Get(&stats);
+    avg = stats.Ticks ? (uint32_t)(stats.JitterSum / stats.Ticks) : 0;
+
+    snprintf(Buf, Size, "[CTRL] ticks=%lu miss=%lu skip=%lu jit=%lu/%luus exec=%luus last=%lums/%luus/%s wwdg=%u\r\n",
+             (unsigned long)stats.Ticks, (unsigned long)stats.Misses, (unsigned long)stats.Skipped,
+             (unsigned long)avg, (unsigned long)stats.JitterMax, (unsigned long)stats.ExecMax,
+             (unsigned long)stats.MissTime, (unsigned long)stats.MissLate,
+             stats.MissThread ? stats.MissThread : "-", (unsigned int)stats.WwdgReset);
+}
+
+#if MONITOR_WWDG
+/**
+ * @brief  WWDG提前唤醒中断服务函数
+ * @details 计数器递减到0x40时进入。最近MONITOR_SEVERE_MS内有新的控制周期开始时喂狗，
+ *         否则不喂狗，计数器再减1后系统复位
+ * @param  无
+ * @return 无
+ */
+void WWDG_IRQHandler(void)
+{
+    WWDG_ClearFlag();
+    if ((int32_t)(Timer_GetMillis() - Monitor_LastStart) < MONITOR_SEVERE_MS) {
+        WWDG_SetCounter(MONITOR_WWDG_RELOAD);
+    }
+}
+#endif
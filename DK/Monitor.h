@@ -0,0 +1,119 @@
+/**
+ * @file     Monitor.h
+ * @brief    控制周期监视头文件
+ * @details  定义了控制周期监视相关的：
+ *          - 截止时间与看门狗配置选项
+ *          - 周期统计结构
+ *          - 周期打点、统计读取与格式化接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __MONITOR_H
+#define __MONITOR_H
+
+#include <stdint.h>
+
+/**
+ * @brief 截止时间（微秒）
+ * @details 控制逻辑应在理想起始时刻之后这么长时间内执行完，超过即计为一次超时
+ */
+#ifndef MONITOR_DEADLINE_US
+#define MONITOR_DEADLINE_US 10000
+#endif
+
+/**
+ * @brief 严重超时（毫秒）
+ * @details 超过这么长时间没有开始新的控制周期，视为控制失效；应大于控制周期
+ */
+#ifndef MONITOR_SEVERE_MS
+#define MONITOR_SEVERE_MS 500
+#endif
+
+/**
+ * @brief 窗口看门狗开关
+ * @details 0：只统计；
+ *        1：启动WWDG（PCLK1/4096/8，约58ms计满），由提前唤醒中断检查控制周期，
+ *           严重超时时不再喂狗，约1ms后复位。提前唤醒中断每约57ms一次，
+ *           睡眠模式下会唤醒CPU；停止模式下WWDG随APB1时钟暂停
+ */
+#ifndef MONITOR_WWDG
+#define MONITOR_WWDG 0
+#endif
+
+/**
+ * @brief 格式化统计所需的缓冲大小
+ */
+#define MONITOR_LINE_LEN 160
+
+/**
+ * @brief 控制周期统计
+ * @details 偏差为实际起始时刻晚于理想时刻的时间；超时时记录占用时间较多的一方：
+ *         等待期间最后运行的线程（控制线程被推迟），或控制线程自身（执行过长）
+ */
+typedef struct {
+    uint32_t Ticks;          /**< 执行次数 */
+    uint32_t Misses;         /**< 超时次数（含跳过的周期） */
+    uint32_t Skipped;        /**< 落后一个周期以上而跳过的周期数 */
+    uint32_t JitterLast;     /**< 最近一次起始偏差（微秒） */
+    uint32_t JitterMax;      /**< 最大起始偏差（微秒） */
+    uint64_t JitterSum;      /**< 累计起始偏差，用于计算平均值 */
+    uint32_t ExecMax;        /**< 最长执行时间（微秒） */
+    uint32_t MissTime;       /**< 最近一次超时的时刻（毫秒） */
+    uint32_t MissLate;       /**< 最近一次超时的完成时刻晚于理想时刻的时间（微秒） */
+    const char *MissThread;  /**< 最近一次超时的原因线程 */
+    uint8_t WwdgReset;       /**< 上次复位由窗口看门狗引起 */
+} MonitorStats_t;
+
+/**
+ * @brief  控制周期监视初始化
+ * @details 读取并清除复位原因；开启MONITOR_WWDG时启动窗口看门狗。
+ *         应在控制线程开始循环前调用
+ * @param  无
+ * @return 无
+ */
+void Monitor_Init(void);
+
+/**
+ * @brief  控制周期开始
+ * @details 记录起始时刻和相对理想时刻的偏差
+ * @param  Ideal 本周期的理想起始时刻（毫秒，Timer_GetMillis时基）
+ * @return 无
+ */
+void Monitor_TickStart(uint32_t Ideal);
+
+/**
+ * @brief  控制周期结束
+ * @details 统计执行时间，判断是否超时并记录原因线程
+ * @param  Skipped 本周期结束后跳过的周期数
+ * @return 无
+ */
+void Monitor_TickEnd(uint32_t Skipped);
+
+/**
+ * @brief  读取统计
+ * @details 在临界区内复制，不会读到更新了一半的统计
+ * @param  Stats 统计副本
+ * @return 无
+ */
+void Monitor_Get(MonitorStats_t *Stats);
+
+/**
+ * @brief  清除统计
+ * @param  无
+ * @return 无
+ */
+void Monitor_Reset(void);
+
+/**
+ * @brief  格式化统计为一行文本
+ * @details 格式：[CTRL] ticks= miss= skip= jit=平均/最大us exec=us last=时刻ms/延迟us/线程 wwdg=
+ *         供调试串口和蓝牙共用
+ * @param  Buf 输出缓冲
+ * @param  Size 缓冲大小
+ * @return 无
+ */
+void Monitor_Format(char *Buf, uint16_t Size);
+
+#endif /* __MONITOR_H */
@@ -2,12 +2,14 @@
  * @file     OLED.c
  * @brief    OLED显示屏驱动程序（I2C通信）
  * @details  实现0.96寸OLED显示功能：
- *          - I2C通信协议（软件模拟）
+ *          - I2C通信：软件模拟（默认）或硬件I2C1+DMA后台刷新，
+ *            由OLED_USE_HW_I2C选择
+ *          - RAM显存缓冲区，按页记录脏列范围，每帧集中刷新
  *          - 显示字符、字符串
- *          - 显示数字（整数、小数）
+ *          - 显示数字（整数、小数），无除法单次格式化
  *          - 显示清屏等基本功能
  * @note     OLED分辨率：128x64
- *          通信接口：I2C（SCL:PB8, SDA:PB9）
+ *          通信接口：I2C（SCL:PB8, SDA:PB9，即I2C1重映射引脚）
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -17,12 +19,434 @@
 #include "OLED_Font.h"  // OLED字体库
 #include "dk_C8T6.h"    // 项目主头文件
 
+/**
+ * @brief OLED显存缓冲区
+ * @details 与SSD1306内部显存一一对应：8页 x 128列，每字节表示一列中的8个像素。
+ *         所有OLED_Show*函数只写入该缓冲区，由OLED_Update统一发送到屏幕。
+ */
+static uint8_t OLED_DisplayBuf[OLED_PAGE_NUM][OLED_WIDTH];
+
+/**
+ * @brief 脏区记录
+ * @details 每页记录一段需要刷新的列范围[Start, End]，
+ *         OLED_DirtyPages的第n位为1表示第n页存在待刷新数据
+ */
+static uint8_t OLED_DirtyPages = 0;
+static uint8_t OLED_DirtyStart[OLED_PAGE_NUM];
+static uint8_t OLED_DirtyEnd[OLED_PAGE_NUM];
+
+/** @brief I2C总线发送字节计数（含地址和控制字节），用于评估刷新开销 */
+static uint32_t OLED_BusBytes = 0;
+
+#if OLED_USE_HW_I2C
+
+/**
+ * @brief 硬件I2C等待超时计数，防止总线异常时死等
+ */
+#define OLED_HW_TIMEOUT 10000
+
+/**
+ * @brief 后台刷新超时（毫秒）
+ * @details 整屏约1100字节，400kHz下约25ms；超过该时间仍未完成视为总线卡死
+ */
+#define OLED_FLUSH_TIMEOUT_MS 100
+
+/**
+ * @brief DMA刷新状态机状态
+ */
+typedef enum {
+    OLED_FLUSH_IDLE = 0, /**< 空闲 */
+    OLED_FLUSH_START,    /**< 已发出起始信号，等待SB */
+    OLED_FLUSH_HEADER,   /**< DMA发送光标命令头 */
+    OLED_FLUSH_DATA,     /**< DMA发送显示数据 */
+    OLED_FLUSH_BTF       /**< 等待最后一个字节移出 */
+} OLED_FlushState_t;
+
+static volatile OLED_FlushState_t OLED_FlushState = OLED_FLUSH_IDLE;
+static uint8_t OLED_FlushPages;                 /**< 本次刷新尚未发送的页 */
+static uint8_t OLED_FlushPage;                  /**< 正在发送的页 */
+static uint8_t OLED_FlushStart[OLED_PAGE_NUM];  /**< 本次刷新各页起始列 */
+static uint8_t OLED_FlushEnd[OLED_PAGE_NUM];    /**< 本次刷新各页结束列 */
+static uint8_t OLED_FlushHeader[7];             /**< 光标命令头 */
+static void (*OLED_FlushCallback)(void) = 0;    /**< 刷新完成回调 */
+static uint32_t OLED_FlushTime;                 /**< 本次刷新的启动时刻（毫秒） */
+static volatile uint8_t OLED_FlushRetry = 0;    /**< 刷新出错，下一帧重发整屏 */
+
+/**
+ * @brief  等待I2C事件（带超时）
+ * @param  Event I2C事件，参见I2C_EVENT_xxx
+ * @return 1：事件发生；0：超时
+ */
+static uint8_t OLED_I2C_WaitEvent(uint32_t Event)
+{
+    uint32_t timeout = OLED_HW_TIMEOUT;
+    while (I2C_CheckEvent(I2C1, Event) != SUCCESS) {
+        if (--timeout == 0) return 0;
+    }
+    return 1;
+}
+
+/**
+ * @brief  配置I2C1为主机模式并使能
+ * @details 快速模式400kHz；软件复位会清零全部寄存器，复位后需重新调用
+ * @param  无
+ * @return 无
+ */
+static void OLED_I2C_Config(void)
+{
+    I2C_InitTypeDef I2C_InitStructure;
+    I2C_InitStructure.I2C_Mode                = I2C_Mode_I2C;
+    I2C_InitStructure.I2C_DutyCycle           = I2C_DutyCycle_2;
+    I2C_InitStructure.I2C_OwnAddress1         = 0x00;
+    I2C_InitStructure.I2C_Ack                 = I2C_Ack_Enable;
+    I2C_InitStructure.I2C_AcknowledgedAddress = I2C_AcknowledgedAddress_7bit;
+    I2C_InitStructure.I2C_ClockSpeed          = 400000; // 400kHz
+    I2C_Init(I2C1, &I2C_InitStructure);
+    I2C_Cmd(I2C1, ENABLE);
+}
+
+/**
+ * @brief  OLED硬件I2C初始化
+ * @details 完成以下配置：
+ *         1. PB8/PB9重映射为I2C1_SCL/I2C1_SDA，复用开漏输出
+ *         2. I2C1快速模式400kHz
+ *         3. DMA1_Channel6（I2C1_TX）内存到外设，完成中断
+ *         4. 配置I2C1事件中断、错误中断和DMA中断优先级
+ * @param  无
+ * @return 无
+ */
+void OLED_I2C_Init(void)
+{
+    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOB | RCC_APB2Periph_AFIO, ENABLE);
+    RCC_APB1PeriphClockCmd(RCC_APB1Periph_I2C1, ENABLE);
+    RCC_AHBPeriphClockCmd(RCC_AHBPeriph_DMA1, ENABLE);
+
+    GPIO_PinRemapConfig(GPIO_Remap_I2C1, ENABLE); // I2C1重映射到PB8/PB9
+
+    GPIO_InitTypeDef GPIO_InitStructure;
+    GPIO_InitStructure.GPIO_Mode  = GPIO_Mode_AF_OD;
+    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
+    GPIO_InitStructure.GPIO_Pin   = GPIO_Pin_8 | GPIO_Pin_9;
+    GPIO_Init(GPIOB, &GPIO_InitStructure);
+
+    OLED_I2C_Config();
+
+    DMA_InitTypeDef DMA_InitStructure;
+    DMA_InitStructure.DMA_PeripheralBaseAddr = (uint32_t)&I2C1->DR;
+    DMA_InitStructure.DMA_MemoryBaseAddr     = (uint32_t)OLED_FlushHeader;
+    DMA_InitStructure.DMA_DIR                = DMA_DIR_PeripheralDST;
+    DMA_InitStructure.DMA_BufferSize         = 1;
+    DMA_InitStructure.DMA_PeripheralInc      = DMA_PeripheralInc_Disable;
+    DMA_InitStructure.DMA_MemoryInc          = DMA_MemoryInc_Enable;
+    DMA_InitStructure.DMA_PeripheralDataSize = DMA_PeripheralDataSize_Byte;
+    DMA_InitStructure.DMA_MemoryDataSize     = DMA_MemoryDataSize_Byte;
+    DMA_InitStructure.DMA_Mode               = DMA_Mode_Normal;
+    DMA_InitStructure.DMA_Priority           = DMA_Priority_Medium;
+    DMA_InitStructure.DMA_M2M                = DMA_M2M_Disable;
+    DMA_Init(DMA1_Channel6, &DMA_InitStructure);
+    DMA_ITConfig(DMA1_Channel6, DMA_IT_TC, ENABLE);
+
+    NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
+    NVIC_InitTypeDef NVIC_InitStructure;
+    NVIC_InitStructure.NVIC_IRQChannel                   = DMA1_Channel6_IRQn;
+    NVIC_InitStructure.NVIC_IRQChannelCmd                = ENABLE;
+    NVIC_InitStructure.NVIC_IRQChannelPreemptionPriority = 3;
+    NVIC_InitStructure.NVIC_IRQChannelSubPriority        = 1;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = I2C1_EV_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+    NVIC_InitStructure.NVIC_IRQChannel = I2C1_ER_IRQn;
+    NVIC_Init(&NVIC_InitStructure);
+}
+
+/**
+ * @brief  开始一次连续传输（硬件I2C，轮询方式）
+ * @details 仅用于初始化等少量命令；若DMA刷新正在进行则先等待其结束。
+ *         等待超时或从机无应答时放弃本次传输，不会改写正在进行的DMA刷新
+ * @param  Control 控制字节：OLED_BURST_COMMAND(0x00)或OLED_BURST_DATA(0x40)
+ * @return uint8_t 1-成功，可继续调用OLED_BurstWrite/OLED_BurstEnd；0-总线不可用，本次传输已放弃
+ */
+uint8_t OLED_BurstBegin(uint8_t Control)
+{
+    uint32_t timeout = OLED_HW_TIMEOUT;
+    while (OLED_FlushState != OLED_FLUSH_IDLE) {
+        if (--timeout == 0) return 0;
+    }
+    timeout = OLED_HW_TIMEOUT;
+    while (I2C_GetFlagStatus(I2C1, I2C_FLAG_BUSY) == SET) {
+        if (--timeout == 0) return 0;
+    }
+
+    I2C_GenerateSTART(I2C1, ENABLE);
+    if (OLED_I2C_WaitEvent(I2C_EVENT_MASTER_MODE_SELECT)) {
+        I2C_Send7bitAddress(I2C1, 0x78, I2C_Direction_Transmitter);
+        if (OLED_I2C_WaitEvent(I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED)) {
+            I2C_SendData(I2C1, Control);
+            OLED_BusBytes += 2;
+            OLED_I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTING);
+            return 1;
+        }
+    }
+    I2C_ClearFlag(I2C1, I2C_FLAG_AF); // 从机无应答
+    I2C_GenerateSTOP(I2C1, ENABLE);
+    return 0;
+}
+
+/**
+ * @brief  在连续传输中发送一段字节（硬件I2C，轮询方式）
+ * @param  Data 数据指针
+ * @param  Count 字节数
+ * @return 无
+ */
+void OLED_BurstWrite(const uint8_t *Data, uint16_t Count)
+{
+    while (Count--) {
+        I2C_SendData(I2C1, *Data++);
+        OLED_BusBytes++;
+        if (!OLED_I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTING)) return;
+    }
+}
+
+/**
+ * @brief  结束一次连续传输（硬件I2C）
+ * @details 等待最后一个字节发送完成后产生停止信号
+ * @param  无
+ * @return 无
+ */
+void OLED_BurstEnd(void)
+{
+    OLED_I2C_WaitEvent(I2C_EVENT_MASTER_BYTE_TRANSMITTED);
+    I2C_GenerateSTOP(I2C1, ENABLE);
+}
+
+/**
+ * @brief  启动DMA发送
+ * @param  Buf 发送缓冲区
+ * @param  Count 字节数
+ * @return 无
+ */
+static void OLED_DMA_Start(const uint8_t *Buf, uint16_t Count)
+{
+    DMA_Cmd(DMA1_Channel6, DISABLE);
+    DMA1_Channel6->CMAR = (uint32_t)Buf;
+    DMA_SetCurrDataCounter(DMA1_Channel6, Count);
+    DMA_Cmd(DMA1_Channel6, ENABLE);
+    OLED_BusBytes += Count;
+}
+
+/**
+ * @brief  开始发送下一个脏页
+ * @details 从OLED_FlushPages中取出一页，构造光标命令头并产生（重复）起始信号，
+ *         之后的传输由I2C事件中断和DMA中断推进
+ * @param  无
+ * @return 无
+ */
+static void OLED_FlushNextPage(void)
+{
+    uint8_t x;
+
+    while (!(OLED_FlushPages & (1 << OLED_FlushPage))) OLED_FlushPage++;
+    OLED_FlushPages &= ~(1 << OLED_FlushPage);
+    x = OLED_FlushStart[OLED_FlushPage];
+
+    // Co=1的命令字节对，最后以0x40切换为连续数据
+    OLED_FlushHeader[0] = 0x80;
+    OLED_FlushHeader[1] = 0xB0 | OLED_FlushPage;
+    OLED_FlushHeader[2] = 0x80;
+    OLED_FlushHeader[3] = 0x10 | ((x & 0xF0) >> 4);
+    OLED_FlushHeader[4] = 0x80;
+    OLED_FlushHeader[5] = 0x00 | (x & 0x0F);
+    OLED_FlushHeader[6] = OLED_BURST_DATA;
+
+    OLED_FlushState = OLED_FLUSH_START;
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, ENABLE);
+    I2C_GenerateSTART(I2C1, ENABLE);
+}
+
+/**
+ * @brief  中止后台刷新
+ * @details 总线出错或刷新超时时调用：关闭DMA和I2C中断，产生停止信号，
+ *         软件复位I2C1后重新配置，并请求下一帧重发整屏。
+ *         显存脏区只在线程中修改，这里只设置OLED_FlushRetry，由OLED_Update标记整屏
+ * @param  无
+ * @return 无
+ */
+static void OLED_FlushAbort(void)
+{
+    I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+    DMA_Cmd(DMA1_Channel6, DISABLE);
+    DMA_ClearITPendingBit(DMA1_IT_GL6);
+    I2C_DMACmd(I2C1, DISABLE);
+    I2C_GenerateSTOP(I2C1, ENABLE);
+
+    I2C_SoftwareResetCmd(I2C1, ENABLE);
+    I2C_SoftwareResetCmd(I2C1, DISABLE);
+    OLED_I2C_Config();
+
+    OLED_FlushPages = 0;
+    OLED_FlushRetry = 1;
+    OLED_FlushState = OLED_FLUSH_IDLE;
+}
+
+/**
+ * @brief  将显存脏区刷新到屏幕（硬件I2C + DMA，非阻塞）
+ * @details 取走当前脏区快照后立即返回，由中断在后台逐页发送，
+ *         全部完成后调用OLED_SetFlushCallback注册的回调。
+ *         若上一次刷新尚未结束则直接返回，脏区保留到下一帧。
+ *         刷新期间继续绘制是安全的：新写入的列会重新标记为脏区，下一帧补发。
+ *         刷新超过OLED_FLUSH_TIMEOUT_MS仍未完成时中止并复位I2C1；
+ *         中止或总线出错后本次调用重新标记整屏并重发。
+ * @param  无
+ * @return 无
+ */
+void OLED_Update(void)
+{
+    uint8_t page;
+    uint32_t state;
+
+    if (OLED_FlushState != OLED_FLUSH_IDLE) {
+        if (Timer_GetMillis() - OLED_FlushTime < OLED_FLUSH_TIMEOUT_MS) return;
+        state = Os_EnterCritical();
+        if (OLED_FlushState != OLED_FLUSH_IDLE) OLED_FlushAbort();
+        Os_ExitCritical(state);
+    }
+    if (OLED_FlushRetry) {
+        OLED_FlushRetry = 0;
+        for (page = 0; page < OLED_PAGE_NUM; page++) {
+            OLED_DirtyStart[page] = 0;
+            OLED_DirtyEnd[page]   = OLED_WIDTH - 1;
+        }
+        OLED_DirtyPages = 0xFF;
+    }
+    if (OLED_DirtyPages == 0) return;
+
+    for (page = 0; page < OLED_PAGE_NUM; page++) {
+        OLED_FlushStart[page] = OLED_DirtyStart[page];
+        OLED_FlushEnd[page]   = OLED_DirtyEnd[page];
+    }
+    OLED_FlushPages = OLED_DirtyPages;
+    OLED_DirtyPages = 0;
+    OLED_FlushPage  = 0;
+
+    OLED_FlushTime = Timer_GetMillis();
+    OLED_BusBytes++; // 从机地址
+    OLED_FlushNextPage();
+}
+
+/**
+ * @brief  分段刷新显存脏区（硬件I2C）
+ * @details 刷新在后台进行，不占用调用者时间：空闲时启动刷新后立即返回
+ * @param  无
+ * @return 始终为0
+ */
+uint8_t OLED_UpdateStep(void)
+{
+    OLED_Update();
+    return 0;
+}
+
+/**
+ * @brief  I2C1事件中断服务函数
+ * @details 推进刷新状态机：
+ *         - SB：发送从机地址
+ *         - ADDR：清除标志，启动DMA发送光标命令头
+ *         - BTF：本页数据发送完毕，继续下一页（重复起始）或产生停止信号
+ * @note   此函数会被硬件自动调用
+ */
+void I2C1_EV_IRQHandler(void)
+{
+    if (OLED_FlushState == OLED_FLUSH_START) {
+        if (I2C_GetFlagStatus(I2C1, I2C_FLAG_SB) == SET) {
+            I2C_Send7bitAddress(I2C1, 0x78, I2C_Direction_Transmitter);
+        } else if (I2C_CheckEvent(I2C1, I2C_EVENT_MASTER_TRANSMITTER_MODE_SELECTED) == SUCCESS) {
+            // 读取SR1和SR2后ADDR已清除，交给DMA发送
+            I2C_ITConfig(I2C1, I2C_IT_EVT, DISABLE);
+            OLED_FlushState = OLED_FLUSH_HEADER;
+            I2C_DMACmd(I2C1, ENABLE);
+            OLED_DMA_Start(OLED_FlushHeader, sizeof(OLED_FlushHeader));
+        }
+    } else if (OLED_FlushState == OLED_FLUSH_BTF) {
+        if (I2C_GetFlagStatus(I2C1, I2C_FLAG_BTF) == SET) {
+            if (OLED_FlushPages) {
+                OLED_BusBytes++; // 从机地址
+                OLED_FlushNextPage();
+            } else {
+                I2C_ITConfig(I2C1, I2C_IT_EVT | I2C_IT_ERR, DISABLE);
+                I2C_GenerateSTOP(I2C1, ENABLE);
+                OLED_FlushState = OLED_FLUSH_IDLE;
+                if (OLED_FlushCallback) OLED_FlushCallback();
+            }
+        }
+    }
+}
+
+/**
+ * @brief  I2C1错误中断服务函数
+ * @details 从机无应答(AF)、总线错误(BERR)、仲裁丢失(ARLO)或溢出(OVR)时
+ *         清除错误标志并中止本次刷新，整屏留待下一帧重发
+ * @note   此函数会被硬件自动调用
+ */
+void I2C1_ER_IRQHandler(void)
+{
+    I2C_ClearITPendingBit(I2C1, I2C_IT_AF | I2C_IT_BERR | I2C_IT_ARLO | I2C_IT_OVR);
+    if (OLED_FlushState != OLED_FLUSH_IDLE) OLED_FlushAbort();
+}
+
+/**
+ * @brief  DMA1通道6（I2C1_TX）中断服务函数
+ * @details 命令头发送完成后接着发送本页显示数据；
+ *         数据发送完成后关闭DMA请求，等待BTF以确认最后一个字节移出
+ * @note   此函数会被硬件自动调用
+ */
+void DMA1_Channel6_IRQHandler(void)
+{
+    if (DMA_GetITStatus(DMA1_IT_TC6) == SET) {
+        DMA_ClearITPendingBit(DMA1_IT_TC6);
+
+        if (OLED_FlushState == OLED_FLUSH_HEADER) {
+            OLED_FlushState = OLED_FLUSH_DATA;
+            OLED_DMA_Start(&OLED_DisplayBuf[OLED_FlushPage][OLED_FlushStart[OLED_FlushPage]],
+                           OLED_FlushEnd[OLED_FlushPage] - OLED_FlushStart[OLED_FlushPage] + 1);
+        } else if (OLED_FlushState == OLED_FLUSH_DATA) {
+            DMA_Cmd(DMA1_Channel6, DISABLE);
+            I2C_DMACmd(I2C1, DISABLE);
+            OLED_FlushState = OLED_FLUSH_BTF;
+            I2C_ITConfig(I2C1, I2C_IT_EVT, ENABLE);
+        }
+    }
+}
+
+/**
+ * @brief  查询刷新是否正在进行
+ * @param  无
+ * @return 1：后台刷新中；0：空闲
+ */
+uint8_t OLED_IsBusy(void)
+{
+    return OLED_FlushState != OLED_FLUSH_IDLE;
+}
+
+/**
+ * @brief  注册刷新完成回调
+ * @details 回调在中断上下文中执行，应尽量简短
+ * @param  Callback 回调函数，传入0取消注册
+ * @return 无
+ */
+void OLED_SetFlushCallback(void (*Callback)(void))
+{
+    OLED_FlushCallback = Callback;
+}
+
+#else /* OLED_USE_HW_I2C */
+
 /**
  * @brief OLED I2C通信引脚定义和控制宏
  */
 #define OLED_W_SCL(x) GPIO_WriteBit(GPIOB, GPIO_Pin_8, (BitAction)(x)) /**< SCL引脚控制 */
 #define OLED_W_SDA(x) GPIO_WriteBit(GPIOB, GPIO_Pin_9, (BitAction)(x)) /**< SDA引脚控制 */
 
+static void (*OLED_FlushCallback)(void) = 0; /**< 刷新完成回调 */
+
 /**
  * @brief  OLED I2C通信引脚初始化
  * @details 配置SCL和SDA引脚为开漏输出模式
@@ -91,6 +515,7 @@ void OLED_I2C_Stop(void)
 void OLED_I2C_SendByte(uint8_t Byte)
 {
     uint8_t i;
+    OLED_BusBytes++;
     for (i = 0; i < 8; i++) {
         OLED_W_SDA(!!(Byte & (0x80 >> i)));
         OLED_W_SCL(1);
@@ -100,47 +525,77 @@ void OLED_I2C_SendByte(uint8_t Byte)
     OLED_W_SCL(0);
 }
 
+/**
+ * @brief  开始一次连续传输
+ * @details 发送起始信号、从机地址(0x78)和控制字节，之后可多次调用
+ *         OLED_BurstWrite连续发送任意数量的字节，最后调用OLED_BurstEnd结束。
+ *         一次传输只付出一次起始/地址/控制/停止的开销。
+ * @param  Control 控制字节：OLED_BURST_COMMAND(0x00)或OLED_BURST_DATA(0x40)
+ * @return uint8_t 始终为1（软件I2C不检查应答）
+ */
+uint8_t OLED_BurstBegin(uint8_t Control)
+{
+    OLED_I2C_Start();
+    OLED_I2C_SendByte(0x78);    // 从机地址
+    OLED_I2C_SendByte(Control); // 写命令/写数据
+    return 1;
+}
+
+/**
+ * @brief  在连续传输中发送一段字节
+ * @param  Data 数据指针
+ * @param  Count 字节数
+ * @return 无
+ */
+void OLED_BurstWrite(const uint8_t *Data, uint16_t Count)
+{
+    while (Count--) {
+        OLED_I2C_SendByte(*Data++);
+    }
+}
+
+/**
+ * @brief  结束一次连续传输
+ * @details 发送停止信号
+ * @param  无
+ * @return 无
+ */
+void OLED_BurstEnd(void)
+{
+    OLED_I2C_Stop();
+}
+
+#endif /* OLED_USE_HW_I2C */
+
 /**
  * @brief  向OLED写入命令
- * @details 发送步骤：
- *         1. 发送起始信号
- *         2. 发送从机地址(0x78)和写命令(0x00)
- *         3. 发送命令数据
- *         4. 发送停止信号
+ * @details 单字节命令传输，等价于只含一个字节的命令连续传输
  * @param  Command 要写入的命令字节
  * @return 无
  */
 void OLED_WriteCommand(uint8_t Command)
 {
-    OLED_I2C_Start();
-    OLED_I2C_SendByte(0x78); // 从机地址
-    OLED_I2C_SendByte(0x00); // 写命令
-    OLED_I2C_SendByte(Command);
-    OLED_I2C_Stop();
+    if (!OLED_BurstBegin(OLED_BURST_COMMAND)) return;
+    OLED_BurstWrite(&Command, 1);
+    OLED_BurstEnd();
 }
 
 /**
  * @brief  向OLED写入数据
- * @details 发送步骤：
- *         1. 发送起始信号
- *         2. 发送从机地址(0x78)和写数据(0x40)
- *         3. 发送显示数据
- *         4. 发送停止信号
+ * @details 单字节数据传输，等价于只含一个字节的数据连续传输
  * @param  Data 要写入的数据字节
  * @return 无
  */
 void OLED_WriteData(uint8_t Data)
 {
-    OLED_I2C_Start();
-    OLED_I2C_SendByte(0x78); // 从机地址
-    OLED_I2C_SendByte(0x40); // 写数据
-    OLED_I2C_SendByte(Data);
-    OLED_I2C_Stop();
+    if (!OLED_BurstBegin(OLED_BURST_DATA)) return;
+    OLED_BurstWrite(&Data, 1);
+    OLED_BurstEnd();
 }
 
 /**
  * @brief  设置OLED显示光标位置
- * @details 通过发送命令设置页地址和列地址：
+ * @details 在一次命令连续传输中设置页地址和列地址：
  *         - 页地址：0xB0 | Y
  *         - 列地址高4位：0x10 | (X >> 4)
  *         - 列地址低4位：0x00 | (X & 0x0F)
@@ -150,51 +605,264 @@ void OLED_WriteData(uint8_t Data)
  */
 void OLED_SetCursor(uint8_t Y, uint8_t X)
 {
-    OLED_WriteCommand(0xB0 | Y);                 // 设置Y位置
-    OLED_WriteCommand(0x10 | ((X & 0xF0) >> 4)); // 设置X位置高4位
-    OLED_WriteCommand(0x00 | (X & 0x0F));        // 设置X位置低4位
+    uint8_t cmd[3];
+    cmd[0] = 0xB0 | Y;                 // 设置Y位置
+    cmd[1] = 0x10 | ((X & 0xF0) >> 4); // 设置X位置高4位
+    cmd[2] = 0x00 | (X & 0x0F);        // 设置X位置低4位
+
+    if (!OLED_BurstBegin(OLED_BURST_COMMAND)) return;
+    OLED_BurstWrite(cmd, 3);
+    OLED_BurstEnd();
+}
+
+/**
+ * @brief  标记显存脏区
+ * @details 将指定页的[Start, End]列范围合并到该页的脏区中
+ * @param  Page 页地址，范围0~7
+ * @param  Start 起始列，范围0~127
+ * @param  End 结束列（包含），范围Start~127
+ * @return 无
+ */
+static void OLED_MarkDirty(uint8_t Page, uint8_t Start, uint8_t End)
+{
+    if (OLED_DirtyPages & (1 << Page)) {
+        if (Start < OLED_DirtyStart[Page]) OLED_DirtyStart[Page] = Start;
+        if (End > OLED_DirtyEnd[Page]) OLED_DirtyEnd[Page] = End;
+    } else {
+        OLED_DirtyStart[Page] = Start;
+        OLED_DirtyEnd[Page]   = End;
+        OLED_DirtyPages |= (1 << Page);
+    }
+}
+
+/**
+ * @brief  向显存写入一段数据
+ * @details 逐字节与显存原内容比较，只有实际发生变化的列才计入脏区，
+ *         因此重复绘制相同内容不会产生任何总线传输
+ *         页地址或起始列超出屏幕时不写入，超出右边界的部分被截掉
+ * @param  Page 页地址，范围0~7
+ * @param  X 起始列，范围0~127
+ * @param  Data 数据指针
+ * @param  Count 字节数
+ * @return 无
+ */
+static void OLED_BufWrite(uint8_t Page, uint8_t X, const uint8_t *Data, uint8_t Count)
+{
+    uint8_t i;
+    uint8_t first = 0xFF, last = 0;
+    uint8_t *dst;
+
+    if (Page >= OLED_PAGE_NUM || X >= OLED_WIDTH) return;
+    if (Count > OLED_WIDTH - X) Count = OLED_WIDTH - X;
+    dst = &OLED_DisplayBuf[Page][X];
+
+    for (i = 0; i < Count; i++) {
+        if (dst[i] != Data[i]) {
+            dst[i] = Data[i];
+            if (first == 0xFF) first = i;
+            last = i;
+        }
+    }
+    if (first != 0xFF) {
+        OLED_MarkDirty(Page, X + first, X + last);
+    }
+}
+
+#if !OLED_USE_HW_I2C
+
+/**
+ * @brief  发送一页中从脏区起点开始的若干列（软件I2C）
+ * @details 一次命令传输设置光标，一次数据传输连续发送；
+ *         发送完整个脏区时清除该页的脏标记，否则将脏区起点后移
+ * @param  Page 页地址，范围0~7
+ * @param  Count 最多发送的列数
+ * @return 无
+ */
+static void OLED_FlushRange(uint8_t Page, uint8_t Count)
+{
+    uint8_t start = OLED_DirtyStart[Page];
+
+    if (Count > OLED_DirtyEnd[Page] - start + 1) Count = OLED_DirtyEnd[Page] - start + 1;
+
+    OLED_SetCursor(Page, start);
+    OLED_BurstBegin(OLED_BURST_DATA);
+    OLED_BurstWrite(&OLED_DisplayBuf[Page][start], Count);
+    OLED_BurstEnd();
+
+    if (start + Count > OLED_DirtyEnd[Page]) {
+        OLED_DirtyPages &= ~(1 << Page);
+    } else {
+        OLED_DirtyStart[Page] = start + Count;
+    }
+}
+
+/**
+ * @brief  将显存脏区刷新到屏幕（软件I2C，阻塞）
+ * @details 遍历所有脏页，每页先用一次命令传输设置光标，再用一次数据传输
+ *         连续发送该页中发生变化的列范围，发送完成后清除脏区标记。
+ *         应在每帧绘制结束后调用一次。整屏刷新为8次页传输。
+ *         完成后调用OLED_SetFlushCallback注册的回调。
+ * @param  无
+ * @return 无
+ */
+void OLED_Update(void)
+{
+    uint8_t page;
+
+    for (page = 0; page < OLED_PAGE_NUM; page++) {
+        if (OLED_DirtyPages & (1 << page)) OLED_FlushRange(page, OLED_WIDTH);
+    }
+
+    if (OLED_FlushCallback) OLED_FlushCallback();
+}
+
+/**
+ * @brief  分段刷新显存脏区（软件I2C）
+ * @details 每次只发送第一个脏页中最多OLED_FLUSH_CHUNK列，
+ *         调用者可在两次调用之间检查时间预算，预算用完时剩余脏区顺延到下一帧。
+ *         全部脏区发送完毕时调用OLED_SetFlushCallback注册的回调。
+ * @param  无
+ * @return uint8_t 1-仍有脏区，0-已全部刷新
+ */
+uint8_t OLED_UpdateStep(void)
+{
+    uint8_t page = 0;
+
+    if (OLED_DirtyPages == 0) return 0;
+
+    while (!(OLED_DirtyPages & (1 << page))) page++;
+    OLED_FlushRange(page, OLED_FLUSH_CHUNK);
+
+    if (OLED_DirtyPages) return 1;
+
+    if (OLED_FlushCallback) OLED_FlushCallback();
+    return 0;
+}
+
+/**
+ * @brief  查询刷新是否正在进行
+ * @details 软件I2C刷新是阻塞的，返回时已完成
+ * @param  无
+ * @return 始终为0
+ */
+uint8_t OLED_IsBusy(void)
+{
+    return 0;
+}
+
+/**
+ * @brief  注册刷新完成回调
+ * @details 软件I2C方式下在OLED_Update返回前调用
+ * @param  Callback 回调函数，传入0取消注册
+ * @return 无
+ */
+void OLED_SetFlushCallback(void (*Callback)(void))
+{
+    OLED_FlushCallback = Callback;
+}
+
+#endif /* !OLED_USE_HW_I2C */
+
+/**
+ * @brief  获取I2C总线累计发送的字节数
+ * @details 包括从机地址、控制字节和显示数据，可在刷新前后各读取一次以计算开销
+ * @param  无
+ * @return uint32_t 累计字节数
+ */
+uint32_t OLED_GetBusBytes(void)
+{
+    return OLED_BusBytes;
+}
+
+/**
+ * @brief  获取尚未刷新的脏页
+ * @details 可用于统计因时间预算不足而顺延到下一帧的区域
+ * @param  无
+ * @return uint8_t 脏页位图，bit n对应第n页
+ */
+uint8_t OLED_GetDirtyPages(void)
+{
+    return OLED_DirtyPages;
 }
 
 /**
  * @brief  清空OLED显示
- * @details 将所有显存数据清零：
- *         1. 遍历所有8页
- *         2. 每页写入128个0x00
+ * @details 将显存全部清零，并将整屏标记为脏区：
+ *         上电时屏幕内容未知，因此不做比较，强制在下次OLED_Update时整屏刷新
  * @param  无
  * @return 无
  */
 void OLED_Clear(void)
 {
     uint8_t i, j;
-    for (j = 0; j < 8; j++) {
-        OLED_SetCursor(j, 0);
-        for (i = 0; i < 128; i++) {
-            OLED_WriteData(0x00);
+    for (j = 0; j < OLED_PAGE_NUM; j++) {
+        for (i = 0; i < OLED_WIDTH; i++) {
+            OLED_DisplayBuf[j][i] = 0x00;
         }
+        OLED_MarkDirty(j, 0, OLED_WIDTH - 1);
     }
 }
 
+/**
+ * @brief  向显存写入一列（8个像素）
+ * @details 供图形绘制使用，与原内容相同时不产生刷新开销
+ * @param  Page 页地址，范围0~7
+ * @param  X 列地址，范围0~127
+ * @param  Data 列数据，低位在上
+ * @return 无
+ */
+void OLED_DrawColumn(uint8_t Page, uint8_t X, uint8_t Data)
+{
+    OLED_BufWrite(Page, X, &Data, 1);
+}
+
 /**
  * @brief  在指定位置显示一个字符
  * @details 显示过程：
  *         1. 计算显示位置（行和列的实际坐标）
  *         2. 从字库中取出字模数据
- *         3. 分两次写入（上下各8行像素）
+ *         3. 分两次写入显存（上下各8行像素）
  * @param  Line 行号，范围1~4（每行16像素高）
  * @param  Column 列号，范围1~16（每个字符8像素宽）
  * @param  Char 要显示的字符，范围：ASCII可见字符
  * @return 无
  */
 void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char)
+{
+    uint8_t page = (Line - 1) * 2;
+    uint8_t x    = (Column - 1) * 8;
+
+    if (Line < 1 || Line > 4 || Column < 1 || Column > 16) return;
+
+    OLED_BufWrite(page, x, &OLED_F8x16[Char - ' '][0], 8);     // 上半部分
+    OLED_BufWrite(page + 1, x, &OLED_F8x16[Char - ' '][8], 8); // 下半部分
+}
+
+/**
+ * @brief  连续显示一段字符
+ * @details 数字显示函数先把结果格式化到字符缓冲区，再由本函数
+ *         一次性写入显存，整段字符在刷新时合并为同一段脏区连续发送
+ *         超出第16列的字符不显示（原来的逐字符写入只会让屏幕光标回绕）
+ * @param  Line 行号，范围1~4
+ * @param  Column 起始列号，范围1~16
+ * @param  Chars 字符缓冲区（无需以\0结尾）
+ * @param  Count 字符个数
+ * @return 无
+ */
+static void OLED_ShowChars(uint8_t Line, uint8_t Column, const char *Chars, uint8_t Count)
 {
     uint8_t i;
-    OLED_SetCursor((Line - 1) * 2, (Column - 1) * 8); // 设置光标位置在上半部分
-    for (i = 0; i < 8; i++) {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i]); // 显示上半部分内容
+    uint8_t page = (Line - 1) * 2;
+    uint8_t x    = (Column - 1) * 8;
+
+    if (Line < 1 || Line > 4 || Column < 1 || Column > 16) return;
+    if (Count > 17 - Column) Count = 17 - Column;
+
+    for (i = 0; i < Count; i++) {
+        OLED_BufWrite(page, x + i * 8, &OLED_F8x16[Chars[i] - ' '][0], 8);
     }
-    OLED_SetCursor((Line - 1) * 2 + 1, (Column - 1) * 8); // 设置光标位置在下半部分
-    for (i = 0; i < 8; i++) {
-        OLED_WriteData(OLED_F8x16[Char - ' '][i + 8]); // 显示下半部分内容
+    for (i = 0; i < Count; i++) {
+        OLED_BufWrite(page + 1, x + i * 8, &OLED_F8x16[Chars[i] - ' '][8], 8);
     }
 }
 
@@ -209,32 +877,50 @@ void OLED_ShowChar(uint8_t Line, uint8_t Column, char Char)
 void OLED_ShowString(uint8_t Line, uint8_t Column, char *String)
 {
     uint8_t i;
-    for (i = 0; String[i] != '\0'; i++) {
-        OLED_ShowChar(Line, Column + i, String[i]);
-    }
+    for (i = 0; String[i] != '\0'; i++);
+    OLED_ShowChars(Line, Column, String, i);
 }
 
 /**
- * @brief  计算X的Y次方
- * @details 用于进制转换时的数值计算
- * @param  X 底数
- * @param  Y 指数
- * @return uint32_t X^Y的结果
+ * @brief 十进制各位权值表（10^9 ~ 10^0）
+ */
+static const uint32_t OLED_Pow10[10] = {
+    1000000000, 100000000, 10000000, 1000000, 100000,
+    10000, 1000, 100, 10, 1};
+
+/**
+ * @brief  将无符号整数格式化为十进制字符
+ * @details 从最高位开始用减法逐位求出数字，不使用除法和取模，
+ *         每一位最多减9次。只输出最低Length位，不足时前面补0，
+ *         与原OLED_ShowNum的截断规则一致。
+ * @param  Buf 输出缓冲区，至少Length字节
+ * @param  Number 要转换的数字
+ * @param  Length 输出位数，范围1~10
+ * @return 无
  */
-uint32_t OLED_Pow(uint32_t X, uint32_t Y)
+static void OLED_FormatDec(char *Buf, uint32_t Number, uint8_t Length)
 {
-    uint32_t Result = 1;
-    while (Y--) {
-        Result *= X;
+    uint8_t i;
+    char digit;
+
+    for (i = 0; i < 10; i++) {
+        digit = '0';
+        while (Number >= OLED_Pow10[i]) {
+            Number -= OLED_Pow10[i];
+            digit++;
+        }
+        if (i >= 10 - Length) {
+            *Buf++ = digit;
+        }
     }
-    return Result;
 }
 
 /**
  * @brief  显示无符号整数
  * @details 将数字转换为指定长度的字符串显示：
- *         1. 根据指定长度从高位到低位依次转换
+ *         1. 一次性格式化到字符缓冲区（无除法）
  *         2. 不足指定长度时前面补0
+ *         3. 整段字符一次写入显存
  * @param  Line 起始行号，范围1~4
  * @param  Column 起始列号，范围1~16
  * @param  Number 要显示的数字，范围0~4294967295
@@ -243,17 +929,17 @@ uint32_t OLED_Pow(uint32_t X, uint32_t Y)
  */
 void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
 {
-    uint8_t i;
-    for (i = 0; i < Length; i++) {
-        OLED_ShowChar(Line, Column + i, Number / OLED_Pow(10, Length - i - 1) % 10 + '0');
-    }
+    char buf[10];
+    OLED_FormatDec(buf, Number, Length);
+    OLED_ShowChars(Line, Column, buf, Length);
 }
 
 /**
  * @brief  显示有符号整数
  * @details 显示过程：
- *         1. 判断正负，显示符号
- *         2. 将数字转换为无符号数显示
+ *         1. 判断正负，写入符号
+ *         2. 将绝对值格式化为十进制字符
+ *         3. 符号和数字一次写入显存
  * @param  Line 起始行号，范围1~4
  * @param  Column 起始列号，范围1~16
  * @param  Number 要显示的数字，范围-2147483648~2147483647
@@ -262,24 +948,23 @@ void OLED_ShowNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
  */
 void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Length)
 {
-    uint8_t i;
+    char buf[11];
     uint32_t Number1;
     if (Number >= 0) {
-        OLED_ShowChar(Line, Column, '+');
+        buf[0]  = '+';
         Number1 = Number;
     } else {
-        OLED_ShowChar(Line, Column, '-');
-        Number1 = -Number;
-    }
-    for (i = 0; i < Length; i++) {
-        OLED_ShowChar(Line, Column + i + 1, Number1 / OLED_Pow(10, Length - i - 1) % 10 + '0');
+        buf[0]  = '-';
+        Number1 = -(uint32_t)Number;
     }
+    OLED_FormatDec(&buf[1], Number1, Length);
+    OLED_ShowChars(Line, Column, buf, Length + 1);
 }
 
 /**
  * @brief  显示十六进制数
  * @details 将数字转换为16进制格式显示：
- *         1. 每4位二进制转换为1位16进制
+ *         1. 每4位二进制通过移位取出，转换为1位16进制
  *         2. 数字范围0~F用0-9和A-F表示
  * @param  Line 起始行号，范围1~4
  * @param  Column 起始列号，范围1~16
@@ -289,20 +974,18 @@ void OLED_ShowSignedNum(uint8_t Line, uint8_t Column, int32_t Number, uint8_t Le
  */
 void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
 {
+    char buf[8];
     uint8_t i, SingleNumber;
     for (i = 0; i < Length; i++) {
-        SingleNumber = Number / OLED_Pow(16, Length - i - 1) % 16;
-        if (SingleNumber < 10) {
-            OLED_ShowChar(Line, Column + i, SingleNumber + '0');
-        } else {
-            OLED_ShowChar(Line, Column + i, SingleNumber - 10 + 'A');
-        }
+        SingleNumber = (Number >> ((Length - i - 1) * 4)) & 0x0F;
+        buf[i]       = (SingleNumber < 10) ? (SingleNumber + '0') : (SingleNumber - 10 + 'A');
     }
+    OLED_ShowChars(Line, Column, buf, Length);
 }
 
 /**
  * @brief  显示二进制数
- * @details 将数字的每一位直接转换为字符'0'或'1'显示
+ * @details 将数字的每一位通过移位取出，转换为字符'0'或'1'显示
  * @param  Line 起始行号，范围1~4
  * @param  Column 起始列号，范围1~16
  * @param  Number 要显示的数字，范围0~65535
@@ -311,17 +994,60 @@ void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Leng
  */
 void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length)
 {
+    char buf[16];
     uint8_t i;
     for (i = 0; i < Length; i++) {
-        OLED_ShowChar(Line, Column + i, Number / OLED_Pow(2, Length - i - 1) % 2 + '0');
+        buf[i] = ((Number >> (Length - i - 1)) & 0x01) + '0';
     }
+    OLED_ShowChars(Line, Column, buf, Length);
+}
+
+/**
+ * @brief  显示一位小数的定点数
+ * @details 以"整数.小数"格式显示，例如湿度45.0，输入直接使用
+ *         DHT11的整数/小数两部分，无需任何浮点运算
+ * @param  Line 起始行号，范围1~4
+ * @param  Column 起始列号，范围1~16
+ * @param  Integer 整数部分
+ * @param  Decimal 小数部分（一位），范围0~9
+ * @param  IntLength 整数部分显示长度，范围1~10
+ * @return 无
+ */
+void OLED_ShowFixedNum(uint8_t Line, uint8_t Column, uint32_t Integer, uint8_t Decimal, uint8_t IntLength)
+{
+    char buf[12];
+    OLED_FormatDec(buf, Integer, IntLength);
+    buf[IntLength]     = '.';
+    buf[IntLength + 1] = Decimal + '0';
+    OLED_ShowChars(Line, Column, buf, IntLength + 2);
 }
 
+/**
+ * @brief OLED初始化命令序列
+ */
+static const uint8_t OLED_InitCmds[] = {
+    0xAE,       // 关闭显示
+    0xD5, 0x80, // 设置显示时钟分频比/振荡器频率
+    0xA8, 0x3F, // 设置多路复用率
+    0xD3, 0x00, // 设置显示偏移
+    0x40,       // 设置显示开始行
+    0xA1,       // 设置左右方向，0xA1正常 0xA0左右反置
+    0xC8,       // 设置上下方向，0xC8正常 0xC0上下反置
+    0xDA, 0x12, // 设置COM引脚硬件配置
+    0x81, 0xCF, // 设置对比度控制
+    0xD9, 0xF1, // 设置预充电周期
+    0xDB, 0x30, // 设置VCOMH取消选择级别
+    0xA4,       // 设置整个显示打开/关闭
+    0xA6,       // 设置正常/倒转显示
+    0x8D, 0x14, // 设置充电泵
+    0xAF,       // 开启显示
+};
+
 /**
  * @brief  OLED显示屏初始化
  * @details 完成以下配置：
  *         1. 初始化I2C接口
- *         2. 发送显示配置命令序列：
+ *         2. 在一次命令连续传输中发送显示配置序列：
  *            - 关显示
  *            - 设置时钟分频
  *            - 设置多路复用率
@@ -336,57 +1062,21 @@ void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Leng
  *            - 设置预充电周期
  *            - 设置COM引脚硬件配置
  *            - 开显示
+ *         3. 清空显存，整屏标记为脏区
+ * @note   调用前屏幕需已上电至少OLED_POWERUP_MS毫秒，由调用者基于定时器等待，
+ *         等待期间可先初始化其他外设。
+ *         此函数不刷新屏幕，清屏内容与第一帧画面在第一次OLED_Update时一起发送
  * @param  无
  * @return 无
  */
 void OLED_Init(void)
 {
-    uint32_t i, j;
-
-    for (i = 0; i < 1000; i++) // 上电延时
-    {
-        for (j = 0; j < 1000; j++);
-    }
-
     OLED_I2C_Init(); // 端口初始化
 
-    OLED_WriteCommand(0xAE); // 关闭显示
-
-    OLED_WriteCommand(0xD5); // 设置显示时钟分频比/振荡器频率
-    OLED_WriteCommand(0x80);
-
-    OLED_WriteCommand(0xA8); // 设置多路复用率
-    OLED_WriteCommand(0x3F);
-
-    OLED_WriteCommand(0xD3); // 设置显示偏移
-    OLED_WriteCommand(0x00);
-
-    OLED_WriteCommand(0x40); // 设置显示开始行
-
-    OLED_WriteCommand(0xA1); // 设置左右方向，0xA1正常 0xA0左右反置
-
-    OLED_WriteCommand(0xC8); // 设置上下方向，0xC8正常 0xC0上下反置
-
-    OLED_WriteCommand(0xDA); // 设置COM引脚硬件配置
-    OLED_WriteCommand(0x12);
-
-    OLED_WriteCommand(0x81); // 设置对比度控制
-    OLED_WriteCommand(0xCF);
-
-    OLED_WriteCommand(0xD9); // 设置预充电周期
-    OLED_WriteCommand(0xF1);
-
-    OLED_WriteCommand(0xDB); // 设置VCOMH取消选择级别
-    OLED_WriteCommand(0x30);
-
-    OLED_WriteCommand(0xA4); // 设置整个显示打开/关闭
-
-    OLED_WriteCommand(0xA6); // 设置正常/倒转显示
-
-    OLED_WriteCommand(0x8D); // 设置充电泵
-    OLED_WriteCommand(0x14);
-
-    OLED_WriteCommand(0xAF); // 开启显示
+    if (OLED_BurstBegin(OLED_BURST_COMMAND)) { // 整个配置序列在一次命令传输中发送
+        OLED_BurstWrite(OLED_InitCmds, sizeof(OLED_InitCmds));
+        OLED_BurstEnd();
+    }
 
-    OLED_Clear(); // OLED清屏
+    OLED_Clear(); // 清空显存并标记整屏脏区，由第一帧的刷新一并发送
 }
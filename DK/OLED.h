@@ -15,22 +15,138 @@
 #ifndef __OLED_H
 #define __OLED_H
 
+#include <stdint.h>
+
+/**
+ * @brief OLED通信后端选择
+ * @note  0：软件模拟I2C，刷新阻塞
+ *        1：硬件I2C1（PB8/PB9重映射，400kHz）+ DMA1_Channel6，刷新在后台进行
+ */
+#ifndef OLED_USE_HW_I2C
+#define OLED_USE_HW_I2C 0
+#endif
+
+/**
+ * @brief 屏幕上电到可以接收初始化命令所需的时间（毫秒）
+ */
+#ifndef OLED_POWERUP_MS
+#define OLED_POWERUP_MS 20
+#endif
+
+/**
+ * @brief OLED显存尺寸定义
+ */
+#define OLED_WIDTH    128 /**< 列数（像素） */
+#define OLED_PAGE_NUM 8   /**< 页数，每页8行像素 */
+
+/**
+ * @brief OLED_UpdateStep每步最多发送的列数，决定分段刷新的时间粒度
+ */
+#ifndef OLED_FLUSH_CHUNK
+#define OLED_FLUSH_CHUNK 32
+#endif
+
+/**
+ * @brief 连续传输控制字节
+ */
+#define OLED_BURST_COMMAND 0x00 /**< 后续字节均为命令 */
+#define OLED_BURST_DATA    0x40 /**< 后续字节均为显示数据 */
+
 /**
  * @brief  OLED初始化
- * @details 包括I2C接口初始化和显示参数配置
+ * @details 包括I2C接口初始化和显示参数配置，并清空显存（不刷新屏幕）
+ * @note   调用前屏幕需已上电至少OLED_POWERUP_MS毫秒
  * @param  无
  * @return 无
  */
 void OLED_Init(void);
 
+/**
+ * @brief  开始一次连续传输
+ * @param  Control 控制字节，OLED_BURST_COMMAND或OLED_BURST_DATA
+ * @return uint8_t 1-成功；0-总线不可用（仅硬件I2C），此时不得调用OLED_BurstWrite/OLED_BurstEnd
+ */
+uint8_t OLED_BurstBegin(uint8_t Control);
+
+/**
+ * @brief  在连续传输中发送N个字节
+ * @param  Data 数据指针
+ * @param  Count 字节数
+ * @return 无
+ */
+void OLED_BurstWrite(const uint8_t *Data, uint16_t Count);
+
+/**
+ * @brief  结束一次连续传输
+ * @return 无
+ */
+void OLED_BurstEnd(void);
+
 /**
  * @brief  清空显示
- * @details 将显存中所有数据清零
+ * @details 将显存中所有数据清零，并标记整屏待刷新
  * @param  无
  * @return 无
  */
 void OLED_Clear(void);
 
+/**
+ * @brief  刷新显示
+ * @details 将显存中发生变化的区域发送到屏幕，每帧调用一次；
+ *         硬件I2C后端下只启动后台传输，立即返回
+ * @param  无
+ * @return 无
+ */
+void OLED_Update(void);
+
+/**
+ * @brief  分段刷新显存脏区
+ * @details 软件I2C：发送第一个脏页中最多OLED_FLUSH_CHUNK列后返回，
+ *         未发送的部分保留为脏区，可分多次（跨帧）完成刷新；
+ *         硬件I2C：空闲时启动一次后台刷新，忙时不做任何事
+ * @param  无
+ * @return uint8_t 1-本帧内继续调用可以推进刷新，0-已无可推进的工作
+ */
+uint8_t OLED_UpdateStep(void);
+
+/**
+ * @brief  获取尚未刷新的脏页
+ * @param  无
+ * @return uint8_t 脏页位图，bit n对应第n页
+ */
+uint8_t OLED_GetDirtyPages(void);
+
+/**
+ * @brief  查询刷新是否正在进行
+ * @return 1：后台刷新中（仅硬件I2C后端）；0：空闲
+ */
+uint8_t OLED_IsBusy(void);
+
+/**
+ * @brief  注册刷新完成回调
+ * @details 硬件I2C后端在DMA中断中调用，软件I2C后端在OLED_Update返回前调用
+ * @param  Callback 回调函数，传入0取消注册
+ * @return 无
+ */
+void OLED_SetFlushCallback(void (*Callback)(void));
+
+/**
+ * @brief  获取I2C总线累计发送字节数
+ * @details 用于统计刷新开销（含地址和控制字节）
+ * @param  无
+ * @return uint32_t 累计字节数
+ */
+uint32_t OLED_GetBusBytes(void);
+
+/**
+ * @brief  向显存写入一列（8个像素）
+ * @param  Page 页地址，范围0~7
+ * @param  X 列地址，范围0~127
+ * @param  Data 列数据，低位在上
+ * @return 无
+ */
+void OLED_DrawColumn(uint8_t Page, uint8_t X, uint8_t Data);
+
 /**
  * @brief  显示一个字符
  * @param  Line 行号，范围1~4
@@ -89,4 +205,15 @@ void OLED_ShowHexNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Leng
  */
 void OLED_ShowBinNum(uint8_t Line, uint8_t Column, uint32_t Number, uint8_t Length);
 
+/**
+ * @brief  显示一位小数的定点数（整数.小数）
+ * @param  Line 起始行号，范围1~4
+ * @param  Column 起始列号，范围1~16
+ * @param  Integer 整数部分
+ * @param  Decimal 小数部分，范围0~9
+ * @param  IntLength 整数部分显示长度，范围1~10
+ * @return 无
+ */
+void OLED_ShowFixedNum(uint8_t Line, uint8_t Column, uint32_t Integer, uint8_t Decimal, uint8_t IntLength);
+
 #endif /* __OLED_H */
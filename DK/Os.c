@@ -0,0 +1,691 @@
+/**
+ * @file     Os.c
+ * @brief    抢占式内核
+ * @details  面向20KB RAM的小型优先级抢占内核：
+ *          - 线程控制块和栈由使用者静态分配，线程表按优先级排序，
+ *            调度时选择第一个就绪线程，同优先级按创建顺序
+ *          - 线程运行在PSP上，中断使用MSP；PendSV（最低优先级）保存R4~R11并切换栈指针
+ *          - 无周期节拍：SysTick作为单次定时器，只在最早的休眠或超时到期时中断一次，
+ *            时刻取自TIM4时基
+ *          - 信号量可在中断中释放，释放时直接交给等待中优先级最高的线程；
+ *            消息队列由两个信号量和一段环形缓冲组成
+ *          - 顺序锁供单写者、多读者的共享数据使用，写者不等待，读者读到写入前后不一致时重读
+ *          - 没有就绪线程时运行空闲线程，由空闲钩子负责休眠
+ *          内核数据只在关中断的临界区内修改，临界区均很短
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>    // memcpy
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+OsThread_t *volatile Os_Current = 0; /**< 当前运行的线程 */
+OsThread_t *volatile Os_Next    = 0; /**< PendSV将要切换到的线程 */
+
+static OsThread_t *Os_Threads[OS_MAX_THREADS + 1]; /**< 线程表，按优先级从高到低排列 */
+static uint8_t Os_ThreadNum   = 0;                  /**< 线程数量 */
+static uint8_t Os_LockCount   = 0;                  /**< 调度锁嵌套深度 */
+static uint8_t Os_Running     = 0;                  /**< 内核已启动 */
+static void (*Os_IdleHook)(void) = 0;               /**< 空闲钩子 */
+static OsThread_t *Os_Previous = 0;                 /**< 最近一次切换前运行的线程 */
+static uint32_t Os_SwitchTime  = 0;                 /**< 最近一次切换的时刻（微秒） */
+
+static OsThread_t Os_IdleThread;                   /**< 空闲线程 */
+static uint32_t Os_IdleStack[OS_IDLE_STACK_WORDS]; /**< 空闲线程栈 */
+
+/**
+ * @brief  判断时刻是否已到达
+ * @details 按有符号差值比较，计数器回绕时仍然正确
+ */
+#define OS_REACHED(now, t) ((int32_t)((now) - (t)) >= 0)
+
+/**
+ * @brief SysTick每微秒的计数（HCLK/8）
+ */
+#define OS_SYSTICK_PER_US (SystemCoreClock / 8000000)
+
+/**
+ * @brief  进入临界区（关中断）
+ * @param  无
+ * @return uint32_t 进入前的中断屏蔽状态
+ */
+uint32_t Os_EnterCritical(void)
+{
+    uint32_t state = __get_PRIMASK();
+
+    __disable_irq();
+    return state;
+}
+
+/**
+ * @brief  退出临界区
+ * @param  State Os_EnterCritical的返回值
+ * @return 无
+ */
+void Os_ExitCritical(uint32_t State)
+{
+    __set_PRIMASK(State);
+}
+
+/**
+ * @brief  选择下一个运行的线程
+ * @details 须在临界区内调用。选出的线程不是当前线程时挂起PendSV，
+ *         PendSV在退出临界区且没有其他中断时执行切换
+ * @param  无
+ * @return 无
+ */
+static void Os_Schedule(void)
+{
+    uint8_t i;
+
+    if (!Os_Running || Os_LockCount) return;
+
+    for (i = 0; i < Os_ThreadNum; i++) {
+        if (Os_Threads[i]->State == OS_READY) break;
+    }
+    if (i == Os_ThreadNum) return;
+
+    Os_Next = Os_Threads[i];
+    if (Os_Next != Os_Current) {
+        Os_Next->Switches++;
+        Os_Previous   = Os_Current;
+        Os_SwitchTime = Timer_GetMicros();
+        SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+    }
+}
+
+/**
+ * @brief  设置下一次定时
+ * @details 须在临界区内调用：
+ *         1. 找出所有定时等待中最早的唤醒时刻，最多OS_ALARM_MAX_MS
+ *         2. 按微秒换算到该毫秒边界的SysTick计数，已到期的立即触发
+ *         3. 没有定时等待时关闭SysTick
+ * @param  无
+ * @return 无
+ */
+static void Os_SetAlarm(void)
+{
+    uint16_t frac;
+    uint32_t now = Timer_GetMillisFrac(&frac);
+    int32_t left, min = OS_ALARM_MAX_MS;
+    uint32_t delay_us;
+    uint8_t found = 0;
+    uint8_t i;
+
+    for (i = 0; i < Os_ThreadNum; i++) {
+        if (Os_Threads[i]->State != OS_READY && Os_Threads[i]->Timed) {
+            left = (int32_t)(Os_Threads[i]->WakeTime - now);
+            if (left < min) min = left;
+            found = 1;
+        }
+    }
+
+    if (!found) {
+        SysTick->CTRL = 0;
+        return;
+    }
+
+    delay_us = (min > 0) ? (uint32_t)min * 1000 - frac : 1;
+
+    SysTick->CTRL = 0;
+    SysTick->LOAD = delay_us * OS_SYSTICK_PER_US - 1;
+    SysTick->VAL  = 0;
+    SysTick->CTRL = SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+}
+
+/**
+ * @brief  使当前线程进入等待
+ * @details 须在临界区内调用，退出临界区后切换到其他线程
+ * @param  State OS_SLEEPING或OS_BLOCKED
+ * @param  WakeTime 唤醒或超时时刻（毫秒）
+ * @param  Timed 是否带超时
+ * @return 无
+ */
+static void Os_Wait(uint8_t State, uint32_t WakeTime, uint8_t Timed)
+{
+    Os_Current->State    = State;
+    Os_Current->WakeTime = WakeTime;
+    Os_Current->Timed    = Timed;
+    Os_Schedule();
+    if (Timed) Os_SetAlarm();
+}
+
+/**
+ * @brief  使等待中的线程就绪
+ * @param  Thread 线程
+ * @param  Result 等待结果：1-得到信号量，0-超时
+ * @return 无
+ */
+static void Os_Ready(OsThread_t *Thread, uint8_t Result)
+{
+    Thread->State      = OS_READY;
+    Thread->Timed      = 0;
+    Thread->WaitObj    = 0;
+    Thread->WaitResult = Result;
+}
+
+/**
+ * @brief  线程函数返回后的去处
+ * @details 线程不再参与调度
+ */
+static void Os_ThreadExit(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    Os_Current->State = OS_DEAD;
+    Os_Schedule();
+    Os_ExitCritical(state);
+    while (1);
+}
+
+/**
+ * @brief  空闲线程
+ * @details 反复调用空闲钩子，钩子不能调用会阻塞的函数
+ */
+static void Os_IdleEntry(void)
+{
+    while (1) {
+        if (Os_IdleHook) Os_IdleHook();
+    }
+}
+
+/**
+ * @brief  创建线程
+ * @details 整个栈先填充OS_STACK_FILL，用于统计栈的最大使用量；栈顶按8字节对齐，依次放入：
+ *         1. 硬件异常帧：xPSR（Thumb位）、PC（线程函数）、LR（Os_ThreadExit）、R12、R3~R0
+ *         2. 软件保存的R4~R11
+ *         线程表按优先级插入，同优先级排在已有线程之后
+ * @param  Thread 线程控制块
+ * @param  Name 线程名称
+ * @param  Entry 线程函数
+ * @param  Stack 栈空间
+ * @param  StackWords 栈大小（字）
+ * @param  Priority 优先级
+ * @return uint8_t 1-成功，0-线程数已满
+ */
+uint8_t Os_ThreadCreate(OsThread_t *Thread, const char *Name, void (*Entry)(void),
+                        uint32_t *Stack, uint16_t StackWords, uint8_t Priority)
+{
+    uint32_t *sp = Stack + StackWords;
+    uint8_t i;
+
+    if (Os_ThreadNum >= OS_MAX_THREADS + (Thread == &Os_IdleThread)) return 0;
+
+    while (sp > Stack) *--sp = OS_STACK_FILL;
+    sp = Stack + StackWords;
+    if ((uintptr_t)sp & 4) sp--;
+    *--sp = 0x01000000;                        // xPSR
+    *--sp = (uint32_t)(uintptr_t)Entry;        // PC
+    *--sp = (uint32_t)(uintptr_t)Os_ThreadExit; // LR
+    for (i = 0; i < 13; i++) *--sp = 0;       // R12、R3~R0、R11~R4
+
+    Thread->Sp         = sp;
+    Thread->Name       = Name;
+    Thread->Stack      = Stack;
+    Thread->StackWords = StackWords;
+    Thread->Priority   = Priority;
+    Thread->State      = OS_READY;
+    Thread->Timed      = 0;
+    Thread->WaitResult = 0;
+    Thread->WaitObj    = 0;
+    Thread->WakeTime   = 0;
+    Thread->Switches   = 0;
+    Thread->Overruns   = 0;
+
+    for (i = Os_ThreadNum; i > 0 && Os_Threads[i - 1]->Priority > Priority; i--) {
+        Os_Threads[i] = Os_Threads[i - 1];
+    }
+    Os_Threads[i] = Thread;
+    Os_ThreadNum++;
+    return 1;
+}
+
+/**
+ * @brief  启动内核
+ * @details 启动过程：
+ *         1. 创建空闲线程
+ *         2. PendSV和SysTick设为最低优先级，不抢占任何外设中断
+ *         3. PSP清零，PendSV据此识别第一次切换，不保存主程序的上下文
+ *         4. 选出最高优先级线程并挂起PendSV，开中断后立即切换，主程序的栈此后只供中断使用
+ * @param  IdleHook 空闲钩子
+ * @return 无
+ */
+void Os_Start(void (*IdleHook)(void))
+{
+    Os_IdleHook = IdleHook;
+    Os_ThreadCreate(&Os_IdleThread, "idle", Os_IdleEntry, Os_IdleStack,
+                    OS_IDLE_STACK_WORDS, OS_IDLE_PRIORITY);
+
+    NVIC_SetPriority(PendSV_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+    NVIC_SetPriority(SysTick_IRQn, (1 << __NVIC_PRIO_BITS) - 1);
+
+    __disable_irq();
+    __set_PSP(0);
+    Os_Running = 1;
+    Os_Schedule();
+    Os_SetAlarm();
+    __enable_irq();
+
+    while (1);
+}
+
+/**
+ * @brief  休眠
+ * @param  Ms 毫秒数
+ * @return 无
+ */
+void Os_Sleep(uint32_t Ms)
+{
+    uint32_t state;
+
+    if (Ms == 0) return;
+
+    state = Os_EnterCritical();
+    Os_Wait(OS_SLEEPING, Timer_GetMillis() + Ms, 1);
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  按固定周期休眠
+ * @param  Wake 上一次唤醒时刻（毫秒）
+ * @param  Period 周期（毫秒）
+ * @return uint32_t 本次跳过的周期数
+ */
+uint32_t Os_SleepUntil(uint32_t *Wake, uint32_t Period)
+{
+    uint32_t now    = Timer_GetMillis();
+    uint32_t missed = 0;
+    uint32_t state;
+
+    *Wake += Period;
+    while (OS_REACHED(now, *Wake)) {
+        *Wake += Period;
+        missed++;
+    }
+
+    state = Os_EnterCritical();
+    Os_Current->Overruns += missed;
+    Os_Wait(OS_SLEEPING, *Wake, 1);
+    Os_ExitCritical(state);
+
+    return missed;
+}
+
+/**
+ * @brief  禁止线程切换
+ * @param  无
+ * @return 无
+ */
+void Os_SchedLock(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    Os_LockCount++;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  允许线程切换
+ * @param  无
+ * @return 无
+ */
+void Os_SchedUnlock(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    if (Os_LockCount && --Os_LockCount == 0) Os_Schedule();
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  处理超时
+ * @details 唤醒所有到期的休眠线程和等待超时的线程，再重新选择线程和设置定时；
+ *         SysTick可能因定时分段而提前触发，此时只重新设置定时
+ * @param  无
+ * @return 无
+ */
+void Os_Tick(void)
+{
+    uint32_t state = Os_EnterCritical();
+    uint32_t now   = Timer_GetMillis();
+    OsThread_t *thread;
+    uint8_t i;
+
+    for (i = 0; i < Os_ThreadNum; i++) {
+        thread = Os_Threads[i];
+        if (thread->State != OS_READY && thread->Timed && OS_REACHED(now, thread->WakeTime)) {
+            Os_Ready(thread, 0);
+        }
+    }
+    Os_Schedule();
+    Os_SetAlarm();
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  SysTick中断服务函数
+ * @note   此函数会被硬件自动调用
+ */
+void SysTick_Handler(void)
+{
+    Os_Tick();
+}
+
+/**
+ * @brief  获取空闲时间
+ * @param  无
+ * @return uint32_t 距最早唤醒的毫秒数
+ */
+uint32_t Os_GetIdleTime(void)
+{
+    uint32_t now  = Timer_GetMillis();
+    uint32_t idle = 0xFFFFFFFF;
+    int32_t left;
+    uint8_t i;
+
+    for (i = 0; i < Os_ThreadNum; i++) {
+        if (Os_Threads[i] == &Os_IdleThread) continue;
+        if (Os_Threads[i]->State == OS_READY) return 0;
+        if (Os_Threads[i]->Timed) {
+            left = (int32_t)(Os_Threads[i]->WakeTime - now);
+            if (left <= 0) return 0;
+            if ((uint32_t)left < idle) idle = (uint32_t)left;
+        }
+    }
+    return idle;
+}
+
+/**
+ * @brief  获取线程数量
+ * @param  无
+ * @return uint8_t 线程数量
+ */
+uint8_t Os_GetThreadNum(void)
+{
+    return Os_ThreadNum;
+}
+
+/**
+ * @brief  获取线程控制块
+ * @param  Index 线程序号
+ * @return const OsThread_t* 线程控制块
+ */
+const OsThread_t *Os_GetThread(uint8_t Index)
+{
+    return Os_Threads[Index];
+}
+
+/**
+ * @brief  获取线程栈的剩余量
+ * @param  Thread 线程控制块
+ * @return uint16_t 从未使用过的栈（字）
+ */
+uint16_t Os_GetStackFree(const OsThread_t *Thread)
+{
+    uint16_t free = 0;
+
+    while (free < Thread->StackWords && Thread->Stack[free] == OS_STACK_FILL) free++;
+    return free;
+}
+
+/**
+ * @brief  获取最近一次线程切换
+ * @param  Time 切换时刻（微秒）
+ * @return const OsThread_t* 切换前运行的线程
+ */
+const OsThread_t *Os_GetLastSwitch(uint32_t *Time)
+{
+    uint32_t state = Os_EnterCritical();
+    const OsThread_t *previous = Os_Previous;
+
+    *Time = Os_SwitchTime;
+    Os_ExitCritical(state);
+    return previous;
+}
+
+/**
+ * @brief  初始化信号量
+ * @param  Sem 信号量
+ * @param  Count 初始计数
+ * @param  Max 最大计数
+ * @return 无
+ */
+void Os_SemInit(OsSem_t *Sem, uint16_t Count, uint16_t Max)
+{
+    Sem->Count = Count;
+    Sem->Max   = Max;
+}
+
+/**
+ * @brief  获取信号量
+ * @details 计数不为0时减1返回；否则阻塞，直到被释放者唤醒（结果为1）或超时（结果为0）
+ * @param  Sem 信号量
+ * @param  Timeout 超时（毫秒）
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_SemTake(OsSem_t *Sem, uint32_t Timeout)
+{
+    uint32_t state = Os_EnterCritical();
+
+    if (Sem->Count > 0) {
+        Sem->Count--;
+        Os_ExitCritical(state);
+        return 1;
+    }
+    if (Timeout == 0) {
+        Os_ExitCritical(state);
+        return 0;
+    }
+
+    Os_Current->WaitObj    = Sem;
+    Os_Current->WaitResult = 0;
+    Os_Wait(OS_BLOCKED, Timer_GetMillis() + Timeout, Timeout != OS_WAIT_FOREVER);
+    Os_ExitCritical(state);
+
+    return Os_Current->WaitResult;
+}
+
+/**
+ * @brief  释放信号量
+ * @param  Sem 信号量
+ * @return 无
+ */
+void Os_SemGive(OsSem_t *Sem)
+{
+    uint32_t state = Os_EnterCritical();
+    uint8_t i;
+
+    for (i = 0; i < Os_ThreadNum; i++) {
+        if (Os_Threads[i]->State == OS_BLOCKED && Os_Threads[i]->WaitObj == Sem) {
+            Os_Ready(Os_Threads[i], 1);
+            Os_Schedule();
+            Os_ExitCritical(state);
+            return;
+        }
+    }
+    if (Sem->Count < Sem->Max) Sem->Count++;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  初始化消息队列
+ * @param  Queue 队列
+ * @param  Buf 缓冲区
+ * @param  ItemSize 每条消息的字节数
+ * @param  Capacity 消息条数
+ * @return 无
+ */
+void Os_QueueInit(OsQueue_t *Queue, void *Buf, uint16_t ItemSize, uint16_t Capacity)
+{
+    Queue->Buf      = (uint8_t *)Buf;
+    Queue->ItemSize = ItemSize;
+    Queue->Capacity = Capacity;
+    Queue->Head     = 0;
+    Queue->Tail     = 0;
+    Os_SemInit(&Queue->Items, 0, Capacity);
+    Os_SemInit(&Queue->Spaces, Capacity, Capacity);
+}
+
+/**
+ * @brief  发送消息
+ * @details 先取得一个空位，在临界区内写入消息，再释放一条消息计数
+ * @param  Queue 队列
+ * @param  Item 消息
+ * @param  Timeout 超时（毫秒）
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_QueueSend(OsQueue_t *Queue, const void *Item, uint32_t Timeout)
+{
+    uint32_t state;
+
+    if (!Os_SemTake(&Queue->Spaces, Timeout)) return 0;
+
+    state = Os_EnterCritical();
+    memcpy(Queue->Buf + Queue->Head * Queue->ItemSize, Item, Queue->ItemSize);
+    if (++Queue->Head >= Queue->Capacity) Queue->Head = 0;
+    Os_ExitCritical(state);
+
+    Os_SemGive(&Queue->Items);
+    return 1;
+}
+
+/**
+ * @brief  接收消息
+ * @details 先取得一条消息，在临界区内读出，再释放一个空位
+ * @param  Queue 队列
+ * @param  Item 接收缓冲
+ * @param  Timeout 超时（毫秒）
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_QueueReceive(OsQueue_t *Queue, void *Item, uint32_t Timeout)
+{
+    uint32_t state;
+
+    if (!Os_SemTake(&Queue->Items, Timeout)) return 0;
+
+    state = Os_EnterCritical();
+    memcpy(Item, Queue->Buf + Queue->Tail * Queue->ItemSize, Queue->ItemSize);
+    if (++Queue->Tail >= Queue->Capacity) Queue->Tail = 0;
+    Os_ExitCritical(state);
+
+    Os_SemGive(&Queue->Spaces);
+    return 1;
+}
+
+/**
+ * @brief  开始写入顺序锁保护的数据
+ * @param  Seq 顺序锁
+ * @return 无
+ */
+void Os_SeqWriteBegin(OsSeq_t *Seq)
+{
+    Os_SchedLock();
+    Seq->Seq++;
+    __DMB(); // 计数先于数据可见
+}
+
+/**
+ * @brief  结束写入
+ * @param  Seq 顺序锁
+ * @return 无
+ */
+void Os_SeqWriteEnd(OsSeq_t *Seq)
+{
+    __DMB(); // 数据先于计数可见
+    Seq->Seq++;
+    Os_SchedUnlock();
+}
+
+/**
+ * @brief  开始读取顺序锁保护的数据
+ * @details 写入期间锁定调度，线程读者不会在写入中途运行，
+ *         等待奇数计数的循环只是保险，实际不会执行
+ * @param  Seq 顺序锁
+ * @return uint32_t 读取开始时的计数
+ */
+uint32_t Os_SeqReadBegin(const OsSeq_t *Seq)
+{
+    uint32_t start;
+
+    do {
+        start = Seq->Seq;
+    } while (start & 1);
+    __DMB(); // 先读计数再读数据
+    return start;
+}
+
+/**
+ * @brief  检查读取期间是否有写入
+ * @param  Seq 顺序锁
+ * @param  Start Os_SeqReadBegin返回的计数
+ * @return uint8_t 1-有写入，应重读；0-数据一致
+ */
+uint8_t Os_SeqReadRetry(const OsSeq_t *Seq, uint32_t Start)
+{
+    __DMB(); // 先读完数据再读计数
+    return Seq->Seq != Start;
+}
+
+/**
+ * @brief  PendSV中断服务函数：线程切换
+ * @details 切换过程（关中断进行）：
+ *         1. PSP为0表示第一次切换，跳过保存
+ *         2. 在当前线程栈上压入R4~R11，栈指针存入Os_Current->Sp
+ *         3. Os_Current = Os_Next，从其栈上弹出R4~R11并设置PSP
+ *         4. 以线程模式、PSP返回，硬件弹出其余寄存器
+ * @note   此函数会被硬件自动调用
+ */
+#if defined(__CC_ARM)
+__asm void PendSV_Handler(void)
+{
+    extern Os_Current;
+    extern Os_Next;
+
+    PRESERVE8
+
+    CPSID   I
+    MRS     R0, PSP
+    CBZ     R0, Os_PendSV_Restore
+    STMDB   R0!, {R4-R11}
+    LDR     R1, =Os_Current
+    LDR     R1, [R1]
+    STR     R0, [R1]
+Os_PendSV_Restore
+    LDR     R0, =Os_Current
+    LDR     R1, =Os_Next
+    LDR     R2, [R1]
+    STR     R2, [R0]
+    LDR     R0, [R2]
+    LDMIA   R0!, {R4-R11}
+    MSR     PSP, R0
+    ORR     LR, LR, #0x04
+    CPSIE   I
+    BX      LR
+    ALIGN
+}
+#else
+__attribute__((naked)) void PendSV_Handler(void)
+{
+    __asm volatile(
+        "cpsid   i                 \n"
+        "mrs     r0, psp           \n"
+        "cbz     r0, 1f            \n"
+        "stmdb   r0!, {r4-r11}     \n"
+        "ldr     r1, =Os_Current   \n"
+        "ldr     r1, [r1]          \n"
+        "str     r0, [r1]          \n"
+        "1:                        \n"
+        "ldr     r0, =Os_Current   \n"
+        "ldr     r1, =Os_Next      \n"
+        "ldr     r2, [r1]          \n"
+        "str     r2, [r0]          \n"
+        "ldr     r0, [r2]          \n"
+        "ldmia   r0!, {r4-r11}     \n"
+        "msr     psp, r0           \n"
+        "orr     lr, lr, #4        \n"
+        "cpsie   i                 \n"
+        "bx      lr                \n");
+}
+#endif
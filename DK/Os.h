@@ -0,0 +1,332 @@
+/**
+ * @file     Os.h
+ * @brief    抢占式内核头文件
+ * @details  定义了内核相关的：
+ *          - 线程控制块、信号量与消息队列结构
+ *          - 线程创建与启动接口
+ *          - 休眠、调度锁与临界区接口
+ *          - 信号量与消息队列接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __OS_H
+#define __OS_H
+
+#include <stdint.h>
+
+/**
+ * @brief 最大线程数（不含空闲线程）
+ */
+#ifndef OS_MAX_THREADS
+#define OS_MAX_THREADS 5
+#endif
+
+/**
+ * @brief 空闲线程栈大小（字）
+ */
+#ifndef OS_IDLE_STACK_WORDS
+#define OS_IDLE_STACK_WORDS 96
+#endif
+
+/**
+ * @brief 单次定时的最长时间（毫秒）
+ * @details SysTick以HCLK/8计数，24位最多约1.86s；更远的超时分段定时
+ */
+#ifndef OS_ALARM_MAX_MS
+#define OS_ALARM_MAX_MS 1000
+#endif
+
+/**
+ * @brief 栈填充值
+ * @details 创建线程时整个栈先填充此值，从栈底起仍为此值的部分即从未使用过的栈
+ */
+#define OS_STACK_FILL 0xA5A5A5A5
+
+/**
+ * @brief 永久等待
+ */
+#define OS_WAIT_FOREVER 0xFFFFFFFF
+
+/**
+ * @brief 空闲线程优先级（最低）
+ */
+#define OS_IDLE_PRIORITY 0xFF
+
+/**
+ * @brief 线程状态
+ */
+typedef enum {
+    OS_READY = 0, /**< 就绪（含正在运行） */
+    OS_SLEEPING,  /**< 休眠，到WakeTime就绪 */
+    OS_BLOCKED,   /**< 等待信号量，Timed为1时到WakeTime超时 */
+    OS_DEAD       /**< 线程函数已返回 */
+} OsState_t;
+
+/**
+ * @brief 线程控制块
+ * @details 由使用者静态分配，成员由内核维护。Sp必须是第一个成员，PendSV按此偏移保存和恢复栈指针
+ */
+typedef struct {
+    uint32_t *Sp;         /**< 保存的栈指针 */
+    const char *Name;     /**< 线程名称（用于统计输出） */
+    uint32_t *Stack;      /**< 栈底（最低地址） */
+    uint16_t StackWords;  /**< 栈大小（字） */
+    uint8_t Priority;     /**< 优先级，数值越小越优先 */
+    uint8_t State;        /**< 线程状态，见OsState_t */
+    uint8_t Timed;        /**< 等待是否带超时 */
+    uint8_t WaitResult;   /**< 等待结果：1-得到信号量，0-超时 */
+    void *WaitObj;        /**< 正在等待的信号量 */
+    uint32_t WakeTime;    /**< 唤醒或超时时刻（毫秒） */
+    uint32_t Switches;    /**< 被选中切换运行的次数 */
+    uint32_t Overruns;    /**< Os_SleepUntil错过的周期数 */
+} OsThread_t;
+
+/**
+ * @brief 计数信号量
+ * @details Max为1时即二值信号量
+ */
+typedef struct {
+    volatile uint16_t Count; /**< 当前计数 */
+    uint16_t Max;            /**< 最大计数 */
+} OsSem_t;
+
+/**
+ * @brief 顺序锁
+ * @details 保护由一个线程写入、多个线程读取的多字段数据：写入前后计数各加1，
+ *         计数为奇数表示正在写入；读者记下计数后复制数据，计数变化时重读。
+ *         写入期间锁定调度，读线程不会在写入中途运行，写者从不等待
+ */
+typedef struct {
+    volatile uint32_t Seq; /**< 写入计数 */
+} OsSeq_t;
+
+/**
+ * @brief 消息队列
+ * @details 定长消息的环形缓冲，以两个信号量分别计数消息和空位
+ */
+typedef struct {
+    uint8_t *Buf;      /**< 消息缓冲，由使用者提供 */
+    uint16_t ItemSize; /**< 每条消息的字节数 */
+    uint16_t Capacity; /**< 消息条数 */
+    uint16_t Head;     /**< 写位置 */
+    uint16_t Tail;     /**< 读位置 */
+    OsSem_t Items;     /**< 已有消息数 */
+    OsSem_t Spaces;    /**< 剩余空位数 */
+} OsQueue_t;
+
+/**
+ * @brief 当前运行的线程
+ */
+extern OsThread_t *volatile Os_Current;
+
+/**
+ * @brief  创建线程
+ * @details 在栈顶构造初始异常帧，线程在Os_Start之后才开始运行；须在Os_Start之前调用
+ * @param  Thread 线程控制块
+ * @param  Name 线程名称
+ * @param  Entry 线程函数，不应返回
+ * @param  Stack 栈空间
+ * @param  StackWords 栈大小（字）
+ * @param  Priority 优先级，数值越小越优先
+ * @return uint8_t 1-成功，0-线程数已满
+ */
+uint8_t Os_ThreadCreate(OsThread_t *Thread, const char *Name, void (*Entry)(void),
+                        uint32_t *Stack, uint16_t StackWords, uint8_t Priority);
+
+/**
+ * @brief  启动内核
+ * @details 创建空闲线程并切换到优先级最高的线程，不再返回
+ * @param  IdleHook 空闲线程反复调用的函数，可为0
+ * @return 无
+ */
+void Os_Start(void (*IdleHook)(void));
+
+/**
+ * @brief  休眠
+ * @details 休眠到Ms个毫秒边界之后，实际休眠时间为Ms-1到Ms毫秒
+ * @param  Ms 毫秒数，0时立即返回
+ * @return 无
+ */
+void Os_Sleep(uint32_t Ms);
+
+/**
+ * @brief  按固定周期休眠
+ * @details 唤醒时刻按*Wake += Period推进，不受线程执行时间影响；
+ *         已落后一个周期以上时跳过错过的周期并计入超限次数，保持原有相位
+ * @param  Wake 上一次唤醒时刻（毫秒），首次调用前设为当前时刻
+ * @param  Period 周期（毫秒）
+ * @return uint32_t 本次跳过的周期数
+ */
+uint32_t Os_SleepUntil(uint32_t *Wake, uint32_t Period);
+
+/**
+ * @brief  禁止线程切换
+ * @details 可嵌套，中断仍然响应；锁定期间不能调用会阻塞的函数
+ * @param  无
+ * @return 无
+ */
+void Os_SchedLock(void);
+
+/**
+ * @brief  允许线程切换
+ * @details 最外层解锁时切换到锁定期间就绪的高优先级线程
+ * @param  无
+ * @return 无
+ */
+void Os_SchedUnlock(void);
+
+/**
+ * @brief  进入临界区（关中断）
+ * @param  无
+ * @return uint32_t 进入前的中断屏蔽状态，交给Os_ExitCritical恢复
+ */
+uint32_t Os_EnterCritical(void);
+
+/**
+ * @brief  退出临界区
+ * @param  State Os_EnterCritical的返回值
+ * @return 无
+ */
+void Os_ExitCritical(uint32_t State);
+
+/**
+ * @brief  处理超时
+ * @details 唤醒到期的线程并重新设置定时，由SysTick中断调用；
+ *         时基被补偿推进后（停止模式唤醒）也应调用一次
+ * @param  无
+ * @return 无
+ */
+void Os_Tick(void);
+
+/**
+ * @brief  获取空闲时间
+ * @details 供空闲线程决定可以休眠多久，须在关中断状态下调用
+ * @param  无
+ * @return uint32_t 距最早唤醒的毫秒数；0表示已有线程就绪，没有定时等待时返回0xFFFFFFFF
+ */
+uint32_t Os_GetIdleTime(void);
+
+/**
+ * @brief  获取线程数量（含空闲线程）
+ * @param  无
+ * @return uint8_t 线程数量
+ */
+uint8_t Os_GetThreadNum(void);
+
+/**
+ * @brief  获取线程控制块（只读，用于统计输出）
+ * @details 按优先级从高到低排列
+ * @param  Index 线程序号
+ * @return const OsThread_t* 线程控制块
+ */
+const OsThread_t *Os_GetThread(uint8_t Index);
+
+/**
+ * @brief  获取线程栈的剩余量
+ * @details 从栈底向上统计仍为OS_STACK_FILL的字数，即运行以来栈的最低水位到栈底的距离
+ * @param  Thread 线程控制块
+ * @return uint16_t 从未使用过的栈（字）
+ */
+uint16_t Os_GetStackFree(const OsThread_t *Thread);
+
+/**
+ * @brief  获取最近一次线程切换
+ * @details 用于判断线程就绪后被谁推迟：切换前运行的线程即最后占用CPU的线程，
+ *         为空闲线程时说明推迟来自中断或休眠唤醒
+ * @param  Time 切换时刻（微秒）
+ * @return const OsThread_t* 切换前运行的线程，尚未切换过时为0
+ */
+const OsThread_t *Os_GetLastSwitch(uint32_t *Time);
+
+/**
+ * @brief  初始化信号量
+ * @param  Sem 信号量
+ * @param  Count 初始计数
+ * @param  Max 最大计数
+ * @return 无
+ */
+void Os_SemInit(OsSem_t *Sem, uint16_t Count, uint16_t Max);
+
+/**
+ * @brief  获取信号量
+ * @details 计数为0时阻塞等待；中断中只能以Timeout为0调用
+ * @param  Sem 信号量
+ * @param  Timeout 超时（毫秒），0表示不等待，OS_WAIT_FOREVER表示永久等待
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_SemTake(OsSem_t *Sem, uint32_t Timeout);
+
+/**
+ * @brief  释放信号量
+ * @details 有线程等待时直接交给其中优先级最高的一个，否则计数加1（不超过最大值）；
+ *         可在中断中调用
+ * @param  Sem 信号量
+ * @return 无
+ */
+void Os_SemGive(OsSem_t *Sem);
+
+/**
+ * @brief  初始化消息队列
+ * @param  Queue 队列
+ * @param  Buf 缓冲区，大小至少ItemSize * Capacity字节
+ * @param  ItemSize 每条消息的字节数
+ * @param  Capacity 消息条数
+ * @return 无
+ */
+void Os_QueueInit(OsQueue_t *Queue, void *Buf, uint16_t ItemSize, uint16_t Capacity);
+
+/**
+ * @brief  发送消息
+ * @details 队列满时阻塞等待；中断中只能以Timeout为0调用
+ * @param  Queue 队列
+ * @param  Item 消息
+ * @param  Timeout 超时（毫秒）
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_QueueSend(OsQueue_t *Queue, const void *Item, uint32_t Timeout);
+
+/**
+ * @brief  接收消息
+ * @details 队列空时阻塞等待
+ * @param  Queue 队列
+ * @param  Item 接收缓冲
+ * @param  Timeout 超时（毫秒）
+ * @return uint8_t 1-成功，0-超时
+ */
+uint8_t Os_QueueReceive(OsQueue_t *Queue, void *Item, uint32_t Timeout);
+
+/**
+ * @brief  开始写入顺序锁保护的数据
+ * @details 锁定调度并使计数变为奇数；同一数据只能有一个写线程，不能在中断中写入
+ * @param  Seq 顺序锁
+ * @return 无
+ */
+void Os_SeqWriteBegin(OsSeq_t *Seq);
+
+/**
+ * @brief  结束写入
+ * @details 使计数变为偶数并允许线程切换
+ * @param  Seq 顺序锁
+ * @return 无
+ */
+void Os_SeqWriteEnd(OsSeq_t *Seq);
+
+/**
+ * @brief  开始读取顺序锁保护的数据
+ * @details 不能在中断中读取（可能打断写入，一直等不到偶数计数）
+ * @param  Seq 顺序锁
+ * @return uint32_t 读取开始时的计数，交给Os_SeqReadRetry检查
+ */
+uint32_t Os_SeqReadBegin(const OsSeq_t *Seq);
+
+/**
+ * @brief  检查读取期间是否有写入
+ * @param  Seq 顺序锁
+ * @param  Start Os_SeqReadBegin返回的计数
+ * @return uint8_t 1-有写入，读到的数据可能不一致，应重读；0-数据一致
+ */
+uint8_t Os_SeqReadRetry(const OsSeq_t *Seq, uint32_t Start);
+
+#endif /* __OS_H */
@@ -0,0 +1,121 @@
+/**
+ * @file     Prof.c
+ * @brief    执行时间分析
+ * @details  按区域统计代码段的执行时间：
+ *          - 入口和出口读取DWT周期计数，差值即为耗时，32位计数约59秒回绕一次，差值仍然正确
+ *          - 每个区域保存次数、最短、最长、累计耗时和以2为底的对数直方图，全部在RAM中
+ *          - 报告以文本经调试串口输出，由串口命令触发
+ *          - PROF_ENABLE为0时本文件不参与编译，打点宏展开为空
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+#if PROF_ENABLE
+#include <stdio.h> // printf（调试串口输出）
+
+static ProfStats_t Prof_Stats[PROF_REGION_NUM]; /**< 各区域统计 */
+
+/**
+ * @brief 区域名称，与ProfRegion_t对应
+ */
+static const char *const Prof_Names[PROF_REGION_NUM] = {
+    "dht11", "display", "bt_send", "event", "control"};
+
+/**
+ * @brief  记录区域入口时刻
+ * @param  Region 区域编号
+ * @return 无
+ */
+void Prof_Begin(ProfRegion_t Region)
+{
+    Prof_Stats[Region].Start = Delay_GetCycles();
+}
+
+/**
+ * @brief  记录区域出口，累计本次耗时
+ * @details 直方图档位为耗时最高有效位的位置，超出范围的归入最后一档
+ * @param  Region 区域编号
+ * @return 无
+ */
+void Prof_End(ProfRegion_t Region)
+{
+    ProfStats_t *stats = &Prof_Stats[Region];
+    uint32_t cycles    = Delay_GetCycles() - stats->Start;
+    uint8_t bin        = 0;
+
+    while (bin < PROF_HIST_BINS - 1 && (cycles >> (bin + 1)) != 0) bin++;
+
+    if (stats->Count == 0 || cycles < stats->Min) stats->Min = cycles;
+    if (cycles > stats->Max) stats->Max = cycles;
+    stats->Sum += cycles;
+    stats->Count++;
+    if (stats->Hist[bin] != 0xFFFF) stats->Hist[bin]++;
+}
+
+/**
+ * @brief  读取区域统计
+ * @param  Region 区域编号
+ * @param  Stats 统计副本
+ * @return 无
+ */
+void Prof_Get(ProfRegion_t Region, ProfStats_t *Stats)
+{
+    uint32_t state = Os_EnterCritical();
+
+    *Stats = Prof_Stats[Region];
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  清除所有区域统计
+ * @param  无
+ * @return 无
+ */
+void Prof_Reset(void)
+{
+    uint32_t state = Os_EnterCritical();
+    uint8_t i, k;
+
+    for (i = 0; i < PROF_REGION_NUM; i++) {
+        Prof_Stats[i].Count = 0;
+        Prof_Stats[i].Min   = 0;
+        Prof_Stats[i].Max   = 0;
+        Prof_Stats[i].Sum   = 0;
+        for (k = 0; k < PROF_HIST_BINS; k++) Prof_Stats[i].Hist[k] = 0;
+    }
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  经调试串口输出报告
+ * @details 输出格式：
+ *         [PROF] 名称 n=次数 min=最短us avg=平均us max=最长us
+ *         [HIST] 名称 档位:次数 ...（只列出非零档位，第k档为[2^k, 2^(k+1))个周期）
+ * @param  无
+ * @return 无
+ */
+void Prof_Report(void)
+{
+    ProfStats_t stats;
+    uint32_t avg;
+    uint8_t i, k;
+
+    for (i = 0; i < PROF_REGION_NUM; i++) {
+        Prof_Get((ProfRegion_t)i, &stats);
+        avg = stats.Count ? (uint32_t)(stats.Sum / stats.Count) : 0;
+        printf("[PROF] %-7s n=%lu min=%luus avg=%luus max=%luus\r\n", Prof_Names[i],
+               (unsigned long)stats.Count, (unsigned long)(stats.Min / DELAY_CPU_MHZ),
+               (unsigned long)(avg / DELAY_CPU_MHZ), (unsigned long)(stats.Max / DELAY_CPU_MHZ));
+
+        printf("[HIST] %-7s", Prof_Names[i]);
+        for (k = 0; k < PROF_HIST_BINS; k++) {
+            if (stats.Hist[k]) printf(" %u:%u", (unsigned int)k, (unsigned int)stats.Hist[k]);
+        }
+        printf("\r\n");
+    }
+}
+#endif
@@ -0,0 +1,112 @@
+/**
+ * @file     Prof.h
+ * @brief    执行时间分析头文件
+ * @details  定义了执行时间分析相关的：
+ *          - 编译开关与直方图参数
+ *          - 分析区域编号与统计结构
+ *          - 区域打点宏与报告接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __PROF_H
+#define __PROF_H
+
+#include <stdint.h>
+
+/**
+ * @brief 执行时间分析开关
+ * @details 0：打点宏展开为空，统计代码和数据全部不参与编译（发布版本）；
+ *        1：在各区域入口和出口读取DWT周期计数，累计统计；
+ *           报告经调试串口输出，需同时开启SYS_DEBUG_SERIAL
+ */
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 0
+#endif
+
+/**
+ * @brief 直方图档数
+ * @details 第k档统计耗时在[2^k, 2^(k+1))个周期内的次数，最后一档包含更长的耗时；
+ *         24档在72MHz下覆盖到约116ms以上
+ */
+#ifndef PROF_HIST_BINS
+#define PROF_HIST_BINS 24
+#endif
+
+/**
+ * @brief 分析区域
+ */
+typedef enum {
+    PROF_DHT11 = 0,  /**< DHT11读取（DHT11_Read_TempAndHumidity） */
+    PROF_DISPLAY,    /**< 显示一帧（整理数据、渲染和分段刷新） */
+    PROF_BT_SEND,    /**< 蓝牙上报（BT_SendDataPacket） */
+    PROF_EVENT,      /**< 事件处理 */
+    PROF_CONTROL,    /**< 控制逻辑 */
+    PROF_REGION_NUM  /**< 区域数量 */
+} ProfRegion_t;
+
+/**
+ * @brief 区域统计
+ * @details 耗时单位为CPU周期，按进入到退出的实际经过时间计，包含期间被抢占的时间
+ */
+typedef struct {
+    uint32_t Start;                  /**< 本次进入时的周期计数 */
+    uint32_t Count;                  /**< 次数 */
+    uint32_t Min;                    /**< 最短耗时 */
+    uint32_t Max;                    /**< 最长耗时 */
+    uint64_t Sum;                    /**< 累计耗时，用于计算平均值 */
+    uint16_t Hist[PROF_HIST_BINS];   /**< 以2为底的对数直方图，计满后不再增加 */
+} ProfStats_t;
+
+#if PROF_ENABLE
+/**
+ * @brief 区域入口/出口打点，每个区域同一时刻只能有一个执行者
+ */
+#define PROF_BEGIN(Region) Prof_Begin(Region)
+#define PROF_END(Region)   Prof_End(Region)
+
+/**
+ * @brief  记录区域入口时刻
+ * @param  Region 区域编号
+ * @return 无
+ */
+void Prof_Begin(ProfRegion_t Region);
+
+/**
+ * @brief  记录区域出口，累计本次耗时
+ * @param  Region 区域编号
+ * @return 无
+ */
+void Prof_End(ProfRegion_t Region);
+
+/**
+ * @brief  读取区域统计
+ * @details 在临界区内复制，不会读到更新了一半的统计
+ * @param  Region 区域编号
+ * @param  Stats 统计副本
+ * @return 无
+ */
+void Prof_Get(ProfRegion_t Region, ProfStats_t *Stats);
+
+/**
+ * @brief  清除所有区域统计
+ * @param  无
+ * @return 无
+ */
+void Prof_Reset(void);
+
+/**
+ * @brief  经调试串口输出报告
+ * @details 每个区域一行次数与最短/平均/最长耗时（微秒），一行非零直方图档位；
+ *         串口发送较慢，应在低优先级线程中调用
+ * @param  无
+ * @return 无
+ */
+void Prof_Report(void);
+#else
+#define PROF_BEGIN(Region) ((void)0)
+#define PROF_END(Region)   ((void)0)
+#endif
+
+#endif /* __PROF_H */
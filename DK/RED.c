@@ -4,7 +4,7 @@
  * @details  实现红外传感器的中断检测功能：
  *          - PA7引脚配置为上拉输入
  *          - 使用外部中断检测下降沿
- *          - 通过标志位反映检测状态
+ *          - 通过标志位反映检测状态，电平变化以事件通知控制线程
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -14,7 +14,7 @@
 #include "dk_C8T6.h"   // 项目主头文件
 
 /** @brief 红外检测标志，1表示检测到障碍物 */
-uint8_t RED_Flag = 0;
+volatile uint8_t RED_Flag = 0;
 
 /**
  * @brief  红外传感器初始化
@@ -80,7 +80,7 @@ uint8_t RED_Get(void)
  *         1. 判断是否为EXTI7的中断
  *         2. 清除中断标志位
  *         3. 延时一小段时间进行去抖
- *         4. 根据当前引脚电平更新检测标志
+ *         4. 根据当前引脚电平更新检测标志，并投递EVENT_PIR事件
  * @note   此函数会被硬件自动调用
  */
 void EXTI9_5_IRQHandler(void)
@@ -90,6 +90,8 @@ void EXTI9_5_IRQHandler(void)
         EXTI_ClearITPendingBit(EXTI_Line7);
 
         // 直接更新标志，消抖由定时器处理
-        RED_Flag = (GPIO_ReadInputDataBit(GPIOA, GPIO_Pin_7) == 0) ? 1 : 0;
+        uint8_t level = (GPIO_ReadInputDataBit(GPIOA, GPIO_Pin_7) == 0) ? 1 : 0;
+        RED_Flag      = level;
+        Event_PostFromISR(EVENT_PIR, &level, 1); // 通知处理任务
     }
 }
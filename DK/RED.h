@@ -16,9 +16,9 @@
 
 /**
  * @brief 红外检测状态标志
- * @note  在中断中更新，在主程序中读取
+ * @note  只在中断中更新，在主程序中读取
  */
-extern uint8_t RED_Flag;
+extern volatile uint8_t RED_Flag;
 
 /**
  * @brief  红外传感器初始化
@@ -2,7 +2,7 @@
  * @file     SD12.c
  * @brief    SD12紫外线传感器驱动程序
  * @details  实现SD12紫外线强度检测功能：
- *          - ADC采样（PA0）
+ *          - ADC采样（PA0，注册到AD.c的ADC服务）
  *          - 紫外线强度分级（0-11级）
  * @author   DikiFive
  * @date     2025-04-30
@@ -12,73 +12,31 @@
 #include "stm32f10x.h" // STM32F10x外设库头文件
 #include "dk_C8T6.h"   // 项目主头文件
 
+static AD_Channel_t SD12_Channel; /**< PA0，ADC服务中的通道 */
+
 /**
  * @brief  SD12传感器初始化
- * @details 完成以下配置：
- *         1. 使能GPIO时钟
- *         2. 配置PA0为模拟输入模式
- *         3. 配置ADC采样参数：
- *            - 12位分辨率
- *            - 单次转换模式
- *            - 软件触发
+ * @details 通过AD_Init完成ADC1的初始化，将PA0注册为规则组通道：
+ *         - 采样时间239.5周期，传感器输出阻抗较高时也能充满采样电容
+ *         - 平均窗口与紫外线采样周期UV_SAMPLE_MS相同，每次读取都是一个新的平均值
  * @param  无
  * @return 无
  */
 void SD12_Init(void)
 {
-    /*开启时钟*/
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_GPIOA, ENABLE); // GPIO时钟
-    RCC_APB2PeriphClockCmd(RCC_APB2Periph_ADC1, ENABLE);  // ADC时钟
-
-    /*GPIO初始化*/
-    GPIO_InitTypeDef GPIO_InitStructure;
-    GPIO_InitStructure.GPIO_Mode = GPIO_Mode_AIN;      // 模拟输入模式
-    GPIO_InitStructure.GPIO_Pin = GPIO_Pin_0;          // PA0
-    GPIO_InitStructure.GPIO_Speed = GPIO_Speed_50MHz;
-    GPIO_Init(GPIOA, &GPIO_InitStructure);
-
-    /*ADC配置*/
-    ADC_RegularChannelConfig(ADC1, ADC_Channel_0, 1, ADC_SampleTime_55Cycles5);
-
-    ADC_InitTypeDef ADC_InitStructure;
-    ADC_InitStructure.ADC_Mode = ADC_Mode_Independent;            // 独立模式
-    ADC_InitStructure.ADC_DataAlign = ADC_DataAlign_Right;       // 右对齐
-    ADC_InitStructure.ADC_ExternalTrigConv = ADC_ExternalTrigConv_None; // 软件触发
-    ADC_InitStructure.ADC_ContinuousConvMode = DISABLE;          // 单次转换
-    ADC_InitStructure.ADC_ScanConvMode = DISABLE;               // 非扫描模式
-    ADC_InitStructure.ADC_NbrOfChannel = 1;                     // 1个转换通道
-    ADC_Init(ADC1, &ADC_InitStructure);
-
-    /*ADC使能*/
-    ADC_Cmd(ADC1, ENABLE);
-
-    /*ADC校准*/
-    ADC_ResetCalibration(ADC1);
-    while (ADC_GetResetCalibrationStatus(ADC1) == SET);
-    ADC_StartCalibration(ADC1);
-    while (ADC_GetCalibrationStatus(ADC1) == SET);
+    AD_Init(); // ADC1共用初始化
+    AD_Register(&SD12_Channel, ADC_Channel_0, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, UV_SAMPLE_MS);
 }
 
 /**
  * @brief  获取ADC采样值
- * @details 执行一次ADC转换并获取结果：
- *         1. 启动ADC转换
- *         2. 等待转换完成
- *         3. 读取转换结果
- * @param  nSample 采样次数（用于平均）
+ * @details 读取PA0最近一个平均窗口的结果，不启动转换、不等待
+ * @param  无
  * @return uint16_t ADC转换结果，范围0~4095
  */
-uint16_t SD12_GetADCValue(uint8_t nSample)
+uint16_t SD12_GetADCValue(void)
 {
-    uint32_t sum = 0;
-
-    for (uint8_t i = 0; i < nSample; i++) {
-        ADC_SoftwareStartConvCmd(ADC1, ENABLE);           // 启动转换
-        while (ADC_GetFlagStatus(ADC1, ADC_FLAG_EOC) == RESET); // 等待转换完成
-        sum += ADC_GetConversionValue(ADC1);              // 读取转换结果
-    }
-
-    return sum / nSample; // 返回平均值
+    return AD_Read(&SD12_Channel);
 }
 
 /**
@@ -23,7 +23,7 @@
 
 /**
  * @brief  SD12传感器初始化
- * @details 配置ADC采样相关的GPIO和参数
+ * @details 将PA0注册到ADC服务
  * @param  无
  * @return 无
  */
@@ -31,11 +31,11 @@ void SD12_Init(void);
 
 /**
  * @brief  获取ADC采样值
- * @details 执行多次采样并取平均值
- * @param  nSample 采样次数，建议值：10
+ * @details 读取后台扫描的平均值，不启动转换
+ * @param  无
  * @return uint16_t ADC转换结果，范围：0~4095
  */
-uint16_t SD12_GetADCValue(uint8_t nSample);
+uint16_t SD12_GetADCValue(void);
 
 /**
  * @brief  获取紫外线强度等级
@@ -0,0 +1,222 @@
+/**
+ * @file     Sensor.c
+ * @brief    传感器采样缓存
+ * @details  将物理读取和数据使用分开：
+ *          - 各传感器按自己的周期采样，带时刻写入各自通道的环形缓冲，
+ *            使用者读取最新采样或直接遍历最近的历史，不需要复制整个缓冲
+ *          - 环形缓冲每个通道单生产者，写入计数自由递增，读取不关中断
+ *          - DHT11每DHT11_PERIOD_MS读取一次，满足传感器两次读取至少间隔1s的要求
+ *          - 各线程只读取缓存，随数据提供序号和年龄，由使用者判断数据是否更新、是否过旧
+ *          - 校验和或位宽度错误时按倍增的间隔重试，最多SENSOR_DHT11_RETRY_MAX次
+ *          - 连续失败计数和故障判定集中在这里，作为健康状态提供给显示和上报
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+#if DHT11_PERIOD_MS < 1000 || SENSOR_DHT11_RETRY_MS < 1000
+#error "DHT11两次读取至少间隔1s"
+#endif
+
+#define SENSOR_RING_MASK (SENSOR_RING_LEN - 1)
+
+/**
+ * @brief 内存屏障
+ * @details 保证采样内容先于写入计数可见，读取方先读计数再读内容
+ */
+#define SENSOR_BARRIER() __DMB()
+
+/**
+ * @brief 单通道环形缓冲
+ */
+typedef struct {
+    SensorSample_t Buf[SENSOR_RING_LEN]; /**< 采样 */
+    volatile uint32_t Head;              /**< 写入计数，只由生产者修改 */
+} SensorRing_t;
+
+static SensorRing_t Sensor_Rings[SENSOR_CH_NUM]; /**< 各通道的采样 */
+
+static SensorDht11_t Sensor_Dht11;     /**< DHT11缓存 */
+static OsSeq_t Sensor_Dht11Seq;        /**< DHT11缓存的顺序锁 */
+static uint32_t Sensor_Dht11Time;      /**< 最近一次成功读取的时刻（毫秒） */
+static uint32_t Sensor_Dht11Next;      /**< 下一次读取的时刻（毫秒） */
+static uint8_t Sensor_Dht11Retries;    /**< 本周期已重试的次数 */
+
+/**
+ * @brief  传感器采样缓存初始化
+ * @param  无
+ * @return 无
+ */
+void Sensor_Init(void)
+{
+    Sensor_Dht11.Health = SENSOR_HEALTH_INIT;
+    Sensor_Dht11Next    = DHT11_POWERUP_MS;
+}
+
+/**
+ * @brief  安排失败后的下一次读取
+ * @details 线路干扰引起的错误提前重试，其余错误（无响应、接收不完整）说明传感器本身
+ *         异常，按正常周期读取
+ * @param  Status 读取结果
+ * @param  Now 本次读取的开始时刻（毫秒）
+ * @return 无
+ */
+static void Sensor_Dht11Retry(DHT11_Status_t Status, uint32_t Now)
+{
+    uint32_t delay = (uint32_t)SENSOR_DHT11_RETRY_MS << Sensor_Dht11Retries;
+
+    if ((Status == DHT11_ERR_CHECKSUM || Status == DHT11_ERR_BIT) &&
+        Sensor_Dht11Retries < SENSOR_DHT11_RETRY_MAX && delay < DHT11_PERIOD_MS) {
+        Sensor_Dht11Next = Now + delay;
+        Sensor_Dht11Retries++;
+    } else {
+        Sensor_Dht11Retries = 0;
+    }
+}
+
+/**
+ * @brief  传感器采样调度
+ * @param  无
+ * @return 无
+ */
+void Sensor_Poll(void)
+{
+    uint32_t now = Timer_GetMillis();
+    DHT11_Data_TypeDef data;
+    DHT11_Status_t status;
+
+    Sensor_Push(SENSOR_CH_UV, now, SD12_GetIntensity(SD12_GetADCValue()));
+
+    if ((int32_t)(now - Sensor_Dht11Next) < 0) return;
+
+    PROF_BEGIN(PROF_DHT11);
+    status = DHT11_Read(&data);
+    PROF_END(PROF_DHT11);
+
+    Sensor_Dht11Next = now + DHT11_PERIOD_MS; // 间隔从读取开始计算
+
+    Os_SeqWriteBegin(&Sensor_Dht11Seq); // 读者不会读到一半更新的数据
+    Sensor_Dht11.Reads++;
+    Sensor_Dht11.LastError = status;
+    if (status == DHT11_OK) {
+        Sensor_Dht11.HumiInt  = data.humi_int;
+        Sensor_Dht11.HumiDeci = data.humi_deci;
+        Sensor_Dht11.TempInt  = data.temp_int;
+        Sensor_Dht11.TempDeci = data.temp_deci;
+        Sensor_Dht11.Seq++;
+        Sensor_Dht11.Fails  = 0;
+        Sensor_Dht11.Health = SENSOR_HEALTH_OK;
+        Sensor_Dht11Time    = now;
+        Sensor_Dht11Retries = 0;
+    } else {
+        switch (status) {
+            case DHT11_ERR_NO_RESPONSE: Sensor_Dht11.NoResponse++; break;
+            case DHT11_ERR_BIT: Sensor_Dht11.BitError++; break;
+            case DHT11_ERR_CHECKSUM: Sensor_Dht11.Checksum++; break;
+            default: Sensor_Dht11.Timeout++; break;
+        }
+        if (Sensor_Dht11.Fails < 0xFF) Sensor_Dht11.Fails++;
+        Sensor_Dht11.Health = Sensor_Dht11.Fails >= SENSOR_DHT11_FAULT_COUNT ? SENSOR_HEALTH_FAULT
+                                                                            : SENSOR_HEALTH_DEGRADED;
+        Sensor_Dht11Retry(status, now);
+    }
+    Os_SeqWriteEnd(&Sensor_Dht11Seq);
+
+    if (status == DHT11_OK) {
+        Sensor_Push(SENSOR_CH_TEMP, now, (int16_t)(data.temp_int * 10 + data.temp_deci));
+        Sensor_Push(SENSOR_CH_HUMI, now, (int16_t)(data.humi_int * 10 + data.humi_deci));
+    }
+}
+
+/**
+ * @brief  读取DHT11缓存
+ * @param  Dht11 缓存副本
+ * @return 无
+ */
+void Sensor_GetDht11(SensorDht11_t *Dht11)
+{
+    uint32_t time, start;
+
+    do {
+        start  = Os_SeqReadBegin(&Sensor_Dht11Seq);
+        *Dht11 = Sensor_Dht11;
+        time   = Sensor_Dht11Time;
+    } while (Os_SeqReadRetry(&Sensor_Dht11Seq, start));
+
+    Dht11->Age = Dht11->Seq ? Timer_GetMillis() - time : 0; // 读完后取当前时刻，年龄不会为负
+}
+
+/**
+ * @brief  写入一个采样
+ * @param  Channel 通道
+ * @param  Time 采样时刻（毫秒）
+ * @param  Value 采样值
+ * @return 无
+ */
+void Sensor_Push(SensorChannel_t Channel, uint32_t Time, int16_t Value)
+{
+    SensorRing_t *ring   = &Sensor_Rings[Channel];
+    uint32_t head        = ring->Head;
+    SensorSample_t *slot = &ring->Buf[head & SENSOR_RING_MASK];
+
+    slot->Time  = Time;
+    slot->Value = Value;
+    SENSOR_BARRIER();
+    ring->Head = head + 1;
+}
+
+/**
+ * @brief  获取通道的写入计数
+ * @param  Channel 通道
+ * @return uint32_t 写入计数
+ */
+uint32_t Sensor_GetHead(SensorChannel_t Channel)
+{
+    return Sensor_Rings[Channel].Head;
+}
+
+/**
+ * @brief  按序号获取采样，不复制
+ * @details 可读的序号为计数-(SENSOR_RING_LEN-1)~计数-1，写入不足SENSOR_RING_LEN-1个时为0~计数-1；
+ *         计数位置（序号为计数-SENSOR_RING_LEN的旧采样）正在或即将被改写，不可读
+ * @param  Channel 通道
+ * @param  Seq 采样序号
+ * @return const SensorSample_t* 采样，尚未写入或已被覆盖时返回0
+ */
+const SensorSample_t *Sensor_GetSample(SensorChannel_t Channel, uint32_t Seq)
+{
+    const SensorRing_t *ring = &Sensor_Rings[Channel];
+    uint32_t head            = ring->Head;
+    uint32_t count           = head < SENSOR_RING_LEN - 1 ? head : SENSOR_RING_LEN - 1; // 可读的采样数
+
+    if (head - Seq - 1 >= count) return 0;
+    SENSOR_BARRIER();
+    return &ring->Buf[Seq & SENSOR_RING_MASK];
+}
+
+/**
+ * @brief  获取最新采样
+ * @param  Channel 通道
+ * @param  Sample 采样副本
+ * @return uint8_t 1-成功，0-尚无采样
+ */
+uint8_t Sensor_GetLatest(SensorChannel_t Channel, SensorSample_t *Sample)
+{
+    const SensorSample_t *latest;
+    uint32_t head;
+
+    while (1) {
+        head = Sensor_GetHead(Channel);
+        if (head == 0) return 0;
+
+        latest = Sensor_GetSample(Channel, head - 1);
+        if (latest) {
+            *Sample = *latest;
+            SENSOR_BARRIER();
+            if (Sensor_GetSample(Channel, head - 1)) return 1; // 复制期间没有被覆盖
+        }
+    }
+}
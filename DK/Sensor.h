@@ -0,0 +1,167 @@
+/**
+ * @file     Sensor.h
+ * @brief    传感器采样缓存头文件
+ * @details  定义了传感器采样缓存相关的：
+ *          - 采样环形缓冲与DHT11重试、故障判定配置
+ *          - 采样通道、带时刻的采样、健康状态与缓存数据结构
+ *          - 采样调度、缓存读取与历史采样接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __SENSOR_H
+#define __SENSOR_H
+
+#include <stdint.h>
+
+/**
+ * @brief 每个通道保留的采样数，必须为2的幂
+ * @details 最近一个采样的写入位置不可读，可读的历史为SENSOR_RING_LEN-1个
+ */
+#ifndef SENSOR_RING_LEN
+#define SENSOR_RING_LEN 16
+#endif
+
+/**
+ * @brief DHT11校验错误后的重试次数
+ * @details 校验和或位宽度错误多为线路干扰，在下一个采样周期前提前重试，
+ *         重试间隔为SENSOR_DHT11_RETRY_MS、2倍、4倍……，不短于采样周期的重试不进行
+ */
+#ifndef SENSOR_DHT11_RETRY_MAX
+#define SENSOR_DHT11_RETRY_MAX 2
+#endif
+
+/**
+ * @brief DHT11首次重试间隔（毫秒），传感器两次读取至少间隔1s
+ */
+#ifndef SENSOR_DHT11_RETRY_MS
+#define SENSOR_DHT11_RETRY_MS 1000
+#endif
+
+/**
+ * @brief DHT11连续失败多少次判定为故障
+ * @details 偶尔失败时继续使用上次的有效数据，避免显示闪烁
+ */
+#ifndef SENSOR_DHT11_FAULT_COUNT
+#define SENSOR_DHT11_FAULT_COUNT 3
+#endif
+
+/**
+ * @brief 采样通道
+ * @details 每个通道只有一个生产者：温湿度和紫外线由传感器线程写入，
+ *         红外由控制线程在处理EVENT_PIR时按中断产生的时刻写入
+ */
+typedef enum {
+    SENSOR_CH_TEMP = 0, /**< 温度（0.1℃），DHT11每次成功读取一个 */
+    SENSOR_CH_HUMI,     /**< 湿度（0.1%），DHT11每次成功读取一个 */
+    SENSOR_CH_UV,       /**< 紫外线等级（0~11），每UV_SAMPLE_MS一个 */
+    SENSOR_CH_PIR,      /**< 红外检测（0/1），每次变化一个 */
+    SENSOR_CH_NUM       /**< 通道数 */
+} SensorChannel_t;
+
+/**
+ * @brief 带时刻的采样
+ */
+typedef struct {
+    uint32_t Time; /**< 采样时刻（毫秒，Timer_GetMillis时基） */
+    int16_t Value; /**< 采样值，单位见SensorChannel_t */
+} SensorSample_t;
+
+/**
+ * @brief 传感器健康状态
+ */
+typedef enum {
+    SENSOR_HEALTH_INIT = 0, /**< 上电稳定期，尚未读取 */
+    SENSOR_HEALTH_OK,       /**< 最近一次读取成功 */
+    SENSOR_HEALTH_DEGRADED, /**< 最近读取失败，但未达到故障次数，数据为上次有效值 */
+    SENSOR_HEALTH_FAULT     /**< 连续失败达到SENSOR_DHT11_FAULT_COUNT次 */
+} SensorHealth_t;
+
+/**
+ * @brief DHT11缓存
+ * @details 温湿度为最近一次成功读取的值，Seq为0时尚无有效数据
+ */
+typedef struct {
+    uint8_t HumiInt;     /**< 湿度整数部分 */
+    uint8_t HumiDeci;    /**< 湿度小数部分 */
+    uint8_t TempInt;     /**< 温度整数部分 */
+    uint8_t TempDeci;    /**< 温度小数部分 */
+    uint32_t Seq;        /**< 成功读取的序号，每次成功加1 */
+    uint32_t Age;        /**< 数据年龄（毫秒），读取缓存时计算 */
+    uint8_t Health;      /**< 健康状态（SensorHealth_t） */
+    uint8_t LastError;   /**< 最近一次读取结果（DHT11_Status_t） */
+    uint8_t Fails;       /**< 连续失败次数 */
+    uint32_t Reads;      /**< 实际读取次数（含重试） */
+    uint32_t NoResponse; /**< 无响应次数 */
+    uint32_t Timeout;    /**< 接收不完整或等待超时次数 */
+    uint32_t BitError;   /**< 位宽度异常次数 */
+    uint32_t Checksum;   /**< 校验和错误次数 */
+} SensorDht11_t;
+
+/**
+ * @brief  传感器采样缓存初始化
+ * @details 首次读取安排在上电稳定期（DHT11_POWERUP_MS）结束时
+ * @param  无
+ * @return 无
+ */
+void Sensor_Init(void);
+
+/**
+ * @brief  传感器采样调度
+ * @details 每次调用采样一次紫外线；到达读取时刻时读取一次DHT11并更新缓存，
+ *         成功或失败后按DHT11_PERIOD_MS安排下一次读取，校验错误时提前重试。
+ *         须在传感器线程中每UV_SAMPLE_MS调用一次，调用周期决定DHT11读取时刻的精度
+ * @param  无
+ * @return 无
+ */
+void Sensor_Poll(void);
+
+/**
+ * @brief  读取DHT11缓存
+ * @details 不访问硬件，可在任意线程中调用（不能在中断中调用），以顺序锁读取一致的副本
+ * @param  Dht11 缓存副本
+ * @return 无
+ */
+void Sensor_GetDht11(SensorDht11_t *Dht11);
+
+/**
+ * @brief  写入一个采样
+ * @details 每个通道只能有一个生产者；先写采样内容，屏障后发布新的写入计数
+ * @param  Channel 通道
+ * @param  Time 采样时刻（毫秒）
+ * @param  Value 采样值
+ * @return 无
+ */
+void Sensor_Push(SensorChannel_t Channel, uint32_t Time, int16_t Value);
+
+/**
+ * @brief  获取通道的写入计数
+ * @details 即下一个采样的序号，已写入的采样序号为0~计数-1；
+ *         遍历最近的历史时从计数-1向前，配合Sensor_GetSample使用
+ * @param  Channel 通道
+ * @return uint32_t 写入计数
+ */
+uint32_t Sensor_GetHead(SensorChannel_t Channel);
+
+/**
+ * @brief  按序号获取采样，不复制
+ * @details 返回缓冲中的位置，在之后的SENSOR_RING_LEN-1个采样写入前内容不变；
+ *         使用后再次调用返回0说明期间已被覆盖，应丢弃读到的内容
+ * @param  Channel 通道
+ * @param  Seq 采样序号
+ * @return const SensorSample_t* 采样，尚未写入或已被覆盖时返回0
+ */
+const SensorSample_t *Sensor_GetSample(SensorChannel_t Channel, uint32_t Seq);
+
+/**
+ * @brief  获取最新采样
+ * @details 复制最新的一个采样，复制期间被覆盖时重新读取，得到的采样完整一致；
+ *         不关中断，可在任意线程中调用
+ * @param  Channel 通道
+ * @param  Sample 采样副本
+ * @return uint8_t 1-成功，0-尚无采样
+ */
+uint8_t Sensor_GetLatest(SensorChannel_t Channel, SensorSample_t *Sample);
+
+#endif /* __SENSOR_H */
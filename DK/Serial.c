@@ -14,6 +14,8 @@
 #include "dk_C8T6.h"   // 项目主头文件
 #include <stdio.h>     // 用于printf重定向
 
+static volatile uint8_t Serial_RxCmd = 0; /**< 最近收到的命令字节 */
+
 /**
  * @brief  串口1初始化
  * @details 完成以下配置：
@@ -111,6 +113,19 @@ void Serial_SendArray(uint8_t *Array, uint16_t Length)
     }
 }
 
+/**
+ * @brief  读取调试命令
+ * @param  无
+ * @return uint8_t 命令字符，0表示没有新命令
+ */
+uint8_t Serial_GetCmd(void)
+{
+    uint8_t cmd = Serial_RxCmd;
+
+    Serial_RxCmd = 0;
+    return cmd;
+}
+
 /**
  * @brief  printf函数重定向
  * @details 重定向后可以直接使用printf函数通过串口输出
@@ -123,7 +138,7 @@ int fputc(int ch, FILE *f)
 
 /**
  * @brief  USART1中断服务函数
- * @details 处理接收到的数据
+ * @details 回显接收到的字节，并保存为调试命令
  * @note   此函数会被硬件自动调用
  */
 void USART1_IRQHandler(void)
@@ -131,6 +146,7 @@ void USART1_IRQHandler(void)
     if (USART_GetITStatus(USART1, USART_IT_RXNE) == SET) {
         uint8_t RxData = USART_ReceiveData(USART1);  // 读取接收到的数据
         Serial_SendByte(RxData);                      // 回显数据（用于测试）
+        Serial_RxCmd = RxData;                        // 保存为调试命令
         USART_ClearITPendingBit(USART1, USART_IT_RXNE); // 清除中断标志位
     }
 }
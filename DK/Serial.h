@@ -4,6 +4,7 @@
  * @details  声明串口通信相关的函数接口：
  *          - 初始化函数
  *          - 数据发送函数
+ *          - 命令接收函数
  *          - printf重定向函数
  * @author   DikiFive
  * @date     2025-04-30
@@ -51,4 +52,12 @@ void Serial_SendString(char *String);
  */
 void Serial_SendArray(uint8_t *Array, uint16_t Length);
 
+/**
+ * @brief  读取调试命令
+ * @details 返回最近收到的一个字节并清除，未处理时到来的新字节覆盖旧字节
+ * @param  无
+ * @return uint8_t 命令字符，0表示没有新命令
+ */
+uint8_t Serial_GetCmd(void);
+
 #endif /* __SERIAL_H */
@@ -0,0 +1,144 @@
+/**
+ * @file     SoftTimer.c
+ * @brief    软件定时器
+ * @details  为单次和周期定时提供统一的服务：
+ *          - 运行中的定时器按到期时刻排成有序链表，只需检查表头
+ *          - 周期定时按Expire += Period推进，没有累积漂移
+ *          - 回调在控制线程中执行，可以直接操作外设和共享状态
+ *          - 不需要节拍中断，控制线程按最近的到期时刻设置等待超时
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h" // STM32F10x外设库头文件
+#include "dk_C8T6.h"   // 项目主头文件
+
+static SoftTimer_t *SoftTimer_List = 0; /**< 运行中的定时器，按到期时刻排序 */
+
+/**
+ * @brief  判断时刻是否已到达
+ * @details 按有符号差值比较，计数器回绕时仍然正确
+ */
+#define SOFTTIMER_REACHED(now, t) ((int32_t)((now) - (t)) >= 0)
+
+/**
+ * @brief  按到期时刻插入链表
+ * @details 到期时刻相同的定时器按插入先后排列
+ * @param  Timer 定时器句柄
+ * @return 无
+ */
+static void SoftTimer_Insert(SoftTimer_t *Timer)
+{
+    SoftTimer_t **link = &SoftTimer_List;
+
+    while (*link != 0 && (int32_t)(Timer->Expire - (*link)->Expire) >= 0) {
+        link = &(*link)->Next;
+    }
+    Timer->Next   = *link;
+    *link         = Timer;
+    Timer->Active = 1;
+}
+
+/**
+ * @brief  从链表中移除
+ * @param  Timer 定时器句柄
+ * @return 无
+ */
+static void SoftTimer_Remove(SoftTimer_t *Timer)
+{
+    SoftTimer_t **link = &SoftTimer_List;
+
+    while (*link != 0) {
+        if (*link == Timer) {
+            *link = Timer->Next;
+            break;
+        }
+        link = &(*link)->Next;
+    }
+    Timer->Next   = 0;
+    Timer->Active = 0;
+}
+
+/**
+ * @brief  启动定时器
+ * @param  Timer 定时器句柄
+ * @param  Delay 第一次到期的延时（毫秒）
+ * @param  Period 之后的周期（毫秒），0表示单次定时
+ * @param  Callback 到期回调
+ * @return 无
+ */
+void SoftTimer_Start(SoftTimer_t *Timer, uint32_t Delay, uint32_t Period, void (*Callback)(void))
+{
+    if (Timer->Active) SoftTimer_Remove(Timer);
+
+    Timer->Callback = Callback;
+    Timer->Period   = Period;
+    Timer->Expire   = Timer_GetMillis() + Delay;
+    SoftTimer_Insert(Timer);
+}
+
+/**
+ * @brief  停止定时器
+ * @param  Timer 定时器句柄
+ * @return 无
+ */
+void SoftTimer_Stop(SoftTimer_t *Timer)
+{
+    if (Timer->Active) SoftTimer_Remove(Timer);
+}
+
+/**
+ * @brief  查询定时器是否在运行
+ * @param  Timer 定时器句柄
+ * @return uint8_t 1-运行中，0-已停止或已到期
+ */
+uint8_t SoftTimer_IsActive(const SoftTimer_t *Timer)
+{
+    return Timer->Active;
+}
+
+/**
+ * @brief  处理到期的定时器
+ * @details 处理过程：
+ *         1. 表头未到期则返回，其余定时器到期更晚
+ *         2. 取下表头；周期定时器推进到下一个周期后重新插入，
+ *            落后一个周期以上时跳过错过的周期，保持原有相位
+ *         3. 执行回调，回调中可以重新启动或停止任何定时器
+ * @param  无
+ * @return 无
+ */
+void SoftTimer_Run(void)
+{
+    uint32_t now = Timer_GetMillis();
+    SoftTimer_t *timer;
+
+    while (SoftTimer_List != 0 && SOFTTIMER_REACHED(now, SoftTimer_List->Expire)) {
+        timer = SoftTimer_List;
+        SoftTimer_Remove(timer);
+
+        if (timer->Period) {
+            do {
+                timer->Expire += timer->Period;
+            } while (SOFTTIMER_REACHED(now, timer->Expire));
+            SoftTimer_Insert(timer);
+        }
+
+        timer->Callback();
+    }
+}
+
+/**
+ * @brief  获取距最近一次到期的时间
+ * @param  无
+ * @return uint32_t 毫秒数；0表示已有定时器到期，没有运行中的定时器时返回0xFFFFFFFF
+ */
+uint32_t SoftTimer_GetIdleTime(void)
+{
+    int32_t left;
+
+    if (SoftTimer_List == 0) return 0xFFFFFFFF;
+
+    left = (int32_t)(SoftTimer_List->Expire - Timer_GetMillis());
+    return (left > 0) ? (uint32_t)left : 0;
+}
@@ -0,0 +1,71 @@
+/**
+ * @file     SoftTimer.h
+ * @brief    软件定时器头文件
+ * @details  定义了软件定时器相关的：
+ *          - 定时器描述结构
+ *          - 启动、停止与处理接口
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __SOFTTIMER_H
+#define __SOFTTIMER_H
+
+#include <stdint.h>
+
+/**
+ * @brief 软件定时器
+ * @details 由使用者静态分配，指针即为句柄；成员由定时器服务维护，使用者不应直接修改
+ */
+typedef struct SoftTimer {
+    struct SoftTimer *Next; /**< 按到期时刻排序的链表 */
+    void (*Callback)(void); /**< 到期回调，在控制线程中执行 */
+    uint32_t Expire;        /**< 到期时刻（毫秒） */
+    uint32_t Period;        /**< 周期（毫秒），0表示单次定时 */
+    uint8_t Active;         /**< 是否在运行 */
+} SoftTimer_t;
+
+/**
+ * @brief  启动定时器
+ * @details 定时器已在运行时按新的参数重新启动
+ * @param  Timer 定时器句柄
+ * @param  Delay 第一次到期的延时（毫秒）
+ * @param  Period 之后的周期（毫秒），0表示单次定时
+ * @param  Callback 到期回调
+ * @return 无
+ */
+void SoftTimer_Start(SoftTimer_t *Timer, uint32_t Delay, uint32_t Period, void (*Callback)(void));
+
+/**
+ * @brief  停止定时器
+ * @details 定时器未在运行时不做任何操作
+ * @param  Timer 定时器句柄
+ * @return 无
+ */
+void SoftTimer_Stop(SoftTimer_t *Timer);
+
+/**
+ * @brief  查询定时器是否在运行
+ * @param  Timer 定时器句柄
+ * @return uint8_t 1-运行中，0-已停止或已到期
+ */
+uint8_t SoftTimer_IsActive(const SoftTimer_t *Timer);
+
+/**
+ * @brief  处理到期的定时器
+ * @details 由控制线程调用，依次执行所有已到期定时器的回调
+ * @param  无
+ * @return 无
+ */
+void SoftTimer_Run(void);
+
+/**
+ * @brief  获取距最近一次到期的时间
+ * @details 供控制线程决定等待事件的超时
+ * @param  无
+ * @return uint32_t 毫秒数；0表示已有定时器到期，没有运行中的定时器时返回0xFFFFFFFF
+ */
+uint32_t SoftTimer_GetIdleTime(void);
+
+#endif /* __SOFTTIMER_H */
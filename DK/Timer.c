@@ -1,11 +1,13 @@
 /**
  * @file     Timer.c
  * @brief    定时器驱动程序
- * @details  实现系统定时功能：
- *          - 1ms基本定时
- *          - 系统运行时间计数
+ * @details  实现系统时间基准：
+ *          - TIM4以1MHz自由计数，16位计数值作为微秒低位
+ *          - 溢出中断（每65.536ms一次）累加64位高位计数，同时把毫秒基准推进65ms、
+ *            微秒余数推进536us，毫秒时间只需32位加法和除法
+ *          - 读取时无需关中断，也不依赖1kHz节拍中断
+ *          - 比较通道1作为微秒级单次定时，供需要精确时序的驱动使用
  *          - 软件延时功能
- *          - 各种模式的定时控制
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -15,25 +17,25 @@
 #include "dk_C8T6.h"   // 项目主头文件
 
 /**
- * @brief 系统定时相关变量
+ * @brief 系统时间相关变量
  */
-uint32_t TimingDelay    = 0;  /**< 软件延时计数器 */
-uint32_t system_runtime_s = 0; /**< 系统运行时间（秒） */
-uint32_t ms_count       = 0;  /**< 毫秒计数器 */
-uint32_t uv_timer_ms    = 0;  /**< 红外触发UV灯计时器 */
-uint8_t uv_infrared_active = 0; /**< 红外触发UV灯工作标志 */
-uint32_t cycle_timer_ms = 0;  /**< 循环模式计时器 */
-uint8_t cycle_state    = 0;   /**< 循环模式状态 */
-uint8_t update_flag    = 0;   /**< 定时更新标志 */
+static volatile uint64_t Timer_Overflow = 0; /**< TIM4溢出次数（微秒时间的高位） */
+static uint64_t Timer_OffsetUs          = 0; /**< 停止模式补偿的时间（微秒） */
+static volatile uint32_t Timer_MsBase   = 0; /**< 最近一次溢出时的毫秒时间（含补偿，低32位） */
+static volatile uint32_t Timer_MsWraps  = 0; /**< 毫秒基准的回绕次数（毫秒时间的高32位） */
+static volatile uint16_t Timer_MsRem    = 0; /**< 最近一次溢出时不足1ms的微秒数，0~999 */
+static uint32_t TimingDelay_End         = 0; /**< 软件延时结束时刻（毫秒） */
+static void (*volatile Timer_OneShot)(void) = 0; /**< 单次定时回调 */
 
 /**
  * @brief  定时器初始化
- * @details 配置TIM4为1ms定时中断：
+ * @details 配置TIM4为自由计数的时间基准：
  *         1. 使能定时器时钟
  *         2. 配置定时器基本参数：
  *            - 72MHz / 72 = 1MHz 计数频率
- *            - 1MHz / 1000 = 1KHz 中断频率
- *         3. 配置NVIC中断优先级
+ *            - ARR取最大值，计满65536次溢出一次
+ *         3. 使能溢出中断
+ *         4. 配置NVIC中断优先级
  * @param  无
  * @return 无
  */
@@ -49,14 +51,14 @@ void Timer_Init(void)
     TIM_TimeBaseInitTypeDef TIM_TimeBaseInitStructure;
     TIM_TimeBaseInitStructure.TIM_ClockDivision     = TIM_CKD_DIV1;       // 不分频
     TIM_TimeBaseInitStructure.TIM_CounterMode       = TIM_CounterMode_Up; // 向上计数
-    TIM_TimeBaseInitStructure.TIM_Period            = 1000 - 1;           // ARR值，1ms
+    TIM_TimeBaseInitStructure.TIM_Period            = 0xFFFF;             // ARR值，自由计数
     TIM_TimeBaseInitStructure.TIM_Prescaler         = 72 - 1;             // PSC值
     TIM_TimeBaseInitStructure.TIM_RepetitionCounter = 0;                  // 不重复计数
     TIM_TimeBaseInit(TIM4, &TIM_TimeBaseInitStructure);
 
     /*中断输出配置*/
-    TIM_ClearFlag(TIM4, TIM_FLAG_Update);                  // 清除更新中断标志位
-    TIM_ITConfig(TIM4, TIM_IT_Update, ENABLE);             // 使能更新中断
+    TIM_ClearFlag(TIM4, TIM_FLAG_Update);                // 清除中断标志位
+    TIM_ITConfig(TIM4, TIM_IT_Update, ENABLE);           // 使能溢出中断
 
     /*NVIC中断优先级配置*/
     NVIC_PriorityGroupConfig(NVIC_PriorityGroup_2);
@@ -73,74 +75,237 @@ void Timer_Init(void)
 
 /**
  * @brief  定时器中断服务函数
- * @details 每1ms触发一次中断：
- *         1. 更新系统运行时间
- *         2. 处理软件延时计数
- *         3. 更新各种定时器计数值
- *         4. 设置定时更新标志
+ * @details 溢出中断：累加高位计数，毫秒基准推进65536us（65ms加536us，余数满1000进位）；
+ *         比较通道1中断：关闭该中断后调用单次定时回调
  * @note   此函数会被硬件自动调用
  */
 void TIM4_IRQHandler(void)
 {
+    void (*callback)(void);
+    uint32_t base;
+    uint16_t rem;
+
     if (TIM_GetITStatus(TIM4, TIM_IT_Update) == SET) {
         TIM_ClearITPendingBit(TIM4, TIM_IT_Update); // 清除中断标志位
-
-        // 更新系统运行时间
-        ms_count++;
-        if (ms_count >= 1000) {
-            ms_count = 0;
-            system_runtime_s++;
+        Timer_Overflow++;
+        base = Timer_MsBase + 65;
+        rem  = Timer_MsRem + 536;
+        if (rem >= 1000) {
+            rem -= 1000;
+            base++;
         }
+        if (base < Timer_MsBase) Timer_MsWraps++;
+        Timer_MsRem  = rem;
+        Timer_MsBase = base; // 最后写入，读取者以其变化判断是否重读
+    }
+    if (TIM_GetITStatus(TIM4, TIM_IT_CC1) == SET) {
+        TIM_ITConfig(TIM4, TIM_IT_CC1, DISABLE);
+        TIM_ClearITPendingBit(TIM4, TIM_IT_CC1);
+        callback      = Timer_OneShot;
+        Timer_OneShot = 0;
+        if (callback) callback();
+    }
+}
 
-        // 软件延时更新
-        if (TimingDelay > 0) {
-            TimingDelay--;
-        }
+/**
+ * @brief  启动单次定时
+ * @details 比较值为当前计数加定时时长，16位计数回绕后仍然正确；
+ *         比较通道保持复位后的冻结模式，只产生中断，不影响引脚
+ * @param  Us 定时时长（微秒）
+ * @param  Callback 到期回调
+ * @return 无
+ */
+void Timer_StartOneShot(uint16_t Us, void (*Callback)(void))
+{
+    uint32_t state = Os_EnterCritical();
 
-        // 更新UV灯定时器
-        if (uv_infrared_active) {
-            uv_timer_ms++;
+    Timer_OneShot = Callback;
+    TIM_SetCompare1(TIM4, (uint16_t)(TIM_GetCounter(TIM4) + Us));
+    TIM_ClearITPendingBit(TIM4, TIM_IT_CC1);
+    TIM_ITConfig(TIM4, TIM_IT_CC1, ENABLE);
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  取消单次定时
+ * @param  无
+ * @return 无
+ */
+void Timer_StopOneShot(void)
+{
+    uint32_t state = Os_EnterCritical();
+
+    TIM_ITConfig(TIM4, TIM_IT_CC1, DISABLE);
+    TIM_ClearITPendingBit(TIM4, TIM_IT_CC1);
+    Timer_OneShot = 0;
+    Os_ExitCritical(state);
+}
+
+/**
+ * @brief  获取64位微秒时间戳
+ * @details 由溢出次数和TIM4计数值组合而成：
+ *         1. 读取溢出次数和计数值
+ *         2. 若溢出标志已置位但中断尚未处理（如在关中断期间读取），
+ *            重新读取计数值并把这次溢出计入高位
+ *         3. 读取过程中若发生溢出中断，高位发生变化，重新读取
+ *         64位溢出次数分两次读取，中断插入其间时低位必然变化，同样会被第3步发现
+ * @param  无
+ * @return uint64_t 微秒时间戳
+ */
+uint64_t Timer_GetMicros64(void)
+{
+    uint64_t ovf, high;
+    uint16_t cnt;
+
+    do {
+        ovf  = Timer_Overflow;
+        high = ovf;
+        cnt  = TIM_GetCounter(TIM4);
+        if (TIM_GetFlagStatus(TIM4, TIM_FLAG_Update) == SET) {
+            cnt = TIM_GetCounter(TIM4);
+            high++;
         }
+    } while (ovf != Timer_Overflow);
+
+    return ((high << 16) | cnt) + Timer_OffsetUs;
+}
+
+/**
+ * @brief  读取毫秒基准和其后的微秒数
+ * @details 与Timer_GetMicros64相同的重读方式：溢出标志已置位但中断尚未处理时，
+ *         重新读取计数值并多计65536us；读取过程中发生溢出中断时基准必然变化，重新读取。
+ *         微秒数不超过999+65536+65535，毫秒时间只需一次32位除法
+ * @param  Base 毫秒基准
+ * @param  Us 基准之后的微秒数
+ * @return uint32_t 毫秒时间戳
+ */
+static uint32_t Timer_ReadMillis(uint32_t *Base, uint32_t *Us)
+{
+    uint32_t base, us;
 
-        // 更新循环模式定时器
-        if (cycle_state) {
-            cycle_timer_ms++;
-            if (cycle_timer_ms >= 10000) {
-                cycle_timer_ms = 0;
-            }
+    do {
+        base = Timer_MsBase;
+        us   = Timer_MsRem + TIM_GetCounter(TIM4);
+        if (TIM_GetFlagStatus(TIM4, TIM_FLAG_Update) == SET) {
+            us = Timer_MsRem + 0x10000 + TIM_GetCounter(TIM4);
         }
+    } while (base != Timer_MsBase);
 
-        // 设置定时更新标志
-        update_flag = 1;
-    }
+    *Base = base;
+    *Us   = us;
+    return base + us / 1000;
 }
 
 /**
- * @brief  设置软件延时计数值
- * @details 用于非阻塞延时
+ * @brief  获取64位毫秒时间戳
+ * @details 高32位为基准的回绕次数，基准之后的微秒数跨过回绕时再加1；
+ *         读取期间回绕次数变化时重新读取
+ * @param  无
+ * @return uint64_t 毫秒时间戳
+ */
+uint64_t Timer_GetMillis64(void)
+{
+    uint32_t wraps, base, us, ms;
+
+    do {
+        wraps = Timer_MsWraps;
+        ms    = Timer_ReadMillis(&base, &us);
+    } while (wraps != Timer_MsWraps);
+
+    return ((uint64_t)(wraps + (ms < base)) << 32) | ms;
+}
+
+/**
+ * @brief  获取毫秒时间戳（低32位）
+ * @details 由毫秒基准加上不足1ms的余数和计数值换算，不经过64位除法
+ * @param  无
+ * @return uint32_t 毫秒时间戳
+ */
+uint32_t Timer_GetMillis(void)
+{
+    uint32_t base, us;
+
+    return Timer_ReadMillis(&base, &us);
+}
+
+/**
+ * @brief  获取毫秒时间戳及不足1ms的微秒数
+ * @param  Us 当前毫秒内已经过的微秒数，0~999
+ * @return uint32_t 毫秒时间戳（低32位）
+ */
+uint32_t Timer_GetMillisFrac(uint16_t *Us)
+{
+    uint32_t base, us;
+    uint32_t ms = Timer_ReadMillis(&base, &us);
+
+    *Us = (uint16_t)(us - (ms - base) * 1000);
+    return ms;
+}
+
+/**
+ * @brief  获取微秒时间戳（低32位）
+ * @param  无
+ * @return uint32_t 微秒时间戳
+ */
+uint32_t Timer_GetMicros(void)
+{
+    return (uint32_t)Timer_GetMicros64();
+}
+
+/**
+ * @brief  获取系统运行时间
+ * @param  无
+ * @return uint32_t 运行秒数
+ */
+uint32_t Timer_GetSeconds(void)
+{
+    return (uint32_t)(Timer_GetMicros64() / 1000000);
+}
+
+/**
+ * @brief  推进时间
+ * @details 补偿值只在空闲线程中关中断修改，读取者不会看到写了一半的值；
+ *         毫秒基准同样推进，微秒余数不变
+ * @param  Ms 推进的毫秒数
+ * @return 无
+ */
+void Timer_Advance(uint32_t Ms)
+{
+    uint32_t base = Timer_MsBase + Ms;
+
+    Timer_OffsetUs += (uint64_t)Ms * 1000;
+    if (base < Timer_MsBase) Timer_MsWraps++;
+    Timer_MsBase = base;
+}
+
+/**
+ * @brief  设置软件延时
+ * @details 记录延时结束时刻，用于非阻塞延时
  * @param  nTime 延时时间（毫秒）
  * @return 无
  */
 void TimingDelay_Set(uint32_t nTime)
 {
-    TimingDelay = nTime;
+    TimingDelay_End = Timer_GetMillis() + nTime;
 }
 
 /**
- * @brief  获取软件延时计数值
- * @return uint32_t 当前延时计数值
+ * @brief  获取剩余延时时间
+ * @return uint32_t 剩余毫秒数，延时结束后为0
  */
 uint32_t TimingDelay_Get(void)
 {
-    return TimingDelay;
+    int32_t left = (int32_t)(TimingDelay_End - Timer_GetMillis());
+
+    return (left > 0) ? (uint32_t)left : 0;
 }
 
 /**
  * @brief  等待延时结束
- * @details 阻塞等待直到延时计数为0
+ * @details 阻塞等待直到延时时间到达
  * @return 无
  */
 void TimingDelay_WaitForEnd(void)
 {
-    while (TimingDelay != 0);
+    while (TimingDelay_Get() != 0);
 }
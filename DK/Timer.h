@@ -2,8 +2,9 @@
  * @file     Timer.h
  * @brief    定时器驱动程序头文件
  * @details  声明定时器相关的：
- *          - 全局变量
- *          - 功能函数接口
+ *          - 单调时间接口
+ *          - 微秒级单次定时接口
+ *          - 软件延时接口
  * @author   DikiFive
  * @date     2025-04-30
  * @version  v1.0
@@ -15,24 +16,78 @@
 #include <stdint.h>
 
 /**
- * @brief 定时器相关变量声明
+ * @brief  定时器初始化
+ * @details 配置TIM4以1MHz自由计数，计数溢出时累加高位
+ * @param  无
+ * @return 无
+ */
+void Timer_Init(void);
+
+/**
+ * @brief  获取64位微秒时间戳
+ * @details 自定时器启动起的微秒数，单调递增，在设备寿命内不会回绕
+ * @return uint64_t 微秒时间戳
  */
-extern uint32_t TimingDelay;          /**< 软件延时计数器 */
-extern uint32_t system_runtime_s;     /**< 系统运行时间（秒） */
-extern uint32_t ms_count;             /**< 毫秒计数器 */
-extern uint32_t uv_timer_ms;          /**< 红外触发UV灯计时器 */
-extern uint8_t uv_infrared_active;    /**< 红外触发UV灯工作标志 */
-extern uint32_t cycle_timer_ms;       /**< 循环模式计时器 */
-extern uint8_t cycle_state;           /**< 循环模式状态 */
-extern uint8_t update_flag;           /**< 定时更新标志 */
+uint64_t Timer_GetMicros64(void);
 
 /**
- * @brief  定时器初始化
- * @details 配置TIM4为1ms定时中断
+ * @brief  获取64位毫秒时间戳
+ * @return uint64_t 毫秒时间戳
+ */
+uint64_t Timer_GetMillis64(void);
+
+/**
+ * @brief  获取毫秒时间戳（低32位）
+ * @details 约49天回绕一次，只能用差值比较时刻先后
+ * @return uint32_t 毫秒时间戳
+ */
+uint32_t Timer_GetMillis(void);
+
+/**
+ * @brief  获取毫秒时间戳及不足1ms的微秒数
+ * @details 与Timer_GetMillis取自同一次读取，用于换算到下一个毫秒边界的时长
+ * @param  Us 当前毫秒内已经过的微秒数，0~999
+ * @return uint32_t 毫秒时间戳（低32位）
+ */
+uint32_t Timer_GetMillisFrac(uint16_t *Us);
+
+/**
+ * @brief  获取微秒时间戳（低32位）
+ * @details 约71分钟回绕一次，适合用差值测量较短的时间间隔
+ * @return uint32_t 微秒时间戳
+ */
+uint32_t Timer_GetMicros(void);
+
+/**
+ * @brief  获取系统运行时间
+ * @return uint32_t 运行秒数
+ */
+uint32_t Timer_GetSeconds(void);
+
+/**
+ * @brief  推进时间
+ * @details 停止模式下TIM4不计数，唤醒后用于补齐休眠期间的时间
+ * @param  Ms 推进的毫秒数
+ * @return 无
+ */
+void Timer_Advance(uint32_t Ms);
+
+/**
+ * @brief  启动单次定时
+ * @details 以TIM4比较通道1实现，到期时在TIM4中断中调用一次回调；
+ *         同一时刻只有一个单次定时，再次启动会替换尚未到期的定时
+ * @param  Us 定时时长（微秒），范围2~65535
+ * @param  Callback 到期回调，在中断中执行，可在其中再次启动单次定时
+ * @return 无
+ */
+void Timer_StartOneShot(uint16_t Us, void (*Callback)(void));
+
+/**
+ * @brief  取消单次定时
  * @param  无
  * @return 无
  */
-void Timer_Init(void);
+void Timer_StopOneShot(void);
 
 /**
  * @brief  设置延时时间
@@ -42,14 +97,14 @@ void Timer_Init(void);
 void TimingDelay_Set(uint32_t nTime);
 
 /**
- * @brief  获取当前延时计数值
- * @return uint32_t 当前延时计数值
+ * @brief  获取剩余延时时间
+ * @return uint32_t 剩余毫秒数，延时结束后为0
  */
 uint32_t TimingDelay_Get(void);
 
 /**
  * @brief  等待延时结束
- * @details 阻塞等待，直到延时计数为0
+ * @details 阻塞等待，直到延时时间到达
  * @return 无
  */
 void TimingDelay_WaitForEnd(void);
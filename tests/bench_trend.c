@@ -0,0 +1,144 @@
+/**
+ * @file     bench_trend.c
+ * @brief    趋势页渲染开销对比
+ * @details  Display.c和OLED.c（软件I2C）在主机上运行，屏幕由SSD1306模型代替（见host/ssd1306.h）。
+ *          以相同的采样序列比较两种做法每个采样的开销：
+ *          - 增量：Display_Render只重绘变化的字段和趋势图的三列，OLED_Update只发送脏区
+ *          - 整屏：每个采样都切换页面（清屏、重绘全部标签和曲线），OLED_Update发送整屏
+ *          开销以I2C总线字节数和引脚写入次数（软件I2C的CPU开销）计，并给出主机耗时作参考。
+ *          增量运行中定期与整屏重绘的结果比较，屏幕内容必须一致
+ * @note   用法：make -C tests bench
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include <time.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_test.h"
+#include "ssd1306.h"
+
+#define SAMPLES     1024 /**< 采样数，趋势缓冲回绕8次 */
+#define CHECK_EVERY 97   /**< 每隔若干采样与整屏重绘比较一次 */
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct) {}
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {}
+
+static DisplayData_t Data;     /**< 显示数据 */
+static uint32_t Rand_State = 7; /**< 伪随机数状态 */
+
+/**
+ * @brief 单次运行的累计开销
+ */
+typedef struct {
+    uint32_t Bytes;     /**< 总线字节数 */
+    uint32_t PinWrites; /**< 引脚写入次数 */
+    double Seconds;     /**< 主机耗时 */
+} Cost_t;
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+static double Now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief  推进一秒并生成下一个采样（缓慢随机游走，温湿度带小数）
+ */
+static void Next_Sample(void)
+{
+    uint8_t temp = Data.temp >> 8, humi = Data.humi >> 8;
+
+    if (Rand() % 4 == 0) temp = temp + (Rand() % 3) - 1;
+    if (Rand() % 4 == 0) humi = humi + (Rand() % 3) - 1;
+    if (Rand() % 16 == 0) Data.uvLevel = Rand() % 12;
+    Data.temp = DISPLAY_FIXED(temp, Rand() % 10);
+    Data.humi = DISPLAY_FIXED(humi, Data.humi & 0xFF);
+    Data.runtime_s++;
+}
+
+/**
+ * @brief  渲染并刷新一帧，累计开销
+ */
+static void Frame(Cost_t *Cost, uint8_t Full)
+{
+    uint32_t bytes = OLED_GetBusBytes(), pins = Ssd1306_PinWrites;
+    double start = Now();
+
+    if (Full) Display_SetPage(DISPLAY_PAGE_TREND);
+    Display_Render(&Data);
+    OLED_Update();
+
+    Cost->Seconds += Now() - start;
+    Cost->Bytes += OLED_GetBusBytes() - bytes;
+    Cost->PinWrites += Ssd1306_PinWrites - pins;
+}
+
+/**
+ * @brief  检查当前屏幕与整屏重绘的结果一致
+ * @details 不推进采样，整屏重绘后再比较，开销不计入
+ */
+static void Check_Screen(uint32_t Sample)
+{
+    static uint8_t shown[OLED_PAGE_NUM][OLED_WIDTH];
+    Cost_t ignore = {0};
+
+    memcpy(shown, Ssd1306_Gram, sizeof(shown));
+    Frame(&ignore, 1);
+    CHECK(memcmp(shown, Ssd1306_Gram, sizeof(shown)) == 0, "sample %lu: incremental screen differs from full redraw",
+          (unsigned long)Sample);
+}
+
+static void Report(const char *Name, const Cost_t *Cost)
+{
+    printf("  %-12s %8.1f bytes %10.1f pin writes %8.2f us  per sample\n", Name, (double)Cost->Bytes / SAMPLES,
+           (double)Cost->PinWrites / SAMPLES, Cost->Seconds * 1e6 / SAMPLES);
+}
+
+int main(void)
+{
+    Cost_t incremental = {0}, full = {0}, ignore = {0};
+    uint32_t i;
+
+    OLED_Init();
+    Display_Init();
+    Data.temp    = DISPLAY_FIXED(25, 0);
+    Data.humi    = DISPLAY_FIXED(60, 5);
+    Data.uvLevel = 3;
+
+    // 进入趋势页的首帧两种做法相同，不计入
+    Display_SetPage(DISPLAY_PAGE_TREND);
+    Frame(&ignore, 0);
+
+    for (i = 1; i <= SAMPLES; i++) {
+        Next_Sample();
+        Frame(&incremental, 0);
+        if (i % CHECK_EVERY == 0) Check_Screen(i);
+    }
+    Check_Screen(SAMPLES);
+
+    for (i = 1; i <= SAMPLES; i++) {
+        Next_Sample();
+        Frame(&full, 1);
+    }
+
+    printf("trend page, %d samples:\n", SAMPLES);
+    Report("incremental", &incremental);
+    Report("full redraw", &full);
+    printf("  bus bytes %.1fx less, pin writes %.1fx less\n", (double)full.Bytes / incremental.Bytes,
+           (double)full.PinWrites / incremental.PinWrites);
+
+    CHECK(incremental.Bytes * 10 < full.Bytes, "incremental rendering no longer saves bus traffic");
+    CHECK(Ssd1306_BadAddress == 0, "wrong slave address");
+    return TEST_END("bench_trend");
+}
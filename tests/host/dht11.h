@@ -0,0 +1,10 @@
+/**
+ * @file     dht11.h
+ * @brief    主机测试用头文件转接
+ * @details  见dk_C8T6.h
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "../../DK/DHT11.h"
@@ -0,0 +1,11 @@
+/**
+ * @file     dk_C8T6.h
+ * @brief    主机测试用头文件转接
+ * @details  工程源文件按Windows的习惯以不同大小写包含头文件，
+ *          主机测试在区分大小写的文件系统上编译，由这里转到实际的文件
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "../../DK/DK_C8T6.h"
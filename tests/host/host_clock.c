@@ -0,0 +1,41 @@
+/**
+ * @file     host_clock.c
+ * @brief    主机测试用模拟时钟
+ * @details  见host_clock.h
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "host_clock.h"
+#include "Delay.h"
+
+uint32_t Host_ClockStep = 4;
+
+static uint32_t Host_Cycles = 0; /**< 模拟的CYCCNT */
+
+uint32_t *Host_CycCnt(void)
+{
+    Host_Cycles += Host_ClockStep;
+    return &Host_Cycles;
+}
+
+void Host_ClockSet(uint32_t Cycles)
+{
+    Host_Cycles = Cycles;
+}
+
+uint32_t Host_ClockGet(void)
+{
+    return Host_Cycles;
+}
+
+uint32_t Host_ClockMicros(void)
+{
+    return Host_Cycles / DELAY_CPU_MHZ;
+}
+
+void Host_ClockSetMicros(uint32_t Us)
+{
+    Host_Cycles = Us * DELAY_CPU_MHZ;
+}
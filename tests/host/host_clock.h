@@ -0,0 +1,53 @@
+/**
+ * @file     host_clock.h
+ * @brief    主机测试用模拟时钟
+ * @details  以DWT的CYCCNT为唯一时基，在主机上代替真实的周期计数器：
+ *          - 编译时定义 -D"DELAY_CYCCNT=(*Host_CycCnt())"，每次读取推进Host_ClockStep个周期，
+ *            相当于一次循环的开销，忙等的延时函数因此能够结束
+ *          - 其他计时外设（如TIM4的微秒计数）由测试桩函数从同一计数换算
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __HOST_CLOCK_H
+#define __HOST_CLOCK_H
+
+#include <stdint.h>
+
+/** @brief 每次读取CYCCNT推进的周期数，默认4 */
+extern uint32_t Host_ClockStep;
+
+/**
+ * @brief  读取模拟的CYCCNT
+ * @details 先推进Host_ClockStep个周期，再返回计数变量的地址
+ * @return uint32_t* 计数变量
+ */
+uint32_t *Host_CycCnt(void);
+
+/**
+ * @brief  设置模拟时钟
+ * @param  Cycles 周期计数
+ */
+void Host_ClockSet(uint32_t Cycles);
+
+/**
+ * @brief  读取模拟时钟（不推进）
+ * @return uint32_t 周期计数
+ */
+uint32_t Host_ClockGet(void);
+
+/**
+ * @brief  读取模拟时钟的微秒数（不推进）
+ * @details 按DELAY_CPU_MHZ换算，供TIM_GetCounter等桩函数使用
+ * @return uint32_t 微秒数
+ */
+uint32_t Host_ClockMicros(void);
+
+/**
+ * @brief  将模拟时钟设置为指定微秒
+ * @param  Us 微秒数
+ */
+void Host_ClockSetMicros(uint32_t Us);
+
+#endif /* __HOST_CLOCK_H */
@@ -0,0 +1,39 @@
+/**
+ * @file     host_os.c
+ * @brief    主机测试用内核外设替身
+ * @details  SysTick、SCB和PRIMASK的模拟，见host_os.h
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "host_os.h"
+
+SysTick_Type Host_SysTick;
+SCB_Type Host_Scb;
+uint32_t Host_Primask;
+uint32_t SystemCoreClock = 72000000;
+
+uint32_t __get_PRIMASK(void)
+{
+    return Host_Primask;
+}
+
+void __set_PRIMASK(uint32_t priMask)
+{
+    Host_Primask = priMask;
+    Host_PendSV();
+}
+
+void __set_PSP(uint32_t topOfProcStack) {}
+
+void Host_DisableIrq(void)
+{
+    Host_Primask = 1;
+}
+
+void Host_EnableIrq(void)
+{
+    Host_Primask = 0;
+    Host_PendSV();
+}
@@ -0,0 +1,49 @@
+/**
+ * @file     host_os.h
+ * @brief    主机测试用内核外设替身
+ * @details  以 -include 方式编译Os.c，源文件不做改动：
+ *          - 先包含真实的stm32f10x.h，再把SysTick、SCB换成内存中的同类型结构，
+ *            开关中断和NVIC优先级设置换成主机函数，目标上的内联汇编不会被使用
+ *          - PRIMASK由Host_Primask模拟，开中断时调用测试实现的Host_PendSV，
+ *            由测试决定是否在此处切换线程
+ *          - 内存屏障可由 -D"HOST_DMB()=..." 重新定义为模拟抢占点
+ *          - PendSV_Handler改名为未使用的静态函数，x86上不生成其中的ARM汇编
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __HOST_OS_H
+#define __HOST_OS_H
+
+#include "stm32f10x.h"
+
+extern SysTick_Type Host_SysTick; /**< SysTick寄存器 */
+extern SCB_Type Host_Scb;         /**< SCB寄存器 */
+extern uint32_t Host_Primask;     /**< 中断屏蔽状态 */
+
+#undef SysTick
+#undef SCB
+#define SysTick (&Host_SysTick)
+#define SCB     (&Host_Scb)
+
+#define __disable_irq()               Host_DisableIrq()
+#define __enable_irq()                Host_EnableIrq()
+#define NVIC_SetPriority(IRQn, Prio)  ((void)(IRQn), (void)(Prio))
+#define PendSV_Handler                static Host_PendSVUnused
+
+#ifndef HOST_DMB
+#define HOST_DMB() __sync_synchronize()
+#endif
+#define __DMB() HOST_DMB()
+
+void Host_DisableIrq(void);
+void Host_EnableIrq(void);
+
+/**
+ * @brief  PendSV挂起且中断打开时的切换点
+ * @details 由测试程序实现，在__set_PRIMASK和开中断之后调用
+ */
+void Host_PendSV(void);
+
+#endif /* __HOST_OS_H */
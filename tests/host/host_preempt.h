@@ -0,0 +1,19 @@
+/**
+ * @file     host_preempt.h
+ * @brief    主机测试用模拟抢占点
+ * @details  被测源文件中的屏障宏重新定义为Host_Preempt()，
+ *          由测试程序实现，在该处按优先级插入其他上下文
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __HOST_PREEMPT_H
+#define __HOST_PREEMPT_H
+
+/**
+ * @brief  模拟抢占点
+ */
+void Host_Preempt(void);
+
+#endif /* __HOST_PREEMPT_H */
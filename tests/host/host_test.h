@@ -0,0 +1,38 @@
+/**
+ * @file     host_test.h
+ * @brief    主机测试公共定义
+ * @details  提供检查宏和结果汇总，每个测试程序包含一次：
+ *          - CHECK失败时打印位置和说明，继续执行后续检查
+ *          - TEST_END打印结果，返回值作为进程退出码
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __HOST_TEST_H
+#define __HOST_TEST_H
+
+#include <stdio.h>
+
+static int Test_Fails = 0; /**< 失败的检查数 */
+
+/**
+ * @brief 检查条件，失败时打印文件、行号和说明
+ */
+#define CHECK(cond, ...)                                          \
+    do {                                                          \
+        if (!(cond)) {                                            \
+            Test_Fails++;                                         \
+            printf("FAIL %s:%d: ", __FILE__, __LINE__);           \
+            printf(__VA_ARGS__);                                  \
+            printf("\n");                                         \
+        }                                                         \
+    } while (0)
+
+/**
+ * @brief 打印测试结果，返回失败数
+ */
+#define TEST_END(name) \
+    (printf("%s: %s (%d failures)\n", (name), Test_Fails ? "FAILED" : "PASSED", Test_Fails), Test_Fails)
+
+#endif /* __HOST_TEST_H */
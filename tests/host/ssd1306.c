@@ -0,0 +1,73 @@
+/**
+ * @file     ssd1306.c
+ * @brief    主机测试用SSD1306屏幕模型
+ * @details  见ssd1306.h
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h"
+#include "ssd1306.h"
+
+uint8_t Ssd1306_Gram[OLED_PAGE_NUM][OLED_WIDTH];
+uint32_t Ssd1306_Bytes      = 0;
+uint32_t Ssd1306_PinWrites  = 0;
+uint32_t Ssd1306_BadAddress = 0;
+
+static uint8_t Bus_Scl = 1, Bus_Sda = 1; /**< 引脚电平 */
+static uint8_t Bus_Active;               /**< 起始信号之后 */
+static uint8_t Bus_Bit, Bus_Byte;        /**< 当前字节已收到的位数和内容 */
+static uint16_t Bus_Index;               /**< 本次传输已收到的字节数 */
+static uint8_t Bus_Control;              /**< 本次传输的控制字节 */
+static uint8_t Gram_Page, Gram_Col;      /**< 屏幕光标 */
+
+/**
+ * @brief  处理一个字节：地址、控制字节、命令或数据
+ */
+static void Ssd1306_Byte(uint8_t Byte)
+{
+    Ssd1306_Bytes++;
+    if (Bus_Index == 0) {
+        if (Byte != 0x78) Ssd1306_BadAddress++;
+    } else if (Bus_Index == 1) {
+        Bus_Control = Byte;
+    } else if (Bus_Control == OLED_BURST_DATA) {
+        Ssd1306_Gram[Gram_Page][Gram_Col] = Byte;
+        Gram_Col = (Gram_Col + 1) & (OLED_WIDTH - 1);
+    } else if ((Byte & 0xF8) == 0xB0) {
+        Gram_Page = Byte & 0x07;
+    } else if ((Byte & 0xF0) == 0x10) {
+        Gram_Col = (Gram_Col & 0x0F) | ((Byte & 0x0F) << 4);
+    } else if ((Byte & 0xF0) == 0x00) {
+        Gram_Col = (Gram_Col & 0xF0) | (Byte & 0x0F);
+    }
+    Bus_Index++;
+}
+
+void GPIO_WriteBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, BitAction BitVal)
+{
+    uint8_t level = BitVal != Bit_RESET;
+
+    Ssd1306_PinWrites++;
+    if (GPIO_Pin == GPIO_Pin_9) { // SDA
+        if (Bus_Scl && Bus_Sda && !level) { // 起始
+            Bus_Active = 1;
+            Bus_Bit    = 0;
+            Bus_Index  = 0;
+        } else if (Bus_Scl && !Bus_Sda && level) { // 停止
+            Bus_Active = 0;
+        }
+        Bus_Sda = level;
+    } else if (GPIO_Pin == GPIO_Pin_8) { // SCL
+        if (!Bus_Scl && level && Bus_Active) {
+            if (Bus_Bit < 8) {
+                Bus_Byte = (uint8_t)(Bus_Byte << 1) | Bus_Sda;
+                if (++Bus_Bit == 8) Ssd1306_Byte(Bus_Byte);
+            } else {
+                Bus_Bit = 0; // 第9个时钟为应答位
+            }
+        }
+        Bus_Scl = level;
+    }
+}
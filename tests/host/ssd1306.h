@@ -0,0 +1,22 @@
+/**
+ * @file     ssd1306.h
+ * @brief    主机测试用SSD1306屏幕模型
+ * @details  代替GPIO_WriteBit，把OLED.c软件I2C输出的SCL/SDA波形解码为字节，
+ *          按页寻址模式写入模拟的显存，供测试比较屏幕内容和统计总线开销
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#ifndef __SSD1306_H
+#define __SSD1306_H
+
+#include <stdint.h>
+#include "OLED.h"
+
+extern uint8_t Ssd1306_Gram[OLED_PAGE_NUM][OLED_WIDTH]; /**< 屏幕显存 */
+extern uint32_t Ssd1306_Bytes;                          /**< 解码得到的字节总数 */
+extern uint32_t Ssd1306_PinWrites;                      /**< 引脚写入次数，即软件I2C的CPU开销 */
+extern uint32_t Ssd1306_BadAddress;                     /**< 从机地址错误的传输数 */
+
+#endif /* __SSD1306_H */
@@ -0,0 +1,489 @@
+/**
+ * @file     test_ad.c
+ * @brief    ADC服务主机测试
+ * @details  AD.c直接包含在本文件中，以便调用其中的静态函数并写入DMA缓冲；外设库由桩函数代替：
+ *          - AD_SetWindow：周期为0、窗口过短、累加值可能超过32位、半缓冲数超过16位时的限制，
+ *            满量程采样累加到窗口结束不溢出
+ *          - AD_Accumulate：窗口内不输出，窗口结束时输出平均值并清零
+ *          - DMA1_Channel1_IRQHandler：半满读前半、全满读后半，半满和全满同时挂起时
+ *            连续两次中断各处理一半；按已知内容的半缓冲检查各通道的Value和Seq，
+ *            注入组每次中断读取一次结果并重新触发
+ *          - AD_Register：通道10~15、转换组已满、扫描已启动时拒绝，不占用位置
+ *          - AD_Start：桩函数按外设库的方式写入模拟的SQR、JSQR、SMPR寄存器并记录调用顺序，
+ *            检查内部参考电压、温度传感器（注入组）和PA0的序列，注入组长度在通道之前设置
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include "AD.c"
+#include "host_test.h"
+
+static uint32_t Rand_State = 1; /**< 伪随机数状态 */
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+/* ---------------- 桩函数 ---------------- */
+
+static uint32_t Dma_Pending;               /**< 挂起的DMA中断，DMA1_IT_HT1、DMA1_IT_TC1 */
+static uint8_t Jeoc;                       /**< 注入组转换完成 */
+static uint16_t Injected_Dr[AD_INJECTED_MAX]; /**< 注入组数据寄存器 */
+static uint32_t Injected_Starts;           /**< 注入组触发次数 */
+static ADC_TypeDef Adc;                    /**< 序列和采样时间寄存器 */
+static uint8_t Adc_Channels;               /**< ADC_Init设置的规则通道数 */
+static DMA_InitTypeDef Dma;                /**< DMA_Init的参数 */
+static char Calls[32];                     /**< 配置函数的调用顺序，见各桩函数 */
+static GPIO_TypeDef *Gpio_Port;            /**< 最近一次配置的引脚 */
+static uint16_t Gpio_Pin;
+static uint32_t Gpio_Inits;                /**< 引脚配置次数 */
+
+/** @brief 记录一次调用 */
+static void Call(char Name)
+{
+    size_t len = strlen(Calls);
+
+    if (len < sizeof(Calls) - 1) Calls[len] = Name;
+}
+
+/** @brief 与外设库相同：通道0~9在SMPR2，10~17在SMPR1，每个3位 */
+static void Set_SampleTime(uint8_t Channel, uint8_t SampleTime)
+{
+    if (Channel > ADC_Channel_9) {
+        Adc.SMPR1 = (Adc.SMPR1 & ~(7UL << 3 * (Channel - 10))) | (uint32_t)SampleTime << 3 * (Channel - 10);
+    } else {
+        Adc.SMPR2 = (Adc.SMPR2 & ~(7UL << 3 * Channel)) | (uint32_t)SampleTime << 3 * Channel;
+    }
+}
+
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {}
+void RCC_AHBPeriphClockCmd(uint32_t RCC_AHBPeriph, FunctionalState NewState) {}
+void RCC_ADCCLKConfig(uint32_t RCC_PCLK2) {}
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct)
+{
+    CHECK(GPIO_InitStruct->GPIO_Mode == GPIO_Mode_AIN, "pin is not an analog input");
+    Gpio_Port = GPIOx;
+    Gpio_Pin  = GPIO_InitStruct->GPIO_Pin;
+    Gpio_Inits++;
+}
+void NVIC_PriorityGroupConfig(uint32_t NVIC_PriorityGroup) {}
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct) {}
+
+void ADC_Cmd(ADC_TypeDef *ADCx, FunctionalState NewState) {}
+void ADC_ResetCalibration(ADC_TypeDef *ADCx) {}
+FlagStatus ADC_GetResetCalibrationStatus(ADC_TypeDef *ADCx) { return RESET; }
+void ADC_StartCalibration(ADC_TypeDef *ADCx) {}
+FlagStatus ADC_GetCalibrationStatus(ADC_TypeDef *ADCx) { return RESET; }
+void ADC_TempSensorVrefintCmd(FunctionalState NewState) {}
+void ADC_Init(ADC_TypeDef *ADCx, ADC_InitTypeDef *ADC_InitStruct)
+{
+    Call('I');
+    Adc_Channels = ADC_InitStruct->ADC_NbrOfChannel;
+}
+void ADC_DMACmd(ADC_TypeDef *ADCx, FunctionalState NewState) { Call('A'); }
+void ADC_SoftwareStartConvCmd(ADC_TypeDef *ADCx, FunctionalState NewState) { Call('S'); }
+void ADC_ExternalTrigInjectedConvConfig(ADC_TypeDef *ADCx, uint32_t ADC_ExternalTrigInjecConv) { Call('T'); }
+
+/** @brief 与外设库相同：位置1~6在SQR3，7~12在SQR2，13~16在SQR1 */
+void ADC_RegularChannelConfig(ADC_TypeDef *ADCx, uint8_t ADC_Channel, uint8_t Rank, uint8_t ADC_SampleTime)
+{
+    volatile uint32_t *sqr = Rank < 7 ? &Adc.SQR3 : Rank < 13 ? &Adc.SQR2 : &Adc.SQR1;
+    uint8_t shift          = (uint8_t)(5 * ((Rank - 1) % 6));
+
+    Call('R');
+    Set_SampleTime(ADC_Channel, ADC_SampleTime);
+    *sqr = (*sqr & ~(0x1FUL << shift)) | (uint32_t)ADC_Channel << shift;
+}
+
+/** @brief 与外设库相同：设置JL */
+void ADC_InjectedSequencerLengthConfig(ADC_TypeDef *ADCx, uint8_t Length)
+{
+    Call('L');
+    Adc.JSQR = (Adc.JSQR & ~(3UL << 20)) | (uint32_t)(Length - 1) << 20;
+}
+
+/**
+ * @brief  与外设库相同：按当前的JL计算位置
+ * @details 长度为JL+1时，第Rank个通道在JSQ(Rank+3-JL)，先设置通道后设置长度会写错位置
+ */
+void ADC_InjectedChannelConfig(ADC_TypeDef *ADCx, uint8_t ADC_Channel, uint8_t Rank, uint8_t ADC_SampleTime)
+{
+    uint32_t jl   = (Adc.JSQR >> 20) & 3;
+    uint8_t shift = (uint8_t)(5 * ((Rank + 3) - (jl + 1)));
+
+    Call('J');
+    Set_SampleTime(ADC_Channel, ADC_SampleTime);
+    Adc.JSQR = (Adc.JSQR & ~(0x1FUL << shift)) | (uint32_t)ADC_Channel << shift;
+}
+
+/** @brief 注入组转换立即完成 */
+void ADC_SoftwareStartInjectedConvCmd(ADC_TypeDef *ADCx, FunctionalState NewState)
+{
+    Call('s');
+    Injected_Starts++;
+    Jeoc = 1;
+}
+FlagStatus ADC_GetFlagStatus(ADC_TypeDef *ADCx, uint8_t ADC_FLAG)
+{
+    return ADC_FLAG == ADC_FLAG_JEOC && Jeoc ? SET : RESET;
+}
+void ADC_ClearFlag(ADC_TypeDef *ADCx, uint8_t ADC_FLAG)
+{
+    if (ADC_FLAG == ADC_FLAG_JEOC) Jeoc = 0;
+}
+uint16_t ADC_GetInjectedConversionValue(ADC_TypeDef *ADCx, uint8_t ADC_InjectedChannel)
+{
+    return Injected_Dr[(ADC_InjectedChannel - ADC_InjectedChannel_1) / 4];
+}
+
+void DMA_Init(DMA_Channel_TypeDef *DMAy_Channelx, DMA_InitTypeDef *DMA_InitStruct)
+{
+    Call('D');
+    Dma = *DMA_InitStruct;
+}
+void DMA_ITConfig(DMA_Channel_TypeDef *DMAy_Channelx, uint32_t DMA_IT, FunctionalState NewState) {}
+void DMA_Cmd(DMA_Channel_TypeDef *DMAy_Channelx, FunctionalState NewState) { Call('d'); }
+ITStatus DMA_GetITStatus(uint32_t DMAy_IT) { return Dma_Pending & DMAy_IT ? SET : RESET; }
+void DMA_ClearITPendingBit(uint32_t DMAy_IT) { Dma_Pending &= ~DMAy_IT; }
+
+/**
+ * @brief  恢复到AD_Init之后的状态
+ * @details 注入组保留AD_Init注册的内部参考电压和温度传感器，清除其累加状态
+ */
+static void Reset(void)
+{
+    AD_RegularNum  = 0;
+    AD_InjectedNum = 2;
+    AD_HalfScans   = 0;
+    AD_Started     = 0;
+    AD_BlockCount  = 0;
+    AD_Vref.Count = AD_Temp.Count = 0;
+    AD_Vref.Acc = AD_Temp.Acc = 0;
+    AD_Vref.Value = AD_Temp.Value = 0;
+    AD_Vref.Seq = AD_Temp.Seq = 0;
+    memset(&Adc, 0, sizeof(Adc));
+    memset(Calls, 0, sizeof(Calls));
+    Injected_Starts = 0;
+    Jeoc            = 0;
+    Dma_Pending     = 0;
+}
+
+/* ---------------- 平均窗口 ---------------- */
+
+/** @brief 换算窗口并检查半缓冲数和采样数 */
+static void Expect_Window(uint16_t PeriodMs, uint32_t HalfUs, uint32_t PerBlock, uint16_t Blocks)
+{
+    AD_Channel_t c = {0};
+
+    c.PeriodMs = PeriodMs;
+    AD_SetWindow(&c, HalfUs, PerBlock);
+    CHECK(c.Blocks == Blocks && c.Samples == (uint32_t)Blocks * PerBlock,
+          "window %u ms, half %lu us, %lu per block: %u blocks %lu samples, expected %u", PeriodMs,
+          (unsigned long)HalfUs, (unsigned long)PerBlock, c.Blocks, (unsigned long)c.Samples, Blocks);
+}
+
+/**
+ * @brief  平均窗口的换算和限制
+ * @details 一个规则通道、239.5周期时半个缓冲为96轮扫描、2688us
+ */
+static void Test_Window(void)
+{
+    const uint32_t limit96 = 0xFFFFFFFFUL / 4095 / 96; // 10925
+    AD_Channel_t c = {0};
+    uint32_t i;
+
+    Expect_Window(0, 2688, 96, 1);            // 每半个缓冲输出
+    Expect_Window(1, 2688, 96, 1);            // 不足一个半缓冲
+    Expect_Window(1000, 2688, 96, 372);       // 1000000/2688，舍去
+    Expect_Window(65535, 2688, 96, limit96);  // 24380个半缓冲的累加值超过32位
+    Expect_Window(65535, 1, 96, limit96);     // 同上，换算值远大于16位
+    Expect_Window(65535, 149, 1, 0xFFFF);     // 注入通道：439832个半缓冲，限制为16位
+    Expect_Window(65535, 149, 12, 0xFFFF);    // 两项限制都超出时取较小的
+    Expect_Window(65535, 0xFFFFFFFF, 96, 1);  // 半缓冲极长
+
+    // 限制后的窗口内全是满量程采样，累加值不溢出
+    c.PeriodMs = 65535;
+    AD_SetWindow(&c, 2688, 96);
+    for (i = 0; i < c.Blocks; i++) {
+        CHECK(c.Seq == 0, "output after %lu of %u blocks", (unsigned long)i, c.Blocks);
+        AD_Accumulate(&c, 4095 * 96);
+    }
+    CHECK(c.Seq == 1 && c.Value == 4095 && c.Acc == 0 && c.Count == 0, "full scale window: value %u seq %lu",
+          c.Value, (unsigned long)c.Seq);
+}
+
+/** @brief 窗口结束时输出平均值（舍去），下一个窗口从0开始 */
+static void Test_Accumulate(void)
+{
+    AD_Channel_t c = {0};
+
+    c.PeriodMs = 3;
+    AD_SetWindow(&c, 1000, 4); // 3个半缓冲，12个采样
+    AD_Accumulate(&c, 4 * 100);
+    AD_Accumulate(&c, 4 * 200);
+    CHECK(c.Seq == 0 && c.Value == 0 && c.Count == 2, "output inside the window");
+    AD_Accumulate(&c, 4 * 300 + 11); // 平均200.9
+    CHECK(c.Seq == 1 && c.Value == 200 && c.Acc == 0 && c.Count == 0, "first window: value %u seq %lu", c.Value,
+          (unsigned long)c.Seq);
+    AD_Accumulate(&c, 4 * 4095);
+    AD_Accumulate(&c, 4 * 4095);
+    AD_Accumulate(&c, 4 * 4095);
+    CHECK(c.Seq == 2 && c.Value == 4095, "second window: value %u seq %lu", c.Value, (unsigned long)c.Seq);
+}
+
+/* ---------------- 注册与启动 ---------------- */
+
+/**
+ * @brief  拒绝注册的情况
+ * @details 失败的注册不配置引脚、不占用位置，不修改句柄
+ */
+static void Test_Register(void)
+{
+    static const uint8_t channels[AD_REGULAR_MAX] = {0, 1, 2, 3, 4, 7, 8, 9};
+    AD_Channel_t ch[AD_REGULAR_MAX + 4], spare;
+    uint32_t inits;
+    uint8_t i;
+
+    Reset();
+    CHECK(AD_InjectedNum == 2 && AD_Injected[0] == &AD_Vref && AD_Injected[1] == &AD_Temp,
+          "AD_Init registers Vrefint then the temperature sensor");
+
+    // 通道10~15在48脚封装上没有引出，18以上不存在
+    for (i = ADC_Channel_10; i <= 18; i++) {
+        if (i == ADC_Channel_16 || i == ADC_Channel_17) continue;
+        inits          = Gpio_Inits;
+        spare.Rank     = 0xAA;
+        CHECK(!AD_Register(&spare, i, ADC_SampleTime_55Cycles5, AD_GROUP_REGULAR, 10), "channel %u accepted", i);
+        CHECK(!AD_Register(&spare, i, ADC_SampleTime_55Cycles5, AD_GROUP_INJECTED, 10), "injected channel %u accepted",
+              i);
+        CHECK(Gpio_Inits == inits && spare.Rank == 0xAA, "rejected channel %u was configured", i);
+    }
+    CHECK(AD_RegularNum == 0 && AD_InjectedNum == 2, "rejected channels took a slot");
+
+    // 规则组：PA0~PA7、PB0~PB1，满后拒绝
+    for (i = 0; i < AD_REGULAR_MAX; i++) {
+        CHECK(AD_Register(&ch[i], channels[i], ADC_SampleTime_55Cycles5, AD_GROUP_REGULAR, 10),
+              "regular channel %u rejected", channels[i]);
+        CHECK(channels[i] <= ADC_Channel_7 ? Gpio_Port == GPIOA && Gpio_Pin == 1 << channels[i]
+                                           : Gpio_Port == GPIOB && Gpio_Pin == 1 << (channels[i] - 8),
+              "channel %u pin", channels[i]);
+        CHECK(ch[i].Rank == i && AD_Regular[i] == &ch[i], "channel %u rank %u", channels[i], ch[i].Rank);
+    }
+    inits      = Gpio_Inits;
+    spare.Rank = 0xAA;
+    CHECK(!AD_Register(&spare, ADC_Channel_5, ADC_SampleTime_55Cycles5, AD_GROUP_REGULAR, 10), "regular group overflow");
+    CHECK(AD_RegularNum == AD_REGULAR_MAX && Gpio_Inits == inits && spare.Rank == 0xAA,
+          "full regular group was modified");
+
+    // 注入组：AD_Init已注册2个，同一通道可以再注册
+    CHECK(AD_Register(&ch[AD_REGULAR_MAX], ADC_Channel_16, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, 100) &&
+              AD_Register(&ch[AD_REGULAR_MAX + 1], ADC_Channel_6, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, 100),
+          "injected group rejected a third or fourth channel");
+    CHECK(ch[AD_REGULAR_MAX + 1].Rank == 3 && AD_Injected[3] == &ch[AD_REGULAR_MAX + 1], "injected rank");
+    CHECK(!AD_Register(&spare, ADC_Channel_17, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, 100) &&
+              AD_InjectedNum == AD_INJECTED_MAX && spare.Rank == 0xAA,
+          "injected group overflow");
+
+    // 没有规则通道时不启动，仍可注册
+    Reset();
+    AD_Start();
+    CHECK(!AD_Started && Calls[0] == 0, "started without a regular channel");
+    CHECK(AD_Register(&ch[0], ADC_Channel_0, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 0), "register after no-op start");
+
+    // 启动后拒绝，两个组都有空位
+    AD_Start();
+    CHECK(AD_Started, "not started");
+    inits = Gpio_Inits;
+    CHECK(!AD_Register(&spare, ADC_Channel_1, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 0) &&
+              !AD_Register(&spare, ADC_Channel_17, ADC_SampleTime_239Cycles5, AD_GROUP_INJECTED, 0),
+          "register after start");
+    CHECK(AD_RegularNum == 1 && AD_InjectedNum == 2 && Gpio_Inits == inits, "register after start took a slot");
+    memset(Calls, 0, sizeof(Calls));
+    AD_Start();
+    CHECK(Calls[0] == 0, "second start reconfigured the ADC");
+}
+
+/**
+ * @brief  序列寄存器和配置顺序
+ * @details 注入组2个通道时JL=1，第1、2个位于JSQ3、JSQ4：JSQR = 1<<20 | 16<<15 | 17<<10
+ */
+static void Test_Sequence(void)
+{
+    AD_Channel_t pa0, pb1, pa5;
+    const char *length, *channel;
+
+    Reset();
+    CHECK(AD_Register(&pa0, ADC_Channel_0, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 0), "register PA0");
+    AD_Start();
+    CHECK(Adc.JSQR == (1UL << 20 | 16UL << 15 | 17UL << 10), "JSQR %08lx, expected 00108800", (unsigned long)Adc.JSQR);
+    CHECK(Adc.SQR3 == 0 && Adc.SQR2 == 0 && Adc.SQR1 == 0 && Adc_Channels == 1, "regular sequence: SQR3 %08lx",
+          (unsigned long)Adc.SQR3);
+    CHECK(Adc.SMPR2 == 7 && Adc.SMPR1 == (7UL << 18 | 7UL << 21), "sample times: SMPR1 %08lx SMPR2 %08lx",
+          (unsigned long)Adc.SMPR1, (unsigned long)Adc.SMPR2);
+
+    // 注入组长度在通道之前设置，触发在DMA就绪之后
+    length  = strchr(Calls, 'L');
+    channel = strchr(Calls, 'J');
+    CHECK(length && channel && length < channel && strrchr(Calls, 'L') == length, "injected setup order: %s", Calls);
+    CHECK(strcmp(strchr(Calls, 'D'), "DdASs") == 0, "start order: %s", Calls);
+    CHECK(Dma.DMA_BufferSize == AD_BUF_LEN && Dma.DMA_MemoryBaseAddr == (uint32_t)(uintptr_t)AD_Buf &&
+              Dma.DMA_Mode == DMA_Mode_Circular,
+          "DMA: %lu half-words", (unsigned long)Dma.DMA_BufferSize);
+
+    // 规则组按注册顺序，缓冲长度取通道数的偶数倍：192/3/2=32轮
+    Reset();
+    AD_Register(&pa0, ADC_Channel_0, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 0);
+    AD_Register(&pb1, ADC_Channel_9, ADC_SampleTime_1Cycles5, AD_GROUP_REGULAR, 0);
+    AD_Register(&pa5, ADC_Channel_5, ADC_SampleTime_28Cycles5, AD_GROUP_REGULAR, 0);
+    AD_Start();
+    CHECK(Adc.SQR3 == (0UL | 9UL << 5 | 5UL << 10) && Adc_Channels == 3, "regular sequence: SQR3 %08lx",
+          (unsigned long)Adc.SQR3);
+    CHECK(Adc.SMPR2 == (7UL | 3UL << 15), "sample times: SMPR2 %08lx", (unsigned long)Adc.SMPR2);
+    CHECK(AD_HalfScans == 32 && Dma.DMA_BufferSize == 192, "scans %u, DMA %lu", AD_HalfScans,
+          (unsigned long)Dma.DMA_BufferSize);
+    CHECK(Adc.JSQR == (1UL << 20 | 16UL << 15 | 17UL << 10), "JSQR %08lx after reset", (unsigned long)Adc.JSQR);
+}
+
+/* ---------------- DMA中断 ---------------- */
+
+#define HALF_SCANS 48 /**< 两个规则通道时半个缓冲的扫描轮数 */
+
+static AD_Channel_t Pa0, Pa1;     /**< 规则组：每半个缓冲输出、10ms输出 */
+static uint32_t Half_Sum[2][2];   /**< 两半缓冲中各规则通道的采样之和 */
+
+/** @brief 写入半个缓冲，Value为负时随机 */
+static void Fill_Half(uint8_t Half, int Value0, int Value1)
+{
+    volatile uint16_t *scan = &AD_Buf[Half * HALF_SCANS * 2];
+    uint16_t i;
+
+    Half_Sum[Half][0] = Half_Sum[Half][1] = 0;
+    for (i = 0; i < HALF_SCANS; i++) {
+        *scan = (uint16_t)(Value0 < 0 ? Rand() % 4096 : (uint32_t)Value0);
+        Half_Sum[Half][0] += *scan++;
+        *scan = (uint16_t)(Value1 < 0 ? Rand() % 4096 : (uint32_t)Value1);
+        Half_Sum[Half][1] += *scan++;
+    }
+}
+
+/** @brief 挂起中断并执行一次中断服务函数 */
+static void Irq(uint32_t Pending)
+{
+    Dma_Pending |= Pending;
+    DMA1_Channel1_IRQHandler();
+}
+
+/**
+ * @brief  半缓冲的选择和各通道的输出
+ * @details PA0、PA1都为239.5周期，一轮扫描1008个半时钟，半个缓冲2688us：
+ *         PA1（10ms）3个半缓冲输出一次，内部通道（1000ms）372个
+ */
+static void Test_Irq(void)
+{
+    uint32_t pa1_acc = 0, vref_acc = 0, temp_acc = 0;
+    uint32_t blocks, starts, i;
+    uint8_t half;
+
+    Reset();
+    CHECK(AD_Register(&Pa0, ADC_Channel_0, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 0), "register PA0");
+    CHECK(AD_Register(&Pa1, ADC_Channel_1, ADC_SampleTime_239Cycles5, AD_GROUP_REGULAR, 10), "register PA1");
+    AD_Start();
+    CHECK(AD_HalfScans == HALF_SCANS && Pa0.Blocks == 1 && Pa1.Blocks == 3 && AD_Vref.Blocks == 372 &&
+              AD_Temp.Blocks == 372 && AD_Vref.Samples == 372,
+          "windows: %u scans, blocks %u %u %u", AD_HalfScans, Pa0.Blocks, Pa1.Blocks, AD_Vref.Blocks);
+    CHECK(Injected_Starts == 1 && Jeoc, "injected group not triggered at start");
+
+    // 没有挂起的中断
+    Irq(0);
+    CHECK(AD_GetBlocks() == 0 && Pa0.Seq == 0, "spurious interrupt counted");
+
+    // 半满读前半，全满读后半
+    Fill_Half(0, 100, 200);
+    Fill_Half(1, 3000, 4000);
+    Irq(DMA1_IT_HT1);
+    CHECK(Pa0.Value == 100 && Pa0.Seq == 1 && Pa1.Seq == 0 && Dma_Pending == 0, "half transfer: PA0 %u seq %lu",
+          Pa0.Value, (unsigned long)Pa0.Seq);
+    Irq(DMA1_IT_TC1);
+    CHECK(Pa0.Value == 3000 && Pa0.Seq == 2 && Pa1.Seq == 0 && Dma_Pending == 0, "transfer complete: PA0 %u seq %lu",
+          Pa0.Value, (unsigned long)Pa0.Seq);
+
+    // 半满和全满同时挂起：第一次中断处理前半，全满仍挂起，再次进入时处理后半
+    Fill_Half(0, 1000, 1500);
+    Fill_Half(1, 2000, 2500);
+    Irq(DMA1_IT_HT1 | DMA1_IT_TC1);
+    CHECK(Pa0.Value == 1000 && Pa0.Seq == 3 && Dma_Pending == DMA1_IT_TC1, "back to back: first PA0 %u", Pa0.Value);
+    CHECK(Pa1.Value == (200 + 4000 + 1500) / 3 && Pa1.Seq == 1, "PA1 after 3 halves: %u seq %lu", Pa1.Value,
+          (unsigned long)Pa1.Seq);
+    Irq(0);
+    CHECK(Pa0.Value == 2000 && Pa0.Seq == 4 && Dma_Pending == 0, "back to back: second PA0 %u", Pa0.Value);
+    Irq(0);
+    CHECK(AD_GetBlocks() == 4 && Pa0.Seq == 4, "interrupt without a pending half");
+
+    // 随机内容的半缓冲，偶尔半满和全满连续到来；注入组结果每次中断不同
+    pa1_acc = Half_Sum[1][1];
+    blocks  = 4;
+    for (i = 0; i < 2 * 372 + 8; i++) {
+        half = (uint8_t)(blocks % 2);
+        Fill_Half(half, -1, -1);
+        Injected_Dr[0] = (uint16_t)(1400 + Rand() % 200);
+        Injected_Dr[1] = (uint16_t)(1700 + Rand() % 200);
+        vref_acc += Injected_Dr[0];
+        temp_acc += Injected_Dr[1];
+        starts = Injected_Starts;
+        if (half == 0 && Rand() % 4 == 0) { // 后半也已写完，两次中断之间不改变注入组结果
+            Fill_Half(1, -1, -1);
+            Irq(DMA1_IT_HT1 | DMA1_IT_TC1);
+        } else {
+            Irq(half ? DMA1_IT_TC1 : DMA1_IT_HT1);
+        }
+        CHECK(Pa0.Value == Half_Sum[half][0] / HALF_SCANS && Pa0.Seq == blocks + 1, "block %lu: PA0 %u, expected %lu",
+              (unsigned long)blocks, Pa0.Value, (unsigned long)(Half_Sum[half][0] / HALF_SCANS));
+        CHECK(Injected_Starts == starts + 1 && Jeoc, "injected group not retriggered");
+        for (;;) {
+            blocks++;
+            pa1_acc += Half_Sum[half][1];
+            if (blocks % 3 == 0) {
+                CHECK(Pa1.Value == pa1_acc / (3 * HALF_SCANS) && Pa1.Seq == blocks / 3, "block %lu: PA1 %u, expected %lu",
+                      (unsigned long)blocks, Pa1.Value, (unsigned long)(pa1_acc / (3 * HALF_SCANS)));
+                pa1_acc = 0;
+            }
+            if (blocks == 372) {
+                CHECK(AD_Vref.Value == vref_acc / 372 && AD_Temp.Value == temp_acc / 372 && AD_Vref.Seq == 1 &&
+                          AD_Temp.Seq == 1,
+                      "internal channels: vref %u temp %u, expected %lu %lu", AD_Vref.Value, AD_Temp.Value,
+                      (unsigned long)(vref_acc / 372), (unsigned long)(temp_acc / 372));
+                CHECK(AD_GetVdd() == AD_VREFINT_MV * 4095 / AD_Vref.Value, "vdd %u", AD_GetVdd());
+                vref_acc = temp_acc = 0;
+            }
+            if (!Dma_Pending) break;
+            // 全满仍挂起：再次进入中断
+            starts = Injected_Starts;
+            half   = 1;
+            Irq(0);
+            CHECK(Pa0.Value == Half_Sum[1][0] / HALF_SCANS && Pa0.Seq == blocks + 1, "back to back block %lu: PA0 %u",
+                  (unsigned long)blocks, Pa0.Value);
+            CHECK(Injected_Starts == starts + 1, "injected group not retriggered");
+            vref_acc += Injected_Dr[0];
+            temp_acc += Injected_Dr[1];
+        }
+        if (Test_Fails > 20) break;
+    }
+    CHECK(AD_GetBlocks() == blocks && Pa0.Seq == blocks && AD_Vref.Seq == blocks / 372, "blocks %lu, seq %lu",
+          (unsigned long)AD_GetBlocks(), (unsigned long)Pa0.Seq);
+}
+
+int main(void)
+{
+    AD_Init();
+    Test_Window();
+    Test_Accumulate();
+    Test_Register();
+    Test_Sequence();
+    Test_Irq();
+
+    return TEST_END("ad");
+}
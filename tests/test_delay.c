@@ -0,0 +1,59 @@
+/**
+ * @file     test_delay.c
+ * @brief    延时函数主机测试
+ * @details  Delay.c以模拟的CYCCNT编译（见host_clock.h），检查：
+ *          - Delay_us/Delay_ms的实际周期数不少于要求，超出不超过一次读取的步长
+ *          - 计数器回绕时延时长度不变
+ *          - Delay_ms逐毫秒累加结束时刻，循环开销不累积
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_clock.h"
+#include "host_test.h"
+
+/**
+ * @brief  以指定起点运行延时，返回经过的周期数
+ */
+static uint32_t Elapsed(uint32_t Start, void (*Func)(uint32_t), uint32_t Arg)
+{
+    Host_ClockSet(Start);
+    Func(Arg);
+    return Host_ClockGet() - Start;
+}
+
+/**
+ * @brief  检查经过的周期数落在[Want, Want + Slack]
+ */
+static void Expect_Cycles(const char *Name, uint32_t Got, uint32_t Want, uint32_t Slack)
+{
+    CHECK(Got >= Want && Got - Want <= Slack, "%s: %lu cycles, want %lu(+%lu)", Name, (unsigned long)Got,
+          (unsigned long)Want, (unsigned long)Slack);
+}
+
+int main(void)
+{
+    uint32_t step = Host_ClockStep;
+
+    Expect_Cycles("us(0)", Elapsed(1000, Delay_us, 0), 0, 2 * step);
+    Expect_Cycles("us(1)", Elapsed(1000, Delay_us, 1), DELAY_CPU_MHZ, 2 * step);
+    Expect_Cycles("us(10)", Elapsed(1000, Delay_us, 10), 10 * DELAY_CPU_MHZ, 2 * step);
+    Expect_Cycles("us(10) wrap", Elapsed(0xFFFFFF00u, Delay_us, 10), 10 * DELAY_CPU_MHZ, 2 * step);
+    Expect_Cycles("ms(1)", Elapsed(0, Delay_ms, 1), DELAY_CPU_MHZ * 1000, 2 * step);
+    // 每毫秒的结束时刻由上一个结束时刻推算，多次累加的误差仍不超过一次读取
+    Expect_Cycles("ms(25)", Elapsed(12345, Delay_ms, 25), 25 * DELAY_CPU_MHZ * 1000, 2 * step);
+    Expect_Cycles("ms(25) wrap", Elapsed(0xFFFF0000u, Delay_ms, 25), 25 * DELAY_CPU_MHZ * 1000, 2 * step);
+
+    Host_ClockStep = 997; // 步长不整除每毫秒周期数，检查误差不累积
+    Expect_Cycles("s(1)", Elapsed(7, Delay_s, 1), DELAY_CPU_MHZ * 1000000, 2 * 997);
+    Expect_Cycles("us(50s)", Elapsed(0, Delay_us, 50000000), 50000000u * DELAY_CPU_MHZ, 2 * 997);
+    Host_ClockStep = step;
+
+    Host_ClockSet(0x12345678);
+    CHECK(Delay_GetCycles() == 0x12345678 + step, "Delay_GetCycles reads CYCCNT once");
+
+    return TEST_END("delay");
+}
@@ -0,0 +1,250 @@
+/**
+ * @file     test_dht11.c
+ * @brief    DHT11读取主机测试
+ * @details  外设库、单次定时和内核接口由桩函数代替，时刻取自模拟时钟（见host_clock.h），
+ *          TIM4计数为其微秒数的低16位。按传感器的时序合成下降沿序列并回放：
+ *          - 单次定时先于下一个下降沿到期时先执行超时回调，与硬件上的先后顺序一致
+ *          - 覆盖读取成功、无响应、位超时、位间隔错误、校验和错误和TIM4计数回绕
+ *          - 每次读取结束后检查外部中断关闭、单次定时停止、引脚恢复输出高电平、停止模式解锁
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h"
+#include "dht11.h"
+#include "host_clock.h"
+#include "host_test.h"
+
+void DHT11_EXTI_IRQHandler(void);
+
+/* ---------------- 桩函数 ---------------- */
+
+static uint8_t Pin_Output, Pin_Level;   /**< 数据线方向和输出电平 */
+static uint8_t Exti_Enabled, Exti_Pend; /**< 下降沿中断使能和挂起 */
+static void (*OneShot)(void);           /**< 单次定时回调，0表示未启动 */
+static uint32_t OneShot_Deadline;       /**< 单次定时到期时刻（微秒） */
+static uint16_t OneShot_Us;             /**< 最近一次单次定时的时长 */
+static int Stop_Locks, Critical;        /**< 停止模式锁、临界区嵌套 */
+static uint16_t Sem_Count;              /**< 完成信号量计数 */
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct)
+{
+    Pin_Output = GPIO_InitStruct->GPIO_Mode == GPIO_Mode_Out_PP;
+}
+void GPIO_SetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { Pin_Level = 1; }
+void GPIO_ResetBits(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { Pin_Level = 0; }
+uint8_t GPIO_ReadInputDataBit(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin) { return 1; }
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {}
+void GPIO_EXTILineConfig(uint8_t GPIO_PortSource, uint8_t GPIO_PinSource) {}
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct) {}
+
+void EXTI_Init(EXTI_InitTypeDef *EXTI_InitStruct)
+{
+    CHECK(EXTI_InitStruct->EXTI_Trigger == EXTI_Trigger_Falling, "EXTI must trigger on falling edges");
+    Exti_Enabled = EXTI_InitStruct->EXTI_LineCmd == ENABLE;
+}
+ITStatus EXTI_GetITStatus(uint32_t EXTI_Line) { return Exti_Pend ? SET : RESET; }
+void EXTI_ClearITPendingBit(uint32_t EXTI_Line) { Exti_Pend = 0; }
+
+uint16_t TIM_GetCounter(TIM_TypeDef *TIMx) { return (uint16_t)Host_ClockMicros(); }
+
+void Timer_StartOneShot(uint16_t Us, void (*Callback)(void))
+{
+    OneShot          = Callback;
+    OneShot_Us       = Us;
+    OneShot_Deadline = Host_ClockMicros() + Us;
+}
+void Timer_StopOneShot(void) { OneShot = 0; }
+
+void Os_SemInit(OsSem_t *Sem, uint16_t Count, uint16_t Max) { Sem_Count = Count; }
+void Os_SemGive(OsSem_t *Sem) { Sem_Count = 1; }
+uint8_t Os_SemTake(OsSem_t *Sem, uint32_t Timeout)
+{
+    if (!Sem_Count) return 0; // 没有中断推进，等待必然超时
+    Sem_Count--;
+    return 1;
+}
+
+void Idle_StopLock(void) { Stop_Locks++; }
+void Idle_StopUnlock(void) { Stop_Locks--; }
+uint32_t Os_EnterCritical(void) { Critical++; return 0; }
+void Os_ExitCritical(uint32_t State) { Critical--; }
+
+/* ---------------- 波形合成与回放 ---------------- */
+
+static DHT11_Status_t Done_Status; /**< 最近一次完成回调的结果 */
+static DHT11_Data_TypeDef Done_Data;
+static int Done_Count;
+
+static void On_Done(DHT11_Status_t Status, const DHT11_Data_TypeDef *Data)
+{
+    Done_Status = Status;
+    if (Status == DHT11_OK) Done_Data = *Data;
+    Done_Count++;
+}
+
+/**
+ * @brief  合成下降沿序列（相对于主机释放总线的时刻）
+ * @param  Edges 输出的下降沿时刻
+ * @param  Bytes 5字节数据
+ * @param  Delay 释放后到响应下降沿的时间
+ * @param  Stall 该位之后多等待500us（模拟传感器卡住），-1表示不插入
+ * @return 下降沿数
+ */
+static int Wave(uint32_t *Edges, const uint8_t Bytes[5], uint32_t Delay, int Stall)
+{
+    uint32_t t = Delay;
+    int n = 0, i;
+
+    Edges[n++] = t;
+    t += 160; // 响应：低80us+高80us
+    Edges[n++] = t;
+    for (i = 0; i < 40; i++) {
+        t += (Bytes[i / 8] >> (7 - i % 8)) & 1 ? 120 : 77;
+        if (i == Stall) t += 500;
+        Edges[n++] = t;
+    }
+    return n;
+}
+
+/** @brief 单次定时到期 */
+static void Fire_OneShot(void)
+{
+    void (*callback)(void) = OneShot;
+
+    Host_ClockSetMicros(OneShot_Deadline);
+    OneShot = 0;
+    callback();
+}
+
+/** @brief 数据线出现下降沿 */
+static void Fire_Edge(uint32_t Us)
+{
+    Host_ClockSetMicros(Us);
+    if (Exti_Enabled) Exti_Pend = 1;
+    DHT11_EXTI_IRQHandler();
+}
+
+/**
+ * @brief  从Start时刻启动一次读取，回放下降沿直到读取结束
+ * @details 下降沿与单次定时按时间先后交替处理
+ */
+static void Replay(uint32_t Start, const uint32_t *Edges, int Count)
+{
+    uint32_t release;
+    int i;
+
+    Host_ClockSetMicros(Start);
+    CHECK(DHT11_StartRead(On_Done) == 1, "start");
+    CHECK(OneShot && OneShot_Us == DHT11_START_US && Pin_Output && Pin_Level == 0, "start pulse");
+    CHECK(DHT11_StartRead(On_Done) == 0, "second start while busy");
+
+    Fire_OneShot();
+    CHECK(!Pin_Output && Exti_Enabled && OneShot_Us == DHT11_RESPONSE_US, "bus released");
+    release = Host_ClockMicros();
+
+    for (i = 0; i < Count && DHT11_GetState() != DHT11_STATE_IDLE; i++) {
+        if (OneShot && release + Edges[i] >= OneShot_Deadline) {
+            Fire_OneShot();
+            continue;
+        }
+        Fire_Edge(release + Edges[i]);
+    }
+    if (OneShot) Fire_OneShot();
+    CHECK(Host_ClockMicros() - Start <= DHT11_READ_MAX_US, "read took %lu us",
+          (unsigned long)(Host_ClockMicros() - Start));
+}
+
+/**
+ * @brief  检查读取结束后的资源状态
+ */
+static void Expect_Released(const char *Name)
+{
+    CHECK(DHT11_GetState() == DHT11_STATE_IDLE, "%s: state %d", Name, DHT11_GetState());
+    CHECK(!Exti_Enabled && !OneShot, "%s: EXTI/one-shot left running", Name);
+    CHECK(Pin_Output && Pin_Level == 1, "%s: data line not driven high", Name);
+    CHECK(Stop_Locks == 0 && Critical == 0, "%s: locks %d critical %d", Name, Stop_Locks, Critical);
+}
+
+/**
+ * @brief  回放一次读取，检查结果
+ */
+static void Expect_Read(const char *Name, uint32_t Start, const uint32_t *Edges, int Count, DHT11_Status_t Status)
+{
+    int before = Done_Count;
+
+    Replay(Start, Edges, Count);
+    CHECK(Done_Count == before + 1, "%s: %d callbacks", Name, Done_Count - before);
+    CHECK(Done_Status == Status, "%s: status %d, want %d", Name, Done_Status, Status);
+    Expect_Released(Name);
+}
+
+int main(void)
+{
+    static const uint8_t good[5] = {55, 0, 23, 4, 82};
+    static const uint8_t bad[5]  = {55, 0, 23, 4, 83};
+    uint32_t w[DHT11_EDGE_NUM];
+    uint16_t e[DHT11_EDGE_NUM];
+    DHT11_Data_TypeDef d;
+    int n, i;
+
+    DHT11_Init();
+
+    // 解码：直接给出下降沿时刻
+    n = Wave(w, good, 0, -1);
+    for (i = 0; i < n; i++) e[i] = (uint16_t)(0xFF00 + w[i]); // 跨越16位回绕
+    CHECK(DHT11_Decode(e, n, &d) == DHT11_OK && d.humi_int == 55 && d.temp_int == 23 && d.temp_deci == 4 &&
+              d.check_sum == 82,
+          "decode across counter wrap");
+    CHECK(DHT11_Decode(e, 0, &d) == DHT11_ERR_NO_RESPONSE, "decode no edges");
+    CHECK(DHT11_Decode(e, 1, &d) == DHT11_ERR_TIMEOUT, "decode response only");
+    CHECK(DHT11_Decode(e, 20, &d) == DHT11_ERR_TIMEOUT, "decode partial frame");
+    e[1] = e[0] + 40;
+    CHECK(DHT11_Decode(e, n, &d) == DHT11_ERR_BIT, "decode short response");
+
+    // 回放：完整的读取过程
+    n = Wave(w, good, 30, -1);
+    Expect_Read("ok", 100000, w, n, DHT11_OK);
+    CHECK(Done_Data.humi_int == 55 && Done_Data.temp_int == 23 && Done_Data.temp_deci == 4, "ok: data");
+    Expect_Read("ok across TIM4 wrap", 65536 - DHT11_START_US - 1000, w, n, DHT11_OK);
+
+    // 无响应：传感器未接，或响应晚于DHT11_RESPONSE_US
+    Expect_Read("no response", 200000, w, 0, DHT11_ERR_NO_RESPONSE);
+    n = Wave(w, good, DHT11_RESPONSE_US + 100, -1);
+    Expect_Read("late response", 300000, w, n, DHT11_ERR_NO_RESPONSE);
+
+    // 位超时：数据中途停止
+    n = Wave(w, good, 30, 17);
+    Expect_Read("stall mid-frame", 400000, w, n, DHT11_ERR_TIMEOUT);
+    n = Wave(w, good, 30, -1);
+    Expect_Read("stop after 20 edges", 500000, w, 20, DHT11_ERR_TIMEOUT);
+
+    // 位间隔错误：干扰使一位变长
+    n = Wave(w, good, 30, -1);
+    for (i = 20; i < n; i++) w[i] += 100;
+    Expect_Read("glitch", 600000, w, n, DHT11_ERR_BIT);
+
+    // 校验和错误
+    n = Wave(w, bad, 30, -1);
+    Expect_Read("checksum", 700000, w, n, DHT11_ERR_CHECKSUM);
+
+    // 释放总线之前的下降沿被忽略
+    n = Wave(w, good, 30, -1);
+    Host_ClockSetMicros(800000);
+    CHECK(DHT11_StartRead(On_Done) == 1, "start");
+    Fire_Edge(800005);
+    Fire_OneShot();
+    for (i = 0; i < n; i++) Fire_Edge(Host_ClockMicros() + (i ? w[i] - w[i - 1] : w[0]));
+    CHECK(Done_Status == DHT11_OK, "edge before release: status %d", Done_Status);
+    Expect_Released("edge before release");
+
+    // 阻塞读取：没有中断推进时等满时限后中止，释放资源
+    CHECK(DHT11_Read(&d) == DHT11_ERR_BUSY, "blocking read without interrupts");
+    Expect_Released("blocking abort");
+
+    CHECK(DHT11_READ_MAX_US == DHT11_START_US + DHT11_RESPONSE_US + 41 * DHT11_EDGE_TIMEOUT_US, "bound");
+    CHECK(DHT11_READ_TIMEOUT_MS * 1000 > DHT11_READ_MAX_US, "thread timeout shorter than read bound");
+
+    return TEST_END("dht11");
+}
@@ -0,0 +1,205 @@
+/**
+ * @file     test_event.c
+ * @brief    事件队列主机压力测试
+ * @details  Event.c的EVENT_BARRIER重新定义为模拟抢占点（Host_Preempt），
+ *          按目标上的优先级在屏障处随机插入更高优先级的上下文：
+ *          - 中断（最高）：投递1~3个中断事件，可抢占两个线程，彼此不嵌套
+ *          - 控制线程：读取若干事件，可抢占界面线程
+ *          - 界面线程（最低）：投递线程事件
+ *          事件参数中带各生产者自己的序号，读出时检查每个来源先进先出、
+ *          内容完整、没有重复，读出数加丢弃数等于投递数；另有不插入抢占的合并顺序检查
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_preempt.h"
+#include "host_test.h"
+
+#define ROUNDS 200000 /**< 主循环步数 */
+
+/** @brief 执行上下文，数值越大优先级越高 */
+enum { CTX_UI = 0, CTX_CONTROL, CTX_ISR, CTX_NUM };
+
+/** @brief 事件来源 */
+enum { SRC_UI = 0, SRC_ISR, SRC_NUM };
+
+static uint32_t Now;              /**< 模拟毫秒时钟 */
+static uint8_t Context = CTX_UI;  /**< 当前上下文 */
+static uint8_t Preempt_On;        /**< 是否在抢占点插入其他上下文 */
+static uint32_t Preempt_Count;    /**< 实际发生的抢占次数 */
+static uint32_t Rand_State = 1;   /**< 伪随机数状态 */
+static uint32_t Sem_Gives;        /**< 信号量释放次数 */
+
+static uint32_t Produced[SRC_NUM];  /**< 各来源投递的事件数（即下一个序号） */
+static uint32_t Consumed[SRC_NUM];  /**< 各来源读出的事件数 */
+static uint32_t Next_Seq[SRC_NUM];  /**< 各来源读出的下一个序号的下限 */
+static uint32_t Last_Time[SRC_NUM]; /**< 各来源最近读出的事件时刻 */
+
+/* ---------------- 桩函数 ---------------- */
+
+uint32_t Timer_GetMillis(void)
+{
+    Host_Preempt(); // 填写事件之前也可能被抢占
+    return Now;
+}
+
+void Os_SemGive(OsSem_t *Sem) { Sem_Gives++; }
+
+/* ---------------- 生产者与消费者 ---------------- */
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+/** @brief 投递一个带序号的事件 */
+static void Produce(uint8_t Src)
+{
+    uint32_t seq = Produced[Src]++;
+    uint8_t data[4];
+
+    memcpy(data, &seq, sizeof(data));
+    if (Src == SRC_ISR) {
+        Event_PostFromISR(EVENT_PIR, data, sizeof(data));
+    } else {
+        Event_Post(EVENT_KEY, data, sizeof(data));
+    }
+}
+
+/** @brief 检查读出的事件 */
+static void Consume(const Event_t *Event)
+{
+    uint8_t src = Event->Type == EVENT_PIR ? SRC_ISR : SRC_UI;
+    uint32_t seq;
+
+    CHECK(Event->Type == EVENT_PIR || Event->Type == EVENT_KEY, "bad type %u", Event->Type);
+    memcpy(&seq, Event->Data, sizeof(seq));
+    CHECK(seq >= Next_Seq[src] && seq < Produced[src], "source %u: seq %lu, expected >= %lu", src,
+          (unsigned long)seq, (unsigned long)Next_Seq[src]);
+    CHECK(Event->Time >= Last_Time[src] && Event->Time <= Now, "source %u: time %lu out of order", src,
+          (unsigned long)Event->Time);
+    Next_Seq[src]  = seq + 1;
+    Last_Time[src] = Event->Time;
+    Consumed[src]++;
+}
+
+/** @brief 中断：投递1~3个事件 */
+static void Run_Isr(void)
+{
+    uint8_t saved = Context;
+    uint32_t n    = 1 + Rand() % 3;
+
+    Context = CTX_ISR;
+    while (n--) Produce(SRC_ISR);
+    Context = saved;
+}
+
+/** @brief 控制线程：读出最多Max个事件 */
+static void Run_Consumer(uint32_t Max)
+{
+    uint8_t saved = Context;
+    Event_t event;
+
+    Context = CTX_CONTROL;
+    while (Max-- && Event_Get(&event)) Consume(&event);
+    Context = saved;
+}
+
+/**
+ * @brief  模拟抢占点
+ * @details 中断可以抢占任何线程，控制线程只能抢占界面线程
+ */
+void Host_Preempt(void)
+{
+    if (!Preempt_On) return;
+    if (Context < CTX_ISR && Rand() % 8 == 0) {
+        Preempt_Count++;
+        Run_Isr();
+    }
+    if (Context < CTX_CONTROL && Rand() % 8 == 0) {
+        Preempt_Count++;
+        Run_Consumer(1 + Rand() % 4);
+    }
+}
+
+/* ---------------- 测试 ---------------- */
+
+/** @brief 投递指定时刻的事件 */
+static void Post_At(uint32_t Time, uint8_t Src)
+{
+    Now = Time;
+    Produce(Src);
+}
+
+/** @brief 读出一个事件，检查来源和时刻 */
+static void Expect_Next(uint8_t Src, uint32_t Time)
+{
+    Event_t event;
+
+    CHECK(Event_Get(&event), "queue empty, expected source %u at %lu", Src, (unsigned long)Time);
+    CHECK((event.Type == EVENT_PIR ? SRC_ISR : SRC_UI) == Src && event.Time == Time,
+          "got type %u at %lu, expected source %u at %lu", event.Type, (unsigned long)event.Time, Src,
+          (unsigned long)Time);
+    Consume(&event);
+}
+
+int main(void)
+{
+    Event_t event;
+    uint32_t i, dropped;
+
+    // 按产生时刻合并两个队列，时刻相同时中断事件优先
+    Post_At(10, SRC_UI);
+    Post_At(15, SRC_ISR);
+    Post_At(20, SRC_UI);
+    Post_At(20, SRC_ISR);
+    Post_At(25, SRC_ISR);
+    Expect_Next(SRC_UI, 10);
+    Expect_Next(SRC_ISR, 15);
+    Expect_Next(SRC_ISR, 20);
+    Expect_Next(SRC_UI, 20);
+    Expect_Next(SRC_ISR, 25);
+    CHECK(!Event_Get(&event), "queue not empty");
+
+    // 队列满时丢弃并计数，只有成功投递才释放信号量
+    Sem_Gives = 0;
+    for (i = 0; i < EVENT_QUEUE_SIZE + 3; i++) Produce(SRC_ISR);
+    CHECK(Event_GetDropped() == 3 && Sem_Gives == EVENT_QUEUE_SIZE, "dropped %lu, gives %lu",
+          (unsigned long)Event_GetDropped(), (unsigned long)Sem_Gives);
+    while (Event_Get(&event)) Consume(&event);
+
+    // 随机交错
+    Preempt_On = 1;
+    for (i = 0; i < ROUNDS; i++) {
+        Now += Rand() % 2;
+        switch (Rand() % 4) {
+        case 0:
+        case 1:
+            Produce(SRC_UI);
+            break;
+        case 2:
+            Run_Isr();
+            break;
+        default:
+            Run_Consumer(1 + Rand() % 8);
+            break;
+        }
+    }
+    Preempt_On = 0;
+    while (Event_Get(&event)) Consume(&event);
+
+    dropped = Event_GetDropped();
+    printf("produced %lu+%lu, dropped %lu, preemptions %lu\n", (unsigned long)Produced[SRC_UI],
+           (unsigned long)Produced[SRC_ISR], (unsigned long)dropped, (unsigned long)Preempt_Count);
+    CHECK(Consumed[SRC_UI] + Consumed[SRC_ISR] + dropped == Produced[SRC_UI] + Produced[SRC_ISR],
+          "consumed %lu + dropped %lu != produced", (unsigned long)(Consumed[SRC_UI] + Consumed[SRC_ISR]),
+          (unsigned long)dropped);
+    CHECK(dropped > 3 && Preempt_Count > ROUNDS / 8, "stress did not fill the queues or preempt");
+
+    return TEST_END("event");
+}
@@ -0,0 +1,130 @@
+/**
+ * @file     test_oled.c
+ * @brief    OLED显存刷新主机测试（软件I2C）
+ * @details  GPIO_WriteBit由SSD1306屏幕模型代替（见host/ssd1306.h）：
+ *          - 每次刷新后屏幕模型的显存必须与按字库直接绘制的结果一致
+ *          - 以OLED_GetBusBytes和解码器各自统计总线字节，比较刷新前后的开销，
+ *            并与逐字符写入（6次光标命令+16次单字节数据传输）的开销对照
+ *          - 超出屏幕的行列不写入显存，也不越界（配合AddressSanitizer）
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_test.h"
+#include "ssd1306.h"
+
+extern const uint8_t OLED_F8x16[][16];
+void OLED_I2C_Init(void);
+
+void GPIO_Init(GPIO_TypeDef *GPIOx, GPIO_InitTypeDef *GPIO_InitStruct) {}
+void RCC_APB2PeriphClockCmd(uint32_t RCC_APB2Periph, FunctionalState NewState) {}
+
+/* ---------------- 参考绘制 ---------------- */
+
+static uint8_t Expect[OLED_PAGE_NUM][OLED_WIDTH]; /**< 按字库直接绘制的期望显存 */
+
+static void Expect_String(uint8_t Line, uint8_t Column, const char *String)
+{
+    for (; *String && Column <= 16; String++, Column++) {
+        memcpy(&Expect[(Line - 1) * 2][(Column - 1) * 8], &OLED_F8x16[*String - ' '][0], 8);
+        memcpy(&Expect[(Line - 1) * 2 + 1][(Column - 1) * 8], &OLED_F8x16[*String - ' '][8], 8);
+    }
+}
+
+/**
+ * @brief  刷新并返回本次总线字节数，检查屏幕与期望一致
+ */
+static uint32_t Flush(void)
+{
+    uint32_t before = OLED_GetBusBytes();
+    uint32_t decoded = Ssd1306_Bytes;
+
+    OLED_Update();
+    CHECK(OLED_GetBusBytes() - before == Ssd1306_Bytes - decoded, "byte counters disagree");
+    CHECK(OLED_GetDirtyPages() == 0, "dirty pages left");
+    CHECK(memcmp(Ssd1306_Gram, Expect, sizeof(Ssd1306_Gram)) == 0, "screen differs from expected drawing");
+    return OLED_GetBusBytes() - before;
+}
+
+int main(void)
+{
+    uint32_t bytes, naive;
+    char line[17];
+
+    setvbuf(stdout, 0, _IONBF, 0);
+    memset(Ssd1306_Gram, 0x55, sizeof(Ssd1306_Gram)); // 上电时屏幕内容未知
+    OLED_I2C_Init();
+
+    // 清屏：每页一次光标命令(2+3)和一次整页数据(2+128)
+    OLED_Clear();
+    bytes = Flush();
+    CHECK(bytes == 8 * (5 + 130), "clear %lu bytes", (unsigned long)bytes);
+
+    // 四行状态界面
+    Expect_String(1, 1, "Temp:25.0C H:60%");
+    Expect_String(2, 1, "UV:03 PIR:1 BT:0");
+    Expect_String(3, 1, "Mode:AUTO  K:16 ");
+    Expect_String(4, 1, "Fan:ON  UV:OFF  ");
+    OLED_ShowString(1, 1, "Temp:25.0C H:60%");
+    OLED_ShowString(2, 1, "UV:03 PIR:1 BT:0");
+    OLED_ShowString(3, 1, "Mode:AUTO  K:16 ");
+    OLED_ShowString(4, 1, "Fan:ON  UV:OFF  ");
+    bytes = Flush();
+    naive = 64 * (6 * 3 + 16 * 3);
+    printf("full redraw: %lu bytes (per-char writes: %lu)\n", (unsigned long)bytes, (unsigned long)naive);
+    CHECK(bytes <= 8 * (5 + 130) && bytes * 3 < naive, "full redraw %lu bytes", (unsigned long)bytes);
+
+    // 相同内容重绘不产生传输
+    OLED_ShowString(1, 1, "Temp:25.0C H:60%");
+    OLED_ShowNum(3, 14, 16, 2);
+    bytes = Flush();
+    CHECK(bytes == 0, "unchanged redraw %lu bytes", (unsigned long)bytes);
+
+    // 一个字符变化：两页，每页光标(5) + 数据(2) + 不超过8列
+    Expect_String(1, 7, "6");
+    OLED_ShowFixedNum(1, 6, 26, 0, 2);
+    bytes = Flush();
+    printf("one digit: %lu bytes (per-char write: %lu)\n", (unsigned long)bytes, (unsigned long)(6 * 3 + 16 * 3));
+    CHECK(bytes > 0 && bytes <= 2 * (5 + 2 + 8), "one digit %lu bytes", (unsigned long)bytes);
+
+    // 分段刷新与一次刷新结果相同
+    Expect_String(2, 1, "0123456789ABCDEF");
+    OLED_ShowString(2, 1, "0123456789ABCDEF");
+    while (OLED_UpdateStep());
+    CHECK(memcmp(Ssd1306_Gram, Expect, sizeof(Ssd1306_Gram)) == 0, "chunked flush differs");
+
+    // 超出第16列的字符被截掉，不写到下一页
+    strcpy(line, "ABCDEFGHIJKLMNOP");
+    Expect_String(3, 10, line);
+    OLED_ShowString(3, 10, line);
+    Expect_String(4, 16, "XYZ");
+    OLED_ShowString(4, 16, "XYZ"); // 最后一页的最后一列，越界时会写出数组
+    OLED_ShowNum(4, 15, 12345, 5);
+    Expect_String(4, 15, "12");
+    Flush();
+
+    // 超出屏幕的行列、页和列被忽略
+    OLED_ShowChar(0, 1, 'A');
+    OLED_ShowChar(5, 1, 'A');
+    OLED_ShowChar(1, 17, 'A');
+    OLED_ShowString(1, 0, "A");
+    OLED_ShowString(9, 1, "A");
+    OLED_DrawColumn(8, 0, 0xFF);
+    OLED_DrawColumn(0, 128, 0xFF);
+    OLED_DrawColumn(0, 255, 0xFF);
+    bytes = Flush();
+    CHECK(bytes == 0, "out-of-range writes produced %lu bytes", (unsigned long)bytes);
+
+    // 右边界的单列
+    Expect[7][127] = 0x81;
+    OLED_DrawColumn(7, 127, 0x81);
+    bytes = Flush();
+    CHECK(bytes == 5 + 3, "last column %lu bytes", (unsigned long)bytes);
+
+    CHECK(Ssd1306_BadAddress == 0, "wrong slave address");
+    return TEST_END("oled");
+}
@@ -0,0 +1,554 @@
+/**
+ * @file     test_os.c
+ * @brief    内核调度主机测试
+ * @details  Os.c不做改动，以host_os.h代替SysTick、SCB、PRIMASK和NVIC，在主机上模拟运行：
+ *          - 每个线程对应一个ucontext，入口取自Os_ThreadCreate构造的异常帧中的PC；
+ *            PendSV挂起且中断打开时在Host_PendSV中切换，检查切换到的是优先级最高的就绪线程
+ *          - 时间只在线程“工作”（Work）和空闲钩子中推进，期间按时刻触发SysTick和模拟中断
+ *          - 每次设置定时后检查到期时刻为最早唤醒所在的毫秒边界，最多OS_ALARM_MAX_MS
+ *          场景：中断随机释放信号量，高优先级线程带超时等待；中优先级线程10ms周期运行，
+ *          中途有一次超时运行；生产者和消费者经4条的队列传递序号；低优先级线程持调度锁工作。
+ *          顺序锁：中断和高优先级线程各发布一对整数/小数（与GetControlState、Sensor_GetDht11相同的
+ *          读法），低优先级线程读取时在两个字段之间工作一段时间，被写入者抢占后必须重读，
+ *          读到的两个字段必须属于同一次写入。
+ *          最后各线程停止，只留一个长休眠，检查定时分段
+ * @note   线程入口按32位存入异常帧，测试链接为非PIE，函数地址在低4GB
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include <ucontext.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_test.h"
+
+extern OsThread_t *volatile Os_Next;
+void SysTick_Handler(void);
+
+#define RUN_US      (60ull * 1000 * 1000)  /**< 场景运行时间 */
+#define QUIET_MS    2500                   /**< 停止后的长休眠，超过OS_ALARM_MAX_MS */
+#define END_US      (RUN_US + 3000 * 1000) /**< 测试结束时刻 */
+#define MID_PERIOD  10                     /**< 中优先级线程周期（毫秒） */
+#define MID_OVERRUN 100                    /**< 第几次运行超时 */
+#define LOCK_US     1500                   /**< 调度锁持有时间 */
+#define STACK_WORDS 128                    /**< 线程栈（字），只存放初始异常帧 */
+#define NEVER       (~0ull)
+
+/* ---------------- 时间与中断 ---------------- */
+
+static uint64_t Now_Us;           /**< 模拟时间（微秒） */
+static uint64_t Alarm_At = NEVER; /**< SysTick到期时刻 */
+static uint8_t In_Isr;            /**< 正在执行中断 */
+static uint32_t Rand_State = 1;   /**< 伪随机数状态 */
+
+typedef void (*Isr_t)(void);
+static struct {
+    uint64_t At;
+    Isr_t Fn;
+} Irqs[8];           /**< 已安排的模拟中断 */
+static int Irq_Num;  /**< 已安排的模拟中断数 */
+
+static uint32_t Alarm_Arms, Alarm_Capped; /**< 设置定时次数、其中被限制到OS_ALARM_MAX_MS的次数 */
+
+uint32_t Timer_GetMicros(void) { return (uint32_t)Now_Us; }
+uint32_t Timer_GetMillis(void) { return (uint32_t)(Now_Us / 1000); }
+uint32_t Timer_GetMillisFrac(uint16_t *Us)
+{
+    *Us = (uint16_t)(Now_Us % 1000);
+    return (uint32_t)(Now_Us / 1000);
+}
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+static void Raise_At(uint64_t At, Isr_t Fn)
+{
+    Irqs[Irq_Num].At = At;
+    Irqs[Irq_Num].Fn = Fn;
+    Irq_Num++;
+}
+
+/**
+ * @brief  读取新设置的定时
+ * @details Os_SetAlarm总是写VAL=0，这里据此识别新的定时并标记VAL=1；
+ *         按线程表计算期望的到期时刻：最早唤醒的毫秒边界，最多OS_ALARM_MAX_MS，已到期的1us后
+ */
+static void Alarm_Sync(void)
+{
+    uint32_t now = (uint32_t)(Now_Us / 1000);
+    int32_t left, min = OS_ALARM_MAX_MS;
+    uint64_t expect;
+    uint8_t found = 0, i;
+    const OsThread_t *t;
+
+    for (i = 0; i < Os_GetThreadNum(); i++) {
+        t = Os_GetThread(i);
+        if (t->State != OS_READY && t->Timed) {
+            left = (int32_t)(t->WakeTime - now);
+            if (left < min) min = left;
+            found = 1;
+        }
+    }
+
+    if (!(Host_SysTick.CTRL & SysTick_CTRL_ENABLE_Msk)) {
+        CHECK(!found, "timed wait without alarm at %llu us", (unsigned long long)Now_Us);
+        Alarm_At = NEVER;
+        return;
+    }
+    if (Host_SysTick.VAL != 0) return;
+
+    Host_SysTick.VAL = 1;
+    Alarm_At = Now_Us + (Host_SysTick.LOAD + 1) / (SystemCoreClock / 8000000);
+    Alarm_Arms++;
+    if (!found) return; // 等待已被释放，多余的定时到期后关闭
+
+    expect = min > 0 ? ((uint64_t)now + min) * 1000 : Now_Us + 1;
+    CHECK(Alarm_At == expect, "alarm at %llu us, expected %llu us", (unsigned long long)Alarm_At,
+          (unsigned long long)expect);
+    if (min == OS_ALARM_MAX_MS) Alarm_Capped++;
+}
+
+/* ---------------- 线程切换 ---------------- */
+
+static struct {
+    OsThread_t *Thread;
+    ucontext_t Ctx;
+    char Stack[65536];
+} Ctxs[OS_MAX_THREADS + 1];      /**< 各线程的主机上下文 */
+static int Ctx_Num;              /**< 已建立的上下文数 */
+static ucontext_t Main_Ctx;      /**< main的上下文，测试结束时返回 */
+static ucontext_t Boot_Ctx;      /**< Os_Start的上下文，第一次切换后不再使用 */
+static volatile uint8_t Finished; /**< 测试结束 */
+static uint32_t Switch_Count;    /**< 切换次数 */
+
+/**
+ * @brief  线程的主机上下文，第一次切换到该线程时建立
+ */
+static ucontext_t *Ctx_Of(OsThread_t *Thread)
+{
+    int i;
+
+    for (i = 0; i < Ctx_Num; i++) {
+        if (Ctxs[i].Thread == Thread) return &Ctxs[i].Ctx;
+    }
+    Ctxs[i].Thread = Thread;
+    Ctx_Num++;
+    getcontext(&Ctxs[i].Ctx);
+    Ctxs[i].Ctx.uc_stack.ss_sp   = Ctxs[i].Stack;
+    Ctxs[i].Ctx.uc_stack.ss_size = sizeof(Ctxs[i].Stack);
+    Ctxs[i].Ctx.uc_link          = 0;
+    makecontext(&Ctxs[i].Ctx, (void (*)(void))(uintptr_t)Thread->Sp[14], 0); // 异常帧中的PC
+    return &Ctxs[i].Ctx;
+}
+
+/**
+ * @brief  模拟PendSV
+ * @details 每次退出临界区时调用：先检查新设置的定时；PendSV挂起、不在中断中且中断打开时切换，
+ *         切换到的线程必须是线程表中第一个就绪线程
+ */
+void Host_PendSV(void)
+{
+    OsThread_t *prev    = Os_Current;
+    const OsThread_t *t = 0;
+    uint8_t i;
+
+    Alarm_Sync();
+    if (In_Isr || Host_Primask || !(Host_Scb.ICSR & SCB_ICSR_PENDSVSET_Msk)) return;
+    Host_Scb.ICSR = 0;
+
+    for (i = 0; i < Os_GetThreadNum() && !t; i++) {
+        if (Os_GetThread(i)->State == OS_READY) t = Os_GetThread(i);
+    }
+    CHECK(t == Os_Next, "switch to %s (prio %u), first ready is %s", Os_Next->Name, Os_Next->Priority,
+          t ? t->Name : "none");
+
+    Os_Current = Os_Next;
+    if (prev == Os_Current) return;
+    Switch_Count++;
+    swapcontext(prev ? Ctx_Of(prev) : &Boot_Ctx, Ctx_Of(Os_Current));
+}
+
+/**
+ * @brief  结束模拟，回到main
+ */
+static void Finish(void)
+{
+    Finished     = 1;
+    Host_Primask = 1;
+    setcontext(&Main_Ctx);
+}
+
+/**
+ * @brief  下一个到期的中断
+ * @param  Which 输出：模拟中断序号，-1为SysTick
+ */
+static uint64_t Next_Event(int *Which)
+{
+    uint64_t t = Alarm_At;
+    int i;
+
+    *Which = -1;
+    for (i = 0; i < Irq_Num; i++) {
+        if (Irqs[i].At < t) {
+            t      = Irqs[i].At;
+            *Which = i;
+        }
+    }
+    return t;
+}
+
+/**
+ * @brief  执行一个中断，结束后处理挂起的PendSV
+ */
+static void Fire(int Which)
+{
+    Isr_t fn;
+
+    In_Isr = 1;
+    if (Which < 0) {
+        Alarm_At = NEVER;
+        SysTick_Handler();
+    } else {
+        fn           = Irqs[Which].Fn;
+        Irqs[Which] = Irqs[--Irq_Num];
+        fn();
+    }
+    In_Isr = 0;
+    if (Now_Us >= END_US || Test_Fails > 20) Finish(); // 失败过多时提前结束
+    Host_PendSV();
+}
+
+/**
+ * @brief  线程工作Us微秒，期间可被中断和更高优先级的线程抢占
+ */
+static void Work(uint64_t Us)
+{
+    uint64_t t;
+    int which;
+
+    while (Us) {
+        t = Next_Event(&which);
+        if (t > Now_Us + Us) {
+            Now_Us += Us;
+            return;
+        }
+        Us -= t - Now_Us;
+        Now_Us = t;
+        Fire(which);
+    }
+}
+
+/**
+ * @brief  空闲钩子：相当于关中断后WFI，时间直接推进到下一个中断
+ */
+static uint32_t Idle_Calls, Idle_Spins; /**< 空闲次数、连续空转次数 */
+static void Idle_Hook(void)
+{
+    uint64_t t;
+    int which;
+
+    __disable_irq();
+    if (Os_GetIdleTime() == 0) {
+        __enable_irq();
+        if (++Idle_Spins > 1000) {
+            CHECK(0, "idle thread keeps running while a thread is ready at %llu us", (unsigned long long)Now_Us);
+            Finish();
+        }
+        return;
+    }
+    Idle_Spins = 0;
+    Idle_Calls++;
+    t = Next_Event(&which);
+    if (t == NEVER) {
+        CHECK(0, "deadlock at %llu us", (unsigned long long)Now_Us);
+        Finish();
+    }
+    Now_Us       = t;
+    Host_Primask = 0;
+    Fire(which);
+}
+
+/* ---------------- 场景 ---------------- */
+
+static OsThread_t Threads[OS_MAX_THREADS];
+static uint32_t Stacks[OS_MAX_THREADS][STACK_WORDS];
+enum { TH_HI = 0, TH_MID, TH_CONS, TH_LO, TH_PROD };
+
+static OsSem_t Sem;         /**< 中断释放的信号量 */
+static OsSem_t Park;        /**< 停止后线程在此永久等待 */
+static OsQueue_t Queue;     /**< 生产者到消费者 */
+static uint32_t Queue_Buf[4];
+static const char *First_Run; /**< 第一个运行的线程 */
+
+static uint64_t Give_At;                       /**< 最近一次释放的时刻 */
+static uint32_t Gives, Hi_Got, Hi_Timeouts;    /**< 释放、得到、超时次数 */
+static uint32_t Hi_Max_Latency;                /**< 释放到得到的最大延迟（微秒） */
+static uint32_t Mid_Runs, Mid_Max_Late;        /**< 周期运行次数、最大延迟（微秒） */
+static uint32_t Mid_Missed;                    /**< Os_SleepUntil返回的跳过周期数 */
+static uint32_t Lo_Runs, Sent, Received, Send_Blocked;
+static uint8_t Lock_Active;                    /**< 低优先级线程持有调度锁 */
+static uint64_t Lock_End;                      /**< 最近一次释放调度锁的时刻 */
+
+static uint8_t Quiet(void)
+{
+    return Now_Us >= RUN_US;
+}
+
+static void Record_First(const char *Name)
+{
+    if (!First_Run) First_Run = Name;
+}
+
+/** @brief 中断：释放信号量，下一次间隔3~43ms */
+static void Isr_Give(void)
+{
+    Give_At = Now_Us;
+    Gives++;
+    Os_SemGive(&Sem);
+    if (!Quiet()) Raise_At(Now_Us + 3000 + Rand() % 40000, Isr_Give);
+}
+
+static void Isr_End(void) {}
+
+/**
+ * @brief 顺序锁保护的一对字段，小数部分总是整数部分的个位
+ */
+typedef struct {
+    OsSeq_t Seq;
+    volatile uint32_t Int;
+    volatile uint8_t Deci;
+    uint32_t Reads, Retries, Torn; /**< 读取、重读、读到不一致的次数 */
+} Pair_t;
+
+static Pair_t Isr_Pair; /**< 中断发布 */
+static Pair_t Ctl_Pair; /**< 高优先级线程发布，相当于控制状态快照 */
+
+/** @brief 写入一对字段，Us为两个字段之间的工作时间 */
+static void Write_Pair(Pair_t *Pair, uint64_t Us)
+{
+    uint32_t v = Pair->Int + 1;
+
+    Os_SeqWriteBegin(&Pair->Seq);
+    Pair->Int = v;
+    if (Us) Work(Us);
+    Pair->Deci = v % 10;
+    Os_SeqWriteEnd(&Pair->Seq);
+}
+
+/** @brief 读取一对字段，两个字段之间工作Us微秒，期间可能被写入者抢占 */
+static void Read_Pair(Pair_t *Pair, uint64_t Us)
+{
+    uint32_t start, v;
+    uint8_t d;
+
+    Pair->Retries--;
+    do {
+        start = Os_SeqReadBegin(&Pair->Seq);
+        v     = Pair->Int;
+        Work(Us);
+        d = Pair->Deci;
+        Pair->Retries++;
+    } while (Os_SeqReadRetry(&Pair->Seq, start));
+    Pair->Reads++;
+    if (d != v % 10) Pair->Torn++;
+}
+
+/** @brief 中断：发布一对字段，下一次间隔200~1000us */
+static void Isr_Write(void)
+{
+    Write_Pair(&Isr_Pair, 0);
+    if (!Quiet()) Raise_At(Now_Us + 200 + Rand() % 800, Isr_Write);
+}
+
+/** @brief 优先级0：带30ms超时等待中断 */
+static void Thread_Hi(void)
+{
+    uint32_t start, latency;
+
+    Record_First("hi");
+    while (!Quiet()) {
+        start = Timer_GetMillis();
+        if (Os_SemTake(&Sem, 30)) {
+            Hi_Got++;
+            latency = (uint32_t)(Now_Us - Give_At);
+            if (latency > Hi_Max_Latency) Hi_Max_Latency = latency;
+            CHECK(latency == 0 || Lock_Active || Now_Us <= Lock_End, "latency %lu us without a lock",
+                  (unsigned long)latency);
+            Work(200);
+            Write_Pair(&Ctl_Pair, 30);
+        } else {
+            Hi_Timeouts++;
+            // 超时在第30ms边界唤醒，只有调度锁会推迟到释放时
+            CHECK(Timer_GetMillis() == start + 30 || (Now_Us == Lock_End && Timer_GetMillis() <= start + 31),
+                  "timed out at %lu, expected %lu", (unsigned long)Timer_GetMillis(), (unsigned long)(start + 30));
+        }
+    }
+    Os_SemTake(&Park, OS_WAIT_FOREVER);
+}
+
+/** @brief 优先级1：10ms周期，第MID_OVERRUN次运行超过两个周期 */
+static void Thread_Mid(void)
+{
+    uint32_t wake = Timer_GetMillis(), phase = wake % MID_PERIOD;
+    uint32_t late, missed;
+
+    Record_First("mid");
+    while (!Quiet()) {
+        Mid_Runs++;
+        late = (uint32_t)(Now_Us - (uint64_t)wake * 1000);
+        CHECK(Now_Us >= (uint64_t)wake * 1000 && wake % MID_PERIOD == phase, "woke at %llu us for %lu ms",
+              (unsigned long long)Now_Us, (unsigned long)wake);
+        if (late > Mid_Max_Late) Mid_Max_Late = late;
+        Work(Mid_Runs == MID_OVERRUN ? 22000 : 2000);
+        Read_Pair(&Isr_Pair, 20);
+        missed = Os_SleepUntil(&wake, MID_PERIOD);
+        CHECK(missed == (Mid_Runs == MID_OVERRUN ? 2 : 0), "run %lu missed %lu periods", (unsigned long)Mid_Runs,
+              (unsigned long)missed);
+        Mid_Missed += missed;
+    }
+    Os_Sleep(QUIET_MS);
+    Os_SemTake(&Park, OS_WAIT_FOREVER);
+}
+
+/** @brief 优先级2：接收并检查顺序，每8条休眠20ms让队列填满 */
+static void Thread_Cons(void)
+{
+    uint32_t v, expect = 0;
+
+    Record_First("cons");
+    while (!Quiet()) {
+        if (Os_QueueReceive(&Queue, &v, 100)) {
+            CHECK(v == expect, "received %lu, expected %lu", (unsigned long)v, (unsigned long)expect);
+            expect = v + 1;
+            Received++;
+            if (Received % 8 == 0) Os_Sleep(20);
+        }
+    }
+    Os_SemTake(&Park, OS_WAIT_FOREVER);
+}
+
+/** @brief 优先级3：50ms周期，中间持调度锁工作 */
+static void Thread_Lo(void)
+{
+    uint32_t wake = Timer_GetMillis();
+
+    Record_First("lo");
+    while (!Quiet()) {
+        Lo_Runs++;
+        Work(5000 + Rand() % 10000);
+        Os_SchedLock();
+        Lock_Active = 1;
+        Work(LOCK_US);
+        Lock_Active = 0;
+        Lock_End    = Now_Us;
+        Os_SchedUnlock();
+        Work(10000);
+        Os_SleepUntil(&wake, 50);
+    }
+    Os_SemTake(&Park, OS_WAIT_FOREVER);
+}
+
+/** @brief 优先级4：不断发送序号，队列满时必须阻塞到消费者取走一条 */
+static void Thread_Prod(void)
+{
+    uint32_t v = 0, before;
+    uint8_t full;
+
+    Record_First("prod");
+    while (1) {
+        full   = Queue.Spaces.Count == 0;
+        before = Received;
+        if (Os_QueueSend(&Queue, &v, OS_WAIT_FOREVER)) {
+            v++;
+            Sent++;
+        }
+        if (full) {
+            Send_Blocked++;
+            CHECK(Received > before, "send to a full queue returned without a receive");
+        }
+        Work(100);
+        if (v % 16 == 0) {
+            Read_Pair(&Isr_Pair, 300);
+            Read_Pair(&Ctl_Pair, 2000);
+        }
+    }
+}
+
+int main(void)
+{
+    const OsThread_t *t;
+    int i;
+
+    Os_SemInit(&Sem, 0, 1);
+    Os_SemInit(&Park, 0, 1);
+    Os_QueueInit(&Queue, Queue_Buf, sizeof(uint32_t), 4);
+
+    // 创建顺序与优先级不同，线程表按优先级排列
+    CHECK(Os_ThreadCreate(&Threads[TH_LO], "lo", Thread_Lo, Stacks[TH_LO], STACK_WORDS, 3), "create");
+    CHECK(Os_ThreadCreate(&Threads[TH_MID], "mid", Thread_Mid, Stacks[TH_MID], STACK_WORDS, 1), "create");
+    CHECK(Os_ThreadCreate(&Threads[TH_PROD], "prod", Thread_Prod, Stacks[TH_PROD], STACK_WORDS, 4), "create");
+    CHECK(Os_ThreadCreate(&Threads[TH_HI], "hi", Thread_Hi, Stacks[TH_HI], STACK_WORDS, 0), "create");
+    CHECK(Os_ThreadCreate(&Threads[TH_CONS], "cons", Thread_Cons, Stacks[TH_CONS], STACK_WORDS, 2), "create");
+    CHECK(!Os_ThreadCreate(&Threads[TH_CONS], "x", Thread_Cons, Stacks[TH_CONS], STACK_WORDS, 2), "thread limit");
+
+    Raise_At(5000, Isr_Give);
+    Raise_At(1000, Isr_Write);
+    Raise_At(END_US, Isr_End);
+    getcontext(&Main_Ctx);
+    if (!Finished) Os_Start(Idle_Hook);
+
+    for (i = 0; i < Os_GetThreadNum(); i++) {
+        t = Os_GetThread(i);
+        printf("%-5s prio=%3u switches=%7lu overruns=%lu\n", t->Name, t->Priority, (unsigned long)t->Switches,
+               (unsigned long)t->Overruns);
+        CHECK(i == 0 || Os_GetThread(i - 1)->Priority <= t->Priority, "thread table not sorted");
+    }
+    printf("hi: gives %lu, got %lu, timeouts %lu, max latency %lu us\n", (unsigned long)Gives, (unsigned long)Hi_Got,
+           (unsigned long)Hi_Timeouts, (unsigned long)Hi_Max_Latency);
+    printf("mid: runs %lu, max late %lu us; lo: runs %lu; queue: sent %lu, received %lu, blocked %lu\n",
+           (unsigned long)Mid_Runs, (unsigned long)Mid_Max_Late, (unsigned long)Lo_Runs, (unsigned long)Sent,
+           (unsigned long)Received, (unsigned long)Send_Blocked);
+    printf("switches %lu, idle %lu, alarms %lu (capped %lu)\n", (unsigned long)Switch_Count, (unsigned long)Idle_Calls,
+           (unsigned long)Alarm_Arms, (unsigned long)Alarm_Capped);
+
+    // 优先级最高的线程先运行
+    CHECK(First_Run && strcmp(First_Run, "hi") == 0, "first thread %s", First_Run ? First_Run : "none");
+
+    // 周期运行不漂移：60s内每10ms一次，超时运行跳过2个周期并计入Overruns
+    CHECK(Mid_Runs + Mid_Missed >= 5999 && Mid_Runs + Mid_Missed <= 6001, "mid runs %lu + missed %lu",
+          (unsigned long)Mid_Runs, (unsigned long)Mid_Missed);
+    CHECK(Mid_Missed == 2 && Threads[TH_MID].Overruns == 2 && Threads[TH_LO].Overruns == 0, "overruns");
+    CHECK(Mid_Max_Late <= LOCK_US + 400, "mid late %lu us", (unsigned long)Mid_Max_Late);
+
+    // 信号量：中断释放后立即切换（调度锁除外），没有丢失；超时也会发生
+    CHECK(Gives - Hi_Got <= 1, "lost gives: %lu given, %lu taken", (unsigned long)Gives, (unsigned long)Hi_Got);
+    CHECK(Hi_Timeouts > 0 && Hi_Max_Latency <= LOCK_US, "hi");
+
+    // 队列：先进先出，满时发送阻塞
+    CHECK(Sent >= Received && Sent - Received <= 5 && Received > 1000, "queue sent %lu received %lu",
+          (unsigned long)Sent, (unsigned long)Received);
+    CHECK(Send_Blocked > 100, "producer blocked %lu times", (unsigned long)Send_Blocked);
+
+    // 定时：长休眠按OS_ALARM_MAX_MS分段
+    CHECK(Alarm_Capped >= 2, "alarm capped %lu times", (unsigned long)Alarm_Capped);
+
+    // 顺序锁：被中断或高优先级写入者抢占的读取重读，不会读到不一致的字段
+    printf("seqlock: isr %lu reads %lu retries, control %lu reads %lu retries\n", (unsigned long)Isr_Pair.Reads,
+           (unsigned long)Isr_Pair.Retries, (unsigned long)Ctl_Pair.Reads, (unsigned long)Ctl_Pair.Retries);
+    CHECK(Isr_Pair.Torn == 0 && Ctl_Pair.Torn == 0, "torn reads: isr %lu, control %lu", (unsigned long)Isr_Pair.Torn,
+          (unsigned long)Ctl_Pair.Torn);
+    CHECK(Isr_Pair.Retries > 100 && Ctl_Pair.Retries > 10 && Ctl_Pair.Reads > 500, "seqlock readers were not preempted");
+
+    // 栈统计：线程只在栈上放了初始异常帧
+    CHECK(Os_GetStackFree(&Threads[TH_HI]) >= STACK_WORDS - 18 && Os_GetStackFree(&Threads[TH_HI]) <= STACK_WORDS - 16,
+          "stack free %u", Os_GetStackFree(&Threads[TH_HI]));
+    Stacks[TH_HI][0] = 0;
+    CHECK(Os_GetStackFree(&Threads[TH_HI]) == 0, "stack overflow not detected");
+
+    return TEST_END("os");
+}
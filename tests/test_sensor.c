@@ -0,0 +1,398 @@
+/**
+ * @file     test_sensor.c
+ * @brief    传感器采样缓存主机测试
+ * @details  直接编译Sensor.c和Os.c（见host_os.h），内存屏障重新定义为模拟抢占点（Host_Preempt），
+ *          在屏障处插入写入者：
+ *          - 环形缓冲：空、未满、刚满、多次回绕时可读的序号范围和内容，过旧和尚未写入的序号
+ *          - Sensor_GetLatest复制完成后被写入者抢占：写入者覆盖了正在复制的位置时，
+ *            把副本的值改成新内容（相当于复制到一半被改写），读取必须重试，
+ *            返回的时刻和值必须属于同一个采样
+ *          - Sensor_GetDht11复制完成后被传感器线程抢占并写入新的读数：把副本的小数部分改成新读数的，
+ *            读取必须重试，返回的整数、小数部分和序号必须属于同一次读取
+ *          - DHT11_Read按脚本返回结果，按传感器线程的周期调用Sensor_Poll：检查读取时刻
+ *            （只有校验和、位宽度错误提前重试，间隔倍增）、OK/DEGRADED/FAULT转换和错误计数，
+ *            失败时序号、数据不变，年龄继续增长
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_preempt.h"
+#include "host_test.h"
+
+#define ROUNDS 100000 /**< 抢占压力测试的读取次数 */
+
+static uint32_t Now;            /**< 模拟毫秒时钟 */
+static uint32_t Rand_State = 1; /**< 伪随机数状态 */
+
+/* ---------------- 桩函数 ---------------- */
+
+uint32_t Timer_GetMillis(void) { return Now; }
+uint32_t Timer_GetMicros(void) { return Now * 1000; }
+uint32_t Timer_GetMillisFrac(uint16_t *Us)
+{
+    *Us = 0;
+    return Now;
+}
+void Host_PendSV(void) {}
+
+uint16_t SD12_GetADCValue(void) { return 0; }
+uint8_t SD12_GetIntensity(uint16_t adValue) { return 0; }
+
+static DHT11_Status_t Script[16]; /**< DHT11_Read依次返回的结果 */
+static uint8_t Script_Len, Script_Pos;
+static uint32_t Read_Times[16];   /**< DHT11_Read被调用的时刻 */
+static uint8_t Script_Done;       /**< 脚本已检查完，之后的读取都成功 */
+static uint32_t Good_Reads;       /**< 成功读取的次数 */
+
+/** @brief 第Seq次成功读取的温度，整数和小数部分都由序号推出 */
+static uint8_t Temp_Int_Of(uint32_t Seq) { return (uint8_t)(20 + Seq % 50); }
+static uint8_t Temp_Deci_Of(uint32_t Seq) { return (uint8_t)(Seq % 10); }
+
+DHT11_Status_t DHT11_Read(DHT11_Data_TypeDef *Data)
+{
+    DHT11_Status_t status;
+
+    if (Script_Done) {
+        status = DHT11_OK;
+    } else {
+        CHECK(Script_Pos < Script_Len, "unexpected read at %lu ms", (unsigned long)Now);
+        if (Script_Pos >= Script_Len) return DHT11_ERR_NO_RESPONSE;
+        Read_Times[Script_Pos] = Now;
+        status                 = Script[Script_Pos++];
+    }
+    if (status == DHT11_OK) { // 每次成功的数据不同：温度21.1、22.2……
+        Good_Reads++;
+        Data->humi_int  = 50;
+        Data->humi_deci = 0;
+        Data->temp_int  = Temp_Int_Of(Good_Reads);
+        Data->temp_deci = Temp_Deci_Of(Good_Reads);
+    }
+    return status;
+}
+
+/* ---------------- 环形缓冲 ---------------- */
+
+/** @brief 序号对应的采样，时刻和值可互相推出 */
+static uint32_t Time_Of(uint32_t Seq) { return 1000 + Seq * 10; }
+static int16_t Value_Of(uint32_t Seq) { return (int16_t)(Seq * 7 + 3); }
+static uint32_t Seq_Of(const SensorSample_t *Sample) { return (Sample->Time - 1000) / 10; }
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+/** @brief 写入通道的下一个采样 */
+static void Push(SensorChannel_t Channel)
+{
+    uint32_t seq = Sensor_GetHead(Channel);
+
+    Sensor_Push(Channel, Time_Of(seq), Value_Of(seq));
+}
+
+/**
+ * @brief  检查可读的序号范围和内容
+ * @details 计数为Head时，可读的是Head-(SENSOR_RING_LEN-1)~Head-1（不早于0），其余都返回0
+ */
+static void Expect_Ring(SensorChannel_t Channel, const char *Name)
+{
+    uint32_t head = Sensor_GetHead(Channel);
+    uint32_t first = head > SENSOR_RING_LEN - 1 ? head - (SENSOR_RING_LEN - 1) : 0;
+    const SensorSample_t *s;
+    SensorSample_t latest;
+    uint32_t seq;
+
+    for (seq = head - 3 * SENSOR_RING_LEN; seq != head + SENSOR_RING_LEN; seq++) {
+        s = Sensor_GetSample(Channel, seq);
+        if (seq >= first && seq < head) {
+            CHECK(s && s->Time == Time_Of(seq) && s->Value == Value_Of(seq), "%s: head %lu, seq %lu unreadable or wrong",
+                  Name, (unsigned long)head, (unsigned long)seq);
+        } else {
+            CHECK(s == 0, "%s: head %lu, seq %lu should be stale or unwritten", Name, (unsigned long)head,
+                  (unsigned long)seq);
+        }
+    }
+
+    if (head == 0) {
+        CHECK(!Sensor_GetLatest(Channel, &latest), "%s: latest of an empty ring", Name);
+    } else {
+        CHECK(Sensor_GetLatest(Channel, &latest) && latest.Time == Time_Of(head - 1) &&
+                  latest.Value == Value_Of(head - 1),
+              "%s: latest", Name);
+    }
+}
+
+/* ---------------- 抢占 ---------------- */
+
+static uint8_t In_Writer;             /**< 写入者正在运行，不再嵌套 */
+static SensorSample_t *Reader_Copy;   /**< 读取者的副本，不为0时在屏障处插入写入者 */
+static SensorSample_t Reader_Seen;    /**< 上一个屏障处副本的内容 */
+static uint32_t Preempts, Torn_Copies; /**< 插入次数、改写副本的次数 */
+static SensorDht11_t *Reader_Dht11;   /**< DHT11读取者的副本，不为0时在屏障处插入传感器线程 */
+static SensorDht11_t Reader_Dht11Seen; /**< 上一个屏障处副本的内容 */
+static uint32_t Dht11_Preempts, Dht11_Torn; /**< 插入次数、改写副本的次数 */
+
+/**
+ * @brief  在DHT11读取期间插入传感器线程
+ * @details 推进一个读取周期并调用Sensor_Poll，读取成功。副本是刚复制的，
+ *         把副本的温度小数部分改成新读数的，相当于复制到一半时缓存被更新
+ */
+static void Preempt_Dht11(void)
+{
+    uint8_t fresh = memcmp(Reader_Dht11, &Reader_Dht11Seen, sizeof(SensorDht11_t)) != 0;
+
+    Reader_Dht11Seen = *Reader_Dht11;
+    if (Rand() % 3) return;
+
+    In_Writer = 1;
+    Dht11_Preempts++;
+    Now += DHT11_PERIOD_MS;
+    Sensor_Poll();
+    if (fresh) {
+        Reader_Dht11->TempDeci = Temp_Deci_Of(Good_Reads);
+        Reader_Dht11Seen       = *Reader_Dht11;
+        Dht11_Torn++;
+    }
+    In_Writer = 0;
+}
+
+/**
+ * @brief  模拟抢占点
+ * @details 只在读取期间插入，随机写入0~2*SENSOR_RING_LEN个采样。副本与上一个屏障处不同，说明读取者刚复制完、
+ *         尚未检查，此时被复制的位置如已被覆盖，把副本的值改成该位置的新内容，时刻保持旧的
+ */
+void Host_Preempt(void)
+{
+    uint32_t copied, head, n;
+    uint8_t fresh;
+
+    if (In_Writer) return; // 每个通道只有一个写入者，写入者不被另一个写入者抢占
+    if (Reader_Dht11) {
+        Preempt_Dht11();
+        return;
+    }
+    if (!Reader_Copy) return;
+    fresh       = Reader_Copy->Time != Reader_Seen.Time || Reader_Copy->Value != Reader_Seen.Value;
+    Reader_Seen = *Reader_Copy;
+    if (Rand() % 4) return;
+
+    In_Writer = 1;
+    Preempts++;
+    n = Rand() % (2 * SENSOR_RING_LEN);
+    while (n--) Push(SENSOR_CH_PIR);
+
+    if (fresh) {
+        copied = Seq_Of(Reader_Copy);
+        head   = Sensor_GetHead(SENSOR_CH_PIR);
+        if (head - copied > SENSOR_RING_LEN) { // 复制的位置已写入copied+SENSOR_RING_LEN*k
+            copied += (head - 1 - copied) / SENSOR_RING_LEN * SENSOR_RING_LEN;
+            Reader_Copy->Value = Value_Of(copied);
+            Reader_Seen        = *Reader_Copy;
+            Torn_Copies++;
+        }
+    }
+    In_Writer = 0;
+}
+
+/** @brief 被抢占的读取：返回的采样必须完整，且不早于调用时的最新采样 */
+static void Read_Latest(void)
+{
+    SensorSample_t latest = {0xFFFFFFFF, 0};
+    uint32_t head         = Sensor_GetHead(SENSOR_CH_PIR);
+    uint32_t seq;
+
+    Reader_Seen = latest;
+    Reader_Copy = &latest;
+    CHECK(Sensor_GetLatest(SENSOR_CH_PIR, &latest), "latest");
+    Reader_Copy = 0;
+
+    seq = Seq_Of(&latest);
+    CHECK(latest.Value == Value_Of(seq), "torn sample: time of %lu, value %d", (unsigned long)seq, latest.Value);
+    CHECK(seq >= head - 1 && seq < Sensor_GetHead(SENSOR_CH_PIR), "latest seq %lu, head was %lu", (unsigned long)seq,
+          (unsigned long)head);
+}
+
+/* ---------------- DHT11重试与健康状态 ---------------- */
+
+/** @brief 按传感器线程的周期调用Sensor_Poll，直到指定时刻（含） */
+static void Poll_Until(uint32_t Time)
+{
+    while (Now <= Time) {
+        Sensor_Poll();
+        Now += UV_SAMPLE_MS;
+    }
+    Now -= UV_SAMPLE_MS;
+}
+
+/** @brief 检查缓存 */
+static void Expect_Dht11(const char *Name, SensorHealth_t Health, uint32_t Seq, uint8_t Fails, uint32_t Good_Time)
+{
+    SensorDht11_t d;
+
+    Sensor_GetDht11(&d);
+    CHECK(d.Health == Health && d.Seq == Seq && d.Fails == Fails, "%s: health %u seq %lu fails %u, expected %u %lu %u",
+          Name, d.Health, (unsigned long)d.Seq, d.Fails, Health, (unsigned long)Seq, Fails);
+    CHECK(d.Age == (Seq ? Now - Good_Time : 0), "%s: age %lu at %lu", Name, (unsigned long)d.Age, (unsigned long)Now);
+    if (Seq) {
+        CHECK(d.TempInt == Temp_Int_Of(Seq) && d.TempDeci == Temp_Deci_Of(Seq) && d.HumiInt == 50, "%s: data", Name);
+    }
+}
+
+/**
+ * @brief  重试与健康状态
+ * @details DHT11_PERIOD_MS为2000，首次重试间隔1000，第二次重试的间隔2000不短于周期，不进行
+ */
+static void Test_Dht11(void)
+{
+    static const DHT11_Status_t script[] = {
+        DHT11_OK,               // 1000
+        DHT11_ERR_CHECKSUM,     // 3000，1000后重试
+        DHT11_ERR_BIT,          // 4000，重试间隔已不短于周期，按周期
+        DHT11_ERR_NO_RESPONSE,  // 6000，第3次失败，故障
+        DHT11_ERR_TIMEOUT,      // 8000
+        DHT11_OK,               // 10000，恢复
+        DHT11_ERR_NO_RESPONSE,  // 12000，不重试
+        DHT11_ERR_CHECKSUM,     // 14000，重试计数已清零，1000后重试
+        DHT11_ERR_CHECKSUM,     // 15000
+        DHT11_ERR_TIMEOUT,      // 17000，不重试
+        DHT11_ERR_BIT,          // 19000，1000后重试
+        DHT11_OK,               // 20000，重试成功，按周期，重试计数清零
+        DHT11_ERR_CHECKSUM,     // 22000，1000后重试
+        DHT11_OK,               // 23000
+    };
+    static const uint32_t times[] = {1000,  3000,  4000,  6000,  8000,  10000, 12000,
+                                     14000, 15000, 17000, 19000, 20000, 22000, 23000};
+    SensorDht11_t d;
+    uint32_t temp_head = Sensor_GetHead(SENSOR_CH_TEMP);
+    uint8_t i;
+
+    memcpy(Script, script, sizeof(script));
+    Script_Len = sizeof(script) / sizeof(script[0]);
+    Now        = 0;
+
+    Poll_Until(DHT11_POWERUP_MS - 1);
+    CHECK(Script_Pos == 0, "read during power-up");
+    Expect_Dht11("power-up", SENSOR_HEALTH_INIT, 0, 0, 0);
+
+    Poll_Until(1000);
+    Expect_Dht11("first read", SENSOR_HEALTH_OK, 1, 0, 1000);
+    Sensor_GetDht11(&d);
+    CHECK(d.TempInt == 21 && d.TempDeci == 1 && d.Age == 0, "first read data");
+
+    Poll_Until(3000);
+    Expect_Dht11("checksum", SENSOR_HEALTH_DEGRADED, 1, 1, 1000);
+    Sensor_GetDht11(&d);
+    CHECK(d.TempDeci == 1 && d.LastError == DHT11_ERR_CHECKSUM, "failure kept the last good data");
+    Poll_Until(3999);
+    CHECK(Script_Pos == 2, "retry too early");
+    Poll_Until(4000);
+    Expect_Dht11("bit error on retry", SENSOR_HEALTH_DEGRADED, 1, 2, 1000);
+    Poll_Until(6000);
+    Expect_Dht11("no response", SENSOR_HEALTH_FAULT, 1, 3, 1000);
+    Poll_Until(8000);
+    Expect_Dht11("timeout", SENSOR_HEALTH_FAULT, 1, 4, 1000);
+    Poll_Until(10000);
+    Expect_Dht11("recovered", SENSOR_HEALTH_OK, 2, 0, 10000);
+    Poll_Until(12000);
+    Expect_Dht11("no response after recovery", SENSOR_HEALTH_DEGRADED, 2, 1, 10000);
+    Poll_Until(19000);
+    Expect_Dht11("retried failures", SENSOR_HEALTH_FAULT, 2, 5, 10000);
+    Poll_Until(20000);
+    Expect_Dht11("retry succeeded", SENSOR_HEALTH_OK, 3, 0, 20000);
+    Poll_Until(24999);
+    Expect_Dht11("end", SENSOR_HEALTH_OK, 4, 0, 23000);
+
+    CHECK(Script_Pos == Script_Len, "%u of %u reads", Script_Pos, Script_Len);
+    for (i = 0; i < Script_Pos; i++) {
+        CHECK(Read_Times[i] == times[i], "read %u at %lu ms, expected %lu", i, (unsigned long)Read_Times[i],
+              (unsigned long)times[i]);
+    }
+
+    Sensor_GetDht11(&d);
+    CHECK(d.Reads == 14 && d.NoResponse == 2 && d.Timeout == 2 && d.BitError == 2 && d.Checksum == 4,
+          "counters: reads %lu no response %lu timeout %lu bit %lu checksum %lu", (unsigned long)d.Reads,
+          (unsigned long)d.NoResponse, (unsigned long)d.Timeout, (unsigned long)d.BitError, (unsigned long)d.Checksum);
+    CHECK(Sensor_GetHead(SENSOR_CH_TEMP) - temp_head == 4 && d.Seq == 4, "only good reads are pushed");
+}
+
+/**
+ * @brief  读取DHT11缓存时被传感器线程抢占
+ * @details 副本先填满0xFF，第一个屏障处（复制之前）的副本与之相同，不当作刚复制的
+ */
+static void Test_Dht11Preempt(void)
+{
+    SensorDht11_t d;
+    uint32_t i, seq;
+
+    Script_Done = 1;
+    for (i = 0; i < ROUNDS / 10; i++) {
+        if (Rand() % 2) { // 读取之间也有更新
+            Now += DHT11_PERIOD_MS;
+            Sensor_Poll();
+        }
+        seq = Good_Reads;
+        memset(&d, 0xFF, sizeof(d));
+        Reader_Dht11Seen = d;
+        Reader_Dht11     = &d;
+        Sensor_GetDht11(&d);
+        Reader_Dht11 = 0;
+
+        CHECK(d.TempInt == Temp_Int_Of(d.Seq) && d.TempDeci == Temp_Deci_Of(d.Seq),
+              "torn DHT11 copy: seq %lu, %u.%u", (unsigned long)d.Seq, d.TempInt, d.TempDeci);
+        CHECK(d.Seq >= seq && d.Seq <= Good_Reads && d.Health == SENSOR_HEALTH_OK, "DHT11 seq %lu, %lu..%lu",
+              (unsigned long)d.Seq, (unsigned long)seq, (unsigned long)Good_Reads);
+        if (Test_Fails > 20) break;
+    }
+    printf("dht11: %lu reads, %lu preemptions, %lu torn copies, seq %lu\n", (unsigned long)(ROUNDS / 10),
+           (unsigned long)Dht11_Preempts, (unsigned long)Dht11_Torn, (unsigned long)Good_Reads);
+    CHECK(Dht11_Torn > ROUNDS / 100, "stress did not update the cache during a copy");
+    Expect_Dht11("after stress", SENSOR_HEALTH_OK, Good_Reads, 0, Now);
+}
+
+int main(void)
+{
+    uint32_t i;
+
+    Sensor_Init();
+
+    // 空、未满、刚满、回绕
+    Expect_Ring(SENSOR_CH_TEMP, "empty");
+    for (i = 0; i < 5; i++) Push(SENSOR_CH_TEMP);
+    Expect_Ring(SENSOR_CH_TEMP, "partial");
+    for (; i < SENSOR_RING_LEN - 1; i++) Push(SENSOR_CH_TEMP);
+    Expect_Ring(SENSOR_CH_TEMP, "one short of full");
+    Push(SENSOR_CH_TEMP);
+    Expect_Ring(SENSOR_CH_TEMP, "full");
+    CHECK(Sensor_GetSample(SENSOR_CH_TEMP, 0) == 0, "oldest slot is next to be written");
+    for (i = 0; i < 3 * SENSOR_RING_LEN + 5; i++) {
+        Push(SENSOR_CH_TEMP);
+        Expect_Ring(SENSOR_CH_TEMP, "wrapped");
+    }
+
+    // 过旧和尚未写入的序号，各通道互不影响
+    CHECK(Sensor_GetSample(SENSOR_CH_TEMP, 0) == 0 && Sensor_GetSample(SENSOR_CH_TEMP, 0xFFFFFFFF) == 0 &&
+              Sensor_GetSample(SENSOR_CH_TEMP, Sensor_GetHead(SENSOR_CH_TEMP)) == 0,
+          "stale or future seq");
+    Expect_Ring(SENSOR_CH_HUMI, "other channel still empty");
+
+    // 读取最新采样时被写入者抢占
+    Push(SENSOR_CH_PIR);
+    for (i = 0; i < ROUNDS; i++) {
+        if (Rand() % 2) Push(SENSOR_CH_PIR);
+        Read_Latest();
+    }
+    printf("ring: %lu reads, %lu preemptions, %lu torn copies, head %lu\n", (unsigned long)ROUNDS,
+           (unsigned long)Preempts, (unsigned long)Torn_Copies, (unsigned long)Sensor_GetHead(SENSOR_CH_PIR));
+    CHECK(Torn_Copies > ROUNDS / 100, "stress did not overwrite copies in progress");
+    Expect_Ring(SENSOR_CH_PIR, "after stress");
+
+    Test_Dht11();
+    Test_Dht11Preempt();
+
+    return TEST_END("sensor");
+}
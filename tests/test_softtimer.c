@@ -0,0 +1,179 @@
+/**
+ * @file     test_softtimer.c
+ * @brief    软件定时器主机测试
+ * @details  Timer_GetMillis由桩函数代替，时钟从0xFFFFFFFF附近开始，各项检查都跨越32位回绕：
+ *          - 到期时刻相同的定时器按启动先后执行
+ *          - 回调中重新启动、停止自己或其他定时器
+ *          - 周期定时落后多个周期时只执行一次，跳过错过的周期并保持原有相位
+ *          - SoftTimer_GetIdleTime在无定时器、未到期、已到期时的返回值
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include <string.h>
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_test.h"
+
+#define START 0xFFFFFFF0u /**< 初始时刻，16ms后回绕 */
+
+static uint32_t Now = START; /**< 模拟毫秒时钟 */
+
+uint32_t Timer_GetMillis(void) { return Now; }
+
+/* ---------------- 回调记录 ---------------- */
+
+static SoftTimer_t A, B, C, D; /**< 被测定时器 */
+static char Log[64];           /**< 回调执行顺序 */
+static uint32_t Log_Time[64];  /**< 回调执行时刻 */
+static int Log_Len;
+
+static void Record(char Name)
+{
+    Log_Time[Log_Len] = Now;
+    Log[Log_Len++]    = Name;
+    Log[Log_Len]      = 0;
+}
+
+static void Clear(void)
+{
+    SoftTimer_Stop(&A);
+    SoftTimer_Stop(&B);
+    SoftTimer_Stop(&C);
+    SoftTimer_Stop(&D);
+    Log_Len = 0;
+    Log[0]  = 0;
+}
+
+static void On_A(void) { Record('A'); }
+static void On_B(void) { Record('B'); }
+static void On_C(void) { Record('C'); }
+static void On_D(void) { Record('D'); }
+
+/** @brief 重新启动自己：5ms后单次 */
+static void On_Rearm(void)
+{
+    Record('R');
+    if (Log_Len < 3) SoftTimer_Start(&A, 5, 0, On_Rearm);
+}
+
+/** @brief 停止自己（周期定时器） */
+static void On_StopSelf(void)
+{
+    Record('S');
+    SoftTimer_Stop(&A);
+}
+
+/** @brief 停止同一时刻到期的B，启动立即到期的C */
+static void On_Juggle(void)
+{
+    Record('J');
+    SoftTimer_Stop(&B);
+    SoftTimer_Start(&C, 0, 0, On_C);
+}
+
+/** @brief 推进到指定时刻并处理到期的定时器 */
+static void Run_At(uint32_t Time)
+{
+    Now = Time;
+    SoftTimer_Run();
+}
+
+int main(void)
+{
+    // 没有定时器
+    CHECK(SoftTimer_GetIdleTime() == 0xFFFFFFFF, "idle time with no timers");
+    SoftTimer_Run();
+    CHECK(Log_Len == 0, "callback with no timers");
+
+    // 到期时刻相同：按启动先后；跨越回绕的时刻排在回绕前的时刻之后
+    Now = START;
+    SoftTimer_Start(&A, 20, 0, On_A); // START+20，回绕后为4
+    SoftTimer_Start(&B, 5, 0, On_B);
+    Now = START + 5;
+    SoftTimer_Start(&C, 15, 0, On_C); // 与A相同
+    SoftTimer_Start(&D, 15, 0, On_D); // 与A、C相同
+    CHECK(SoftTimer_GetIdleTime() == 0, "B due now: idle %lu", (unsigned long)SoftTimer_GetIdleTime());
+    Run_At(START + 5);
+    CHECK(strcmp(Log, "B") == 0 && !SoftTimer_IsActive(&B), "one-shot B: %s", Log);
+    CHECK(SoftTimer_GetIdleTime() == 15, "idle %lu, expected 15", (unsigned long)SoftTimer_GetIdleTime());
+    Run_At(START + 19);
+    CHECK(strcmp(Log, "B") == 0, "fired early: %s", Log);
+    CHECK(SoftTimer_GetIdleTime() == 1, "idle %lu across wrap, expected 1", (unsigned long)SoftTimer_GetIdleTime());
+    Run_At(START + 30); // 已过期10ms
+    CHECK(strcmp(Log, "BACD") == 0, "equal expiry order: %s, expected BACD", Log);
+    CHECK(SoftTimer_GetIdleTime() == 0xFFFFFFFF, "idle time after all one-shots");
+    Clear();
+
+    // 重新启动同时刻到期的定时器排到最后
+    Now = START;
+    SoftTimer_Start(&A, 10, 0, On_A);
+    SoftTimer_Start(&B, 10, 0, On_B);
+    SoftTimer_Start(&C, 10, 0, On_C);
+    SoftTimer_Start(&A, 10, 0, On_A);
+    Run_At(START + 10);
+    CHECK(strcmp(Log, "BCA") == 0, "restart order: %s, expected BCA", Log);
+    Clear();
+
+    // 回调中重新启动自己
+    Now = START;
+    SoftTimer_Start(&A, 8, 0, On_Rearm);
+    Run_At(START + 8);
+    CHECK(strcmp(Log, "R") == 0 && SoftTimer_IsActive(&A), "re-arm: %s", Log);
+    CHECK(SoftTimer_GetIdleTime() == 5, "re-armed idle %lu", (unsigned long)SoftTimer_GetIdleTime());
+    Run_At(START + 13);
+    Run_At(START + 18);
+    Run_At(START + 40);
+    CHECK(strcmp(Log, "RRR") == 0 && Log_Time[1] == START + 13 && Log_Time[2] == START + 18 &&
+              !SoftTimer_IsActive(&A),
+          "re-arm sequence: %s", Log);
+    Clear();
+
+    // 周期定时器在回调中停止自己，不再执行
+    Now = START;
+    SoftTimer_Start(&A, 4, 4, On_StopSelf);
+    Run_At(START + 4);
+    Run_At(START + 8);
+    CHECK(strcmp(Log, "S") == 0 && !SoftTimer_IsActive(&A), "periodic stop in callback: %s", Log);
+    Clear();
+
+    // 回调中停止同时刻到期的B，启动立即到期的C，C在同一次处理中执行
+    Now = START;
+    SoftTimer_Start(&A, 16, 0, On_Juggle);
+    SoftTimer_Start(&B, 16, 0, On_B);
+    SoftTimer_Start(&D, 17, 0, On_D);
+    Run_At(START + 16);
+    CHECK(strcmp(Log, "JC") == 0 && !SoftTimer_IsActive(&B) && SoftTimer_IsActive(&D), "stop/start in callback: %s",
+          Log);
+    Run_At(START + 17);
+    CHECK(strcmp(Log, "JCD") == 0, "after juggle: %s", Log);
+    Clear();
+
+    // 周期定时跨越回绕，没有漂移
+    Now = START;
+    SoftTimer_Start(&A, 3, 10, On_A);
+    Run_At(START + 3);
+    Run_At(START + 14); // 晚1ms
+    Run_At(START + 23);
+    CHECK(strcmp(Log, "AAA") == 0 && A.Expire == START + 33, "periodic: %s, next %lu", Log,
+          (unsigned long)(A.Expire - START));
+
+    // 落后3.5个周期：只执行一次，下一次仍在原相位上
+    Run_At(START + 58);
+    CHECK(strcmp(Log, "AAAA") == 0, "missed periods ran %d times", Log_Len - 3);
+    CHECK(A.Expire == START + 63 && SoftTimer_GetIdleTime() == 5, "next expiry %lu, idle %lu, expected 63 and 5",
+          (unsigned long)(A.Expire - START), (unsigned long)SoftTimer_GetIdleTime());
+
+    // 恰好落后整数个周期：当前时刻已到达的周期也跳过
+    Run_At(START + 83);
+    CHECK(strcmp(Log, "AAAAA") == 0 && A.Expire == START + 93, "missed exact periods: next %lu",
+          (unsigned long)(A.Expire - START));
+
+    // 过期后未处理时空闲时间为0，不为负
+    Now = START + 100;
+    CHECK(SoftTimer_GetIdleTime() == 0, "overdue idle %lu", (unsigned long)SoftTimer_GetIdleTime());
+    Clear();
+
+    return TEST_END("softtimer");
+}
@@ -0,0 +1,221 @@
+/**
+ * @file     test_timer.c
+ * @brief    时间基准主机测试
+ * @details  TIM4由桩函数模拟：计数值取自模拟的微秒时钟，每次读取寄存器前后时钟前进几微秒，
+ *          溢出标志挂起且中断打开时随机插入TIM4_IRQHandler，相当于读取到一半被溢出中断打断：
+ *          - Timer_GetMillis、Timer_GetMillisFrac、Timer_GetMillis64、Timer_GetMicros64的结果
+ *            必须落在调用开始和返回时的真实时刻之间
+ *          - 关中断读取（溢出已挂起、中断未处理）、停止模式补偿（Timer_Advance）、
+ *            毫秒时间的32位回绕，以及回绕的溢出中断打断Timer_GetMillis64
+ * @author   DikiFive
+ * @date     2025-04-30
+ * @version  v1.0
+ */
+
+#include "stm32f10x.h"
+#include "dk_C8T6.h"
+#include "host_test.h"
+
+void TIM4_IRQHandler(void);
+
+#define ROUNDS 300000 /**< 每个阶段的读取次数 */
+
+static uint64_t Hw_Us;          /**< TIM4的真实计数（微秒），不含补偿 */
+static uint64_t Offset_Us;      /**< 已推进的补偿时间 */
+static uint64_t Serviced;       /**< 已由中断处理的溢出次数 */
+static uint8_t Irq_Off, In_Isr; /**< 中断关闭、正在执行中断 */
+static uint8_t Force_Isr;       /**< 溢出标志一挂起就进入中断 */
+static uint32_t Isr_Runs, Pending_Reads; /**< 溢出中断次数、读到挂起溢出标志的次数 */
+static uint32_t Rand_State = 1; /**< 伪随机数状态 */
+
+static uint32_t Rand(void)
+{
+    Rand_State = Rand_State * 1103515245u + 12345u;
+    return Rand_State >> 16;
+}
+
+/** @brief 溢出标志：计数已回绕而中断尚未清除 */
+static uint8_t Pending(void) { return (Hw_Us >> 16) > Serviced; }
+
+static void Isr(void)
+{
+    In_Isr = 1;
+    TIM4_IRQHandler();
+    In_Isr = 0;
+    Isr_Runs++;
+}
+
+/**
+ * @brief  时钟前进并可能进入中断
+ * @details 关中断期间不进入中断；标志挂起时不让第二次溢出发生（硬件上会丢失一次溢出），
+ *         此前先开中断并执行中断
+ */
+static void Tick(uint32_t Us)
+{
+    if (!In_Isr && Pending() && ((Hw_Us + Us) >> 16) > Serviced + 1) {
+        Irq_Off = 0;
+        Isr();
+    }
+    Hw_Us += Us;
+    if (!Irq_Off && !In_Isr && Pending() && (Force_Isr || Rand() % 3 == 0)) Isr();
+}
+
+/* ---------------- 桩函数 ---------------- */
+
+void RCC_APB1PeriphClockCmd(uint32_t RCC_APB1Periph, FunctionalState NewState) {}
+void TIM_InternalClockConfig(TIM_TypeDef *TIMx) {}
+void TIM_TimeBaseInit(TIM_TypeDef *TIMx, TIM_TimeBaseInitTypeDef *TIM_TimeBaseInitStruct) {}
+void TIM_ClearFlag(TIM_TypeDef *TIMx, uint16_t TIM_FLAG) {}
+void TIM_ITConfig(TIM_TypeDef *TIMx, uint16_t TIM_IT, FunctionalState NewState) {}
+void TIM_Cmd(TIM_TypeDef *TIMx, FunctionalState NewState) {}
+void TIM_SetCompare1(TIM_TypeDef *TIMx, uint16_t Compare1) {}
+void NVIC_PriorityGroupConfig(uint32_t NVIC_PriorityGroup) {}
+void NVIC_Init(NVIC_InitTypeDef *NVIC_InitStruct) {}
+uint32_t Os_EnterCritical(void) { return 0; }
+void Os_ExitCritical(uint32_t State) {}
+
+uint16_t TIM_GetCounter(TIM_TypeDef *TIMx)
+{
+    uint16_t cnt;
+
+    Tick(Rand() % 4);
+    cnt = (uint16_t)Hw_Us;
+    Tick(1 + Rand() % 4);
+    return cnt;
+}
+
+FlagStatus TIM_GetFlagStatus(TIM_TypeDef *TIMx, uint16_t TIM_FLAG)
+{
+    FlagStatus status = TIM_FLAG == TIM_FLAG_Update && Pending() ? SET : RESET;
+
+    if (status == SET) Pending_Reads++;
+    Tick(1 + Rand() % 4);
+    return status;
+}
+
+ITStatus TIM_GetITStatus(TIM_TypeDef *TIMx, uint16_t TIM_IT)
+{
+    return TIM_IT == TIM_IT_Update && Pending() ? SET : RESET;
+}
+
+void TIM_ClearITPendingBit(TIM_TypeDef *TIMx, uint16_t TIM_IT)
+{
+    if (TIM_IT == TIM_IT_Update) Serviced = Hw_Us >> 16;
+}
+
+/* ---------------- 检查 ---------------- */
+
+/** @brief 当前真实时刻 */
+static uint64_t True_Us(void) { return Hw_Us + Offset_Us; }
+
+/** @brief 32位毫秒时间按调用开始时刻补全高位，倒退的结果补全后会远大于调用结束时刻 */
+static uint64_t Extend(uint32_t Ms, uint64_t Before)
+{
+    return Before / 1000 + (uint32_t)(Ms - (uint32_t)(Before / 1000));
+}
+
+/**
+ * @brief  读取一次，结果必须落在调用开始和返回时的真实时刻之间
+ * @details 各次调用不重叠，因此结果也不会倒退
+ */
+static void Read_Once(void)
+{
+    uint64_t before = True_Us(), after, got;
+    uint16_t frac = 0;
+    uint32_t ms;
+    uint8_t in_us = 0;
+    const char *name;
+
+    switch (Rand() % 4) {
+        case 0:
+            name = "millis";
+            got  = Extend(Timer_GetMillis(), before);
+            break;
+        case 1:
+            name  = "millis+frac";
+            ms    = Timer_GetMillisFrac(&frac);
+            got   = Extend(ms, before) * 1000 + frac;
+            in_us = 1;
+            CHECK(frac < 1000, "frac %u", frac);
+            break;
+        case 2:
+            name = "millis64";
+            got  = Timer_GetMillis64();
+            break;
+        default:
+            name  = "micros64";
+            got   = Timer_GetMicros64();
+            in_us = 1;
+            break;
+    }
+    after = True_Us();
+
+    if (!in_us) {
+        before /= 1000;
+        after /= 1000;
+    }
+    CHECK(got >= before && got <= after, "%s: %llu, call spanned %llu..%llu", name, (unsigned long long)got,
+          (unsigned long long)before, (unsigned long long)after);
+}
+
+/**
+ * @brief  读取若干次，其间时钟前进，偶尔关中断读取或推进补偿时间
+ * @param  Advance 是否推进补偿时间
+ */
+static void Run(uint32_t Rounds, uint8_t Advance)
+{
+    uint32_t i, ms;
+
+    for (i = 0; i < Rounds && Test_Fails < 20; i++) {
+        Tick(Rand() % 2000);
+        if (!Irq_Off && Rand() % 500 == 0) Irq_Off = 1; // 关中断一段时间，溢出可能挂起未处理
+        if (Irq_Off && Rand() % 40 == 0) Irq_Off = 0;
+        if (Advance && Irq_Off && Rand() % 50 == 0) {   // 停止模式唤醒后关中断推进
+            ms = Rand() % 5000;
+            Timer_Advance(ms);
+            Offset_Us += (uint64_t)ms * 1000;
+        }
+        Read_Once();
+    }
+    Irq_Off = 0;
+}
+
+int main(void)
+{
+    uint64_t now;
+    uint32_t isr_runs;
+
+    // 从0开始，含关中断读取
+    Run(ROUNDS, 0);
+    CHECK(Pending_Reads > 100 && Isr_Runs > 1000, "pending reads %lu, interrupts %lu", (unsigned long)Pending_Reads,
+          (unsigned long)Isr_Runs);
+
+    // 补偿时间
+    Run(ROUNDS, 1);
+
+    // 毫秒时间的32位回绕：推进到回绕前约10s
+    now = True_Us() / 1000;
+    Timer_Advance((uint32_t)(0xFFFFFFFFULL - now % 0x100000000ULL - 10000));
+    Offset_Us += (0xFFFFFFFFULL - now % 0x100000000ULL - 10000) * 1000;
+    Run(ROUNDS, 0);
+    CHECK(True_Us() / 1000 > 0xFFFFFFFFULL && Timer_GetMillis64() > 0xFFFFFFFFULL && Timer_GetMillis() < 0x100000,
+          "did not cross the 32-bit millisecond wrap: %llu", (unsigned long long)Timer_GetMillis64());
+    Run(ROUNDS, 1);
+
+    // 使毫秒基准在下一次溢出时越过2^33，在其前1us读取64位毫秒时间，溢出中断插入读取中间
+    Hw_Us |= 0xFFFF;
+    now = (Hw_Us + 1 + Offset_Us) / 1000; // 下一次溢出时的毫秒时间
+    Timer_Advance((uint32_t)(0x200000000ULL + 10 - now));
+    Offset_Us += (0x200000000ULL + 10 - now) * 1000;
+    isr_runs  = Isr_Runs;
+    Force_Isr = 1;
+    now       = Timer_GetMillis64();
+    Force_Isr = 0;
+    CHECK(Isr_Runs == isr_runs + 1 && now >= 0x200000000ULL + 9 && now <= 0x200000000ULL + 10,
+          "wrap during a 64-bit read: %llu", (unsigned long long)now);
+    Run(ROUNDS / 10, 0);
+
+    printf("timer: %lu overflow interrupts, %lu pending-flag reads, %llu ms\n", (unsigned long)Isr_Runs,
+           (unsigned long)Pending_Reads, (unsigned long long)(True_Us() / 1000));
+    return TEST_END("timer");
+}